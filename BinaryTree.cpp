@@ -1,9 +1,25 @@
+#ifndef BINARYTREE_CPP
+#define BINARYTREE_CPP
+
 #include <iostream>
 #include <queue>
 #include <stack>
 #include <chrono>
 #include <algorithm>
 #include <vector>
+#include <new>
+#include <thread>
+#include <atomic>
+#include <type_traits>
+#include <limits>
+#include <cstring>
+#include <unordered_map>
+#include <mutex>
+#include <memory>
+#include "benchclock.h"
+#include "csvtreeloader.h"
+#include "treereclaimer.h"
+#include "enginecalibration.h"
 
 /*
 * 遍历类型：
@@ -22,21 +38,121 @@ enum TraversalClass {
 // 统计信息结构体
 struct TraversalStats {
     double time_ms = 0.0;        // 遍历时间(毫秒)
+    double time_ns = 0.0;        // 遍历时间(纳秒)
+    size_t node_count = 0;       // 访问的节点数
+    double ns_per_node = 0.0;    // 每节点耗时(纳秒)
+    double nodes_per_sec = 0.0;  // 吞吐量(节点/秒)
     size_t memory_usage = 0;     // 内存使用情况(字节)
     size_t max_queue_length = 0; // 层序遍历最长队列长度
     size_t max_stack_depth = 0;  // 非递归遍历最大栈深度
+    size_t page_faults = 0;      // 分页存储的缺页次数
+    double cache_hit_ratio = 0.0; // 分页存储的页缓存命中率
+    TraversalEngine engine = ENGINE_AUTO; // 实际使用的遍历引擎（未记录时为 AUTO）
+
+    // 由总耗时和节点数计算其余时间字段
+    void setTiming(double ns, size_t nodes) {
+        time_ns = ns;
+        time_ms = ns / 1e6;
+        node_count = nodes;
+        ns_per_node = nodes ? ns / nodes : 0.0;
+        nodes_per_sec = ns > 0.0 ? nodes * 1e9 / ns : 0.0;
+    }
 
     void print() const {
         std::cout << "遍历时间: " << time_ms << " ms" << std::endl;
+        std::cout << "每节点: " << ns_per_node << " ns, 吞吐: " << nodes_per_sec << " 节点/秒" << std::endl;
         std::cout << "内存使用: " << memory_usage << " bytes" << std::endl;
         std::cout << "最长队列长度: " << max_queue_length << std::endl;
         std::cout << "最大栈深度: " << max_stack_depth << std::endl;
+        if (page_faults) {
+            std::cout << "缺页: " << page_faults << ", 命中率: " << cache_hit_ratio << std::endl;
+        }
     }
 };
 
+// 并行建树的统计
+struct TreeBuildStats {
+    double ms = 0.0;        // 建树耗时(毫秒)
+    size_t nodes = 0;       // 节点数
+    unsigned threads = 1;   // 使用的线程数
+
+    double nodesPerSec() const { return ms > 0.0 ? nodes * 1e3 / ms : 0.0; }
+};
+
+// 批量访问时交给访问函数的一段连续元素（节点指针或节点数据），只在本次调用内有效
+template<typename E>
+struct VisitSpan {
+    const E* data;
+    size_t size;
+
+    const E* begin() const { return data; }
+    const E* end() const { return data + size; }
+    const E& operator[](size_t i) const { return data[i]; }
+};
+
+// 默认批大小：int 数据 1KB，节点指针 2KB，都能留在 L1 里
+static const size_t kDefaultBatchSize = 256;
+
+// 把逐个到达的元素攒成固定大小的批次再交给 visit；遍历结束后调用 flush 交出最后不满的一批
+template<typename E, typename BatchVisitor>
+class BatchCollector {
+public:
+    BatchCollector(size_t batchSize, BatchVisitor& visitor)
+        : capacity(std::max<size_t>(1, batchSize)), visit(visitor) {
+        buffer.reserve(capacity);
+    }
+
+    void push(const E& element) {
+        buffer.push_back(element);
+        if (buffer.size() == capacity) flush();
+    }
+
+    void flush() {
+        if (buffer.empty()) return;
+        visit(VisitSpan<E>{buffer.data(), buffer.size()});
+        buffer.clear();
+        batches++;
+    }
+
+    size_t batchCount() const { return batches; }
+    size_t memoryBytes() const { return capacity * sizeof(E); }
+
+private:
+    size_t capacity;
+    BatchVisitor& visit;
+    std::vector<E> buffer;
+    size_t batches = 0;
+};
+
+/*
+* 父指针策略：
+* NoParentLink 不存父指针，基类为空，节点大小不变（默认）
+* ParentLink   每个节点多一个父指针，遍历可以不用栈
+*/
+struct NoParentLink {
+    static const bool enabled = false;
+
+    template<typename Node>
+    struct Slot {
+        Node* getParent() const { return nullptr; }
+        void setParent(Node*) {}
+    };
+};
+
+struct ParentLink {
+    static const bool enabled = true;
+
+    template<typename Node>
+    struct Slot {
+        Node* parent = nullptr;
+        Node* getParent() const { return parent; }
+        void setParent(Node* p) { parent = p; }
+    };
+};
+
 // 二叉树节点
-template<typename T>
-struct TreeNode {
+template<typename T, typename LinkPolicy = NoParentLink>
+struct TreeNode : LinkPolicy::template Slot<TreeNode<T, LinkPolicy>> {
     T data;
     TreeNode* left;
     TreeNode* right;
@@ -44,22 +160,343 @@ struct TreeNode {
     TreeNode(T val) : data(val), left(nullptr), right(nullptr) {}
 };
 
-// 二叉树类
+/*
+* 父指针游标：只保存当前节点和遍历顺序，可以随意复制，也可以中途保存、稍后继续
+* 只支持先序、中序、后序；层序需要队列，无法只靠当前节点前进，begin 对层序返回无效游标
+*/
 template<typename T>
+class TreeCursor {
+public:
+    typedef TreeNode<T, ParentLink> Node;
+
+    TreeCursor() : node(nullptr), order(PRE) {}
+    TreeCursor(const Node* current, TraversalClass traversal_class) : node(current), order(traversal_class) {}
+
+    // 指向 root 按 traversal_class 遍历的第一个节点；层序时返回无效游标（valid() 为 false）
+    static TreeCursor begin(const Node* root, TraversalClass traversal_class) {
+        if (!root) return TreeCursor(nullptr, traversal_class);
+        switch (traversal_class) {
+        case PRE:
+            return TreeCursor(root, PRE);
+        case IN:
+            return TreeCursor(leftmost(root), IN);
+        case POST:
+            return TreeCursor(firstPostorder(root), POST);
+        default:
+            return TreeCursor(nullptr, traversal_class);
+        }
+    }
+
+    const Node* get() const { return node; }
+    bool valid() const { return node != nullptr; }
+    TraversalClass traversal() const { return order; }
+
+    bool operator==(const TreeCursor& other) const { return node == other.node && order == other.order; }
+    bool operator!=(const TreeCursor& other) const { return !(*this == other); }
+
+    // 前进到下一个节点，遍历结束后 get() 为空
+    void next() {
+        switch (order) {
+        case PRE:
+            node = preorderNext(node);
+            break;
+        case IN:
+            node = inorderNext(node);
+            break;
+        case POST:
+            node = postorderNext(node);
+            break;
+        case LEVEL:
+            node = nullptr;   // 不支持层序，见 begin
+            break;
+        }
+    }
+
+private:
+    const Node* node;
+    TraversalClass order;
+
+    static const Node* leftmost(const Node* n) {
+        while (n->left) n = n->left;
+        return n;
+    }
+
+    // 后序的第一个节点：一路向下，能往左就往左，否则往右
+    static const Node* firstPostorder(const Node* n) {
+        while (n->left || n->right) n = n->left ? n->left : n->right;
+        return n;
+    }
+
+    // 没有孩子时沿父指针上溯，找到第一个“从左边上来且有右孩子”的祖先
+    static const Node* preorderNext(const Node* n) {
+        if (n->left) return n->left;
+        if (n->right) return n->right;
+        const Node* parent = n->getParent();
+        while (parent) {
+            if (parent->left == n && parent->right) return parent->right;
+            n = parent;
+            parent = n->getParent();
+        }
+        return nullptr;
+    }
+
+    static const Node* inorderNext(const Node* n) {
+        if (n->right) return leftmost(n->right);
+        const Node* parent = n->getParent();
+        while (parent && parent->right == n) {
+            n = parent;
+            parent = n->getParent();
+        }
+        return parent;
+    }
+
+    static const Node* postorderNext(const Node* n) {
+        const Node* parent = n->getParent();
+        if (!parent) return nullptr;
+        if (parent->left == n && parent->right) return firstPostorder(parent->right);
+        return parent;
+    }
+};
+
+// 二叉树类，LinkPolicy 为 ParentLink 时节点带父指针，非递归遍历改用只保存一个节点的游标
+template<typename T, typename LinkPolicy = NoParentLink>
 class BinaryTree {
+public:
+    typedef TreeNode<T, LinkPolicy> Node;
+
 private:
-    TreeNode<T>* root;
+    Node* root;
+    Node* arena;            // 并行建树时一次性分配的节点区；非空时整棵树都在其中
+    size_t arenaCount;
+    TreeStorage storage = STORAGE_HEAP;   // 节点区的存放顺序，决定能否用下标扫描遍历
+    TreeReclaimStats lastReclaimStats;
+
+    int hybridCutoff = kDefaultHybridThreshold;   // 混合引擎的切换阈值（剩余高度）
+
+    static const size_t kArenaAlignment = 64;
+
+    // 释放整棵树，返回释放的节点数：节点区整体释放，否则逐个 delete
+    size_t releaseNodes(unsigned threads = 1) {
+        size_t count;
+        if (arena) {
+            count = arenaCount;
+            freeArena(arena, arenaCount);
+            arena = nullptr;
+            arenaCount = 0;
+        } else {
+            count = threads > 1 ? clearTreeParallel(root, threads) : clearTree(root);
+        }
+        root = nullptr;
+        storage = STORAGE_HEAP;
+        return count;
+    }
+
+    static void freeArena(Node* nodes, size_t count) {
+        if (!std::is_trivially_destructible<Node>::value) {
+            for (size_t i = 0; i < count; i++) nodes[i].~Node();
+        }
+        ::operator delete(nodes, std::align_val_t(kArenaAlignment));
+    }
+
+    static Node* allocateNodes(size_t n) {
+        return static_cast<Node*>(::operator new(n * sizeof(Node), std::align_val_t(kArenaAlignment)));
+    }
+
+    Node* allocateArena(size_t n) {
+        arena = allocateNodes(n);
+        arenaCount = n;
+        return arena;
+    }
+
+    static unsigned resolveThreads(unsigned threads) {
+        if (threads == 0) threads = std::thread::hardware_concurrency();
+        return std::max(1u, threads);
+    }
+
+    // 把 count 个下标按线程数切成连续的几段并行执行 fn(b, e)
+    template<typename Fn>
+    static void parallelRanges(size_t count, unsigned threads, Fn fn) {
+        size_t step = (count + threads - 1) / threads;
+        std::vector<std::thread> workers;
+        for (unsigned t = 1; t < threads; t++) {
+            size_t b = std::min(count, t * step);
+            size_t e = std::min(count, b + step);
+            if (b < e) workers.emplace_back(fn, b, e);
+        }
+        fn(size_t(0), std::min(count, step));
+        for (std::thread& w : workers) w.join();
+    }
+
+    // 指针从 from 节点区平移到 to 节点区
+    static Node* relocate(const Node* p, const Node* from, Node* to) {
+        return p ? to + (p - from) : nullptr;
+    }
+
+    void cloneArena(const BinaryTree& source, unsigned threads) {
+        const Node* from = source.arena;
+        Node* to = allocateArena(source.arenaCount);
+        parallelRanges(arenaCount, threads, [from, to](size_t b, size_t e) {
+            if (std::is_trivially_copyable<Node>::value) {
+                std::memcpy(static_cast<void*>(to + b), from + b, (e - b) * sizeof(Node));
+            } else {
+                for (size_t i = b; i < e; i++) new (to + i) Node(from[i].data);
+            }
+            for (size_t i = b; i < e; i++) {
+                to[i].left = relocate(from[i].left, from, to);
+                to[i].right = relocate(from[i].right, from, to);
+                to[i].setParent(relocate(from[i].getParent(), from, to));
+            }
+        });
+        root = relocate(source.root, from, to);
+        storage = source.storage;
+    }
+
+    // 按先序把 source 子树复制到 nodes[base...]，返回新子树的根（父指针留空）
+    static Node* copySubtree(const Node* source, Node* nodes, size_t base) {
+        struct Pending {
+            const Node* src;
+            Node* parent;
+            bool isRight;
+        };
+        Node* first = nodes + base;
+        std::vector<Pending> stack{{source, nullptr, false}};
+        while (!stack.empty()) {
+            Pending current = stack.back();
+            stack.pop_back();
+            Node* dst = new (nodes + base++) Node(current.src->data);
+            if (current.parent) {
+                (current.isRight ? current.parent->right : current.parent->left) = dst;
+                dst->setParent(current.parent);
+            }
+            if (current.src->right) stack.push_back({current.src->right, dst, true});
+            if (current.src->left) stack.push_back({current.src->left, dst, false});
+        }
+        return first;
+    }
+
+    void cloneNodes(const Node* sourceRoot, unsigned threads) {
+        // 拆出上层节点与互不相交的子树（与 clearTreeParallel 相同的拆法）
+        std::vector<const Node*> upper;
+        std::vector<const Node*> frontier{sourceRoot};
+        std::vector<const Node*> next;
+        while (threads > 1 && !frontier.empty() && frontier.size() < threads * 4) {
+            next.clear();
+            for (const Node* node : frontier) {
+                upper.push_back(node);
+                if (node->left) next.push_back(node->left);
+                if (node->right) next.push_back(node->right);
+            }
+            frontier.swap(next);
+        }
+
+        // 各子树大小 -> 在新节点区中的起点；上层节点放在最前面
+        std::vector<size_t> offsets(frontier.size() + 1, 0);
+        std::atomic<size_t> nextTask(0);
+        auto countWork = [&]() {
+            std::vector<const Node*> stack;
+            for (size_t t = nextTask++; t < frontier.size(); t = nextTask++) {
+                size_t count = 0;
+                stack.assign(1, frontier[t]);
+                while (!stack.empty()) {
+                    const Node* node = stack.back();
+                    stack.pop_back();
+                    count++;
+                    if (node->left) stack.push_back(node->left);
+                    if (node->right) stack.push_back(node->right);
+                }
+                offsets[t + 1] = count;
+            }
+        };
+        runWorkers(threads, countWork);
+        offsets[0] = upper.size();
+        for (size_t t = 0; t < frontier.size(); t++) offsets[t + 1] += offsets[t];
+
+        Node* nodes = allocateArena(offsets.back());
+        std::vector<Node*> newRoots(frontier.size());
+        nextTask = 0;
+        auto copyWork = [&]() {
+            for (size_t t = nextTask++; t < frontier.size(); t = nextTask++) {
+                newRoots[t] = copySubtree(frontier[t], nodes, offsets[t]);
+            }
+        };
+        runWorkers(threads, copyWork);
+
+        // 上层节点：旧指针 -> 新指针，孩子要么是上层节点，要么是某棵子树的根
+        std::unordered_map<const Node*, Node*> mapped;
+        for (size_t i = 0; i < upper.size(); i++) mapped[upper[i]] = new (nodes + i) Node(upper[i]->data);
+        for (size_t t = 0; t < frontier.size(); t++) mapped[frontier[t]] = newRoots[t];
+        for (size_t i = 0; i < upper.size(); i++) {
+            Node* dst = nodes + i;
+            if (upper[i]->left) {
+                dst->left = mapped[upper[i]->left];
+                dst->left->setParent(dst);
+            }
+            if (upper[i]->right) {
+                dst->right = mapped[upper[i]->right];
+                dst->right->setParent(dst);
+            }
+        }
+        root = mapped[sourceRoot];
+    }
+
+    template<typename Fn>
+    static void runWorkers(unsigned threads, Fn& work) {
+        std::vector<std::thread> workers;
+        for (unsigned t = 1; t < threads; t++) workers.emplace_back([&work]() { work(); });
+        work();
+        for (std::thread& w : workers) w.join();
+    }
+
+    // 随机形状建树中的一棵子树：先序编号 [base, base + size)，父节点下标为 parent（-1 表示根）
+    struct SubtreeRange {
+        size_t base;
+        size_t size;
+        int64_t parent;
+    };
+
+    // 左子树大小只由 (seed, base) 决定，所以形状与线程数无关
+    static size_t randomLeftSize(uint64_t seed, size_t base, size_t size) {
+        uint64_t x = seed + (base + 1) * 0x9E3779B97F4A7C15ull;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        x ^= x >> 31;
+        return x % size;
+    }
+
+    // 构造 range 的根节点并返回两个孩子的范围（大小可能为 0）
+    void buildRandomNode(const SubtreeRange& range, uint64_t seed, SubtreeRange& left, SubtreeRange& right) {
+        size_t leftSize = randomLeftSize(seed, range.base, range.size);
+        size_t rightSize = range.size - 1 - leftSize;
+        Node* node = new (arena + range.base) Node(T(range.base));
+        node->left = leftSize ? arena + range.base + 1 : nullptr;
+        node->right = rightSize ? arena + range.base + 1 + leftSize : nullptr;
+        node->setParent(range.parent >= 0 ? arena + range.parent : nullptr);
+        left = {range.base + 1, leftSize, static_cast<int64_t>(range.base)};
+        right = {range.base + 1 + leftSize, rightSize, static_cast<int64_t>(range.base)};
+    }
+
+    void fillRandomSubtree(const SubtreeRange& range, uint64_t seed) {
+        std::vector<SubtreeRange> stack{range};
+        while (!stack.empty()) {
+            SubtreeRange current = stack.back();
+            stack.pop_back();
+            if (current.size == 0) continue;
+            SubtreeRange left, right;
+            buildRandomNode(current, seed, left, right);
+            stack.push_back(right);
+            stack.push_back(left);
+        }
+    }
 
     // 按完全二叉树索引方式构建二叉树
     void autoCreateTreeByIndex(int n, T defaultValue = T()) {
         // 清空当前树
-        clearTree(root);
-        root = nullptr;
+        releaseNodes();
 
         if (n <= 0) return;
 
         // 创建所有节点，存储到数组中
-        std::vector<TreeNode<T>*> nodes(n, nullptr);
+        std::vector<Node*> nodes(n, nullptr);
 
         // 创建所有节点
         for (int i = 0; i < n; i++) {
@@ -71,7 +508,7 @@ private:
             } else {
                 value = defaultValue;
             }
-            nodes[i] = new TreeNode<T>(value);
+            nodes[i] = new Node(value);
         }
 
         // 建立节点间的连接关系（完全二叉树的特性）
@@ -81,9 +518,11 @@ private:
 
             if (leftChildIdx < n) {
                 nodes[i]->left = nodes[leftChildIdx];
+                nodes[leftChildIdx]->setParent(nodes[i]);
             }
             if (rightChildIdx < n) {
                 nodes[i]->right = nodes[rightChildIdx];
+                nodes[rightChildIdx]->setParent(nodes[i]);
             }
         }
 
@@ -91,37 +530,531 @@ private:
         root = nodes[0];
     }
 
+    // 逐层统计高度和节点数（不递归，不计入遍历时间）
+    void measureShape(int& height, size_t& count) const {
+        height = 0;
+        count = 0;
+        if (!root) return;
+
+        std::vector<const Node*> level{root};
+        std::vector<const Node*> next;
+        while (!level.empty()) {
+            height++;
+            count += level.size();
+            next.clear();
+            for (const Node* node : level) {
+                if (node->left) next.push_back(node->left);
+                if (node->right) next.push_back(node->right);
+            }
+            level.swap(next);
+        }
+    }
+
+    // 按孩子指针重建全部父指针（外部拼好的树交给 setRoot 时使用）；无父指针策略下为空操作
+    void linkParents() {
+        if constexpr (LinkPolicy::enabled) {
+            if (!root) return;
+            root->setParent(nullptr);
+            std::vector<Node*> stack{root};
+            while (!stack.empty()) {
+                Node* current = stack.back();
+                stack.pop_back();
+                if (current->left) {
+                    current->left->setParent(current);
+                    stack.push_back(current->left);
+                }
+                if (current->right) {
+                    current->right->setParent(current);
+                    stack.push_back(current->right);
+                }
+            }
+        }
+    }
+
+    // 父指针游标遍历：不用栈，每步只保存当前节点
+    void cursorTraversal(TraversalClass traversal_class, void (*visit)(Node*)) {
+        for (TreeCursor<T> cursor = TreeCursor<T>::begin(root, traversal_class); cursor.valid(); cursor.next()) {
+            visit(const_cast<Node*>(cursor.get()));
+        }
+    }
+
+    /*
+    * Morris 遍历（先序/中序）：借用左子树最右节点空着的右指针临时指回当前节点，回到当前节点时再还原
+    * 不用栈也不需要父指针；遍历期间树被临时改写，visit 不能依赖右指针，也不能与其它遍历并发
+    */
+    void morrisTraversal(TraversalClass traversal_class, void (*visit)(Node*)) {
+        Node* current = root;
+        while (current) {
+            if (!current->left) {
+                visit(current);
+                current = current->right;
+                continue;
+            }
+            Node* predecessor = current->left;
+            while (predecessor->right && predecessor->right != current) predecessor = predecessor->right;
+            if (!predecessor->right) {
+                if (traversal_class == PRE) visit(current);
+                predecessor->right = current;   // 临时线索
+                current = current->left;
+            } else {
+                predecessor->right = nullptr;   // 左子树已走完，还原
+                if (traversal_class == IN) visit(current);
+                current = current->right;
+            }
+        }
+    }
+
+    // 展开一层的递归：一次调用处理节点和它的两个孩子，空孩子不产生调用，递归深度约为子树高度的一半
+    static void preorderUnrolled(Node* node, void (*visit)(Node*)) {
+        visit(node);
+        if (Node* left = node->left) {
+            visit(left);
+            if (left->left) preorderUnrolled(left->left, visit);
+            if (left->right) preorderUnrolled(left->right, visit);
+        }
+        if (Node* right = node->right) {
+            visit(right);
+            if (right->left) preorderUnrolled(right->left, visit);
+            if (right->right) preorderUnrolled(right->right, visit);
+        }
+    }
+
+    static void inorderUnrolled(Node* node, void (*visit)(Node*)) {
+        if (Node* left = node->left) {
+            if (left->left) inorderUnrolled(left->left, visit);
+            visit(left);
+            if (left->right) inorderUnrolled(left->right, visit);
+        }
+        visit(node);
+        if (Node* right = node->right) {
+            if (right->left) inorderUnrolled(right->left, visit);
+            visit(right);
+            if (right->right) inorderUnrolled(right->right, visit);
+        }
+    }
+
+    static void postorderUnrolled(Node* node, void (*visit)(Node*)) {
+        if (Node* left = node->left) {
+            if (left->left) postorderUnrolled(left->left, visit);
+            if (left->right) postorderUnrolled(left->right, visit);
+            visit(left);
+        }
+        if (Node* right = node->right) {
+            if (right->left) postorderUnrolled(right->left, visit);
+            if (right->right) postorderUnrolled(right->right, visit);
+            visit(right);
+        }
+        visit(node);
+    }
+
+    /*
+    * 混合遍历（先序/中序/后序）：剩余高度（树高减深度）大于 threshold 的上层节点用显式栈展开，
+    * 其余子树整棵交给展开的递归，递归深度不超过 threshold / 2 + 1。
+    * threshold 为 0 时全程用栈，不小于树高时全程递归。返回显式栈的最大长度
+    */
+    size_t hybridTraversal(TraversalClass traversal_class, int threshold, int height, void (*visit)(Node*)) {
+        if (!root) return 0;
+        void (*subtree)(Node*, void (*)(Node*)) =
+            traversal_class == PRE ? preorderUnrolled : traversal_class == IN ? inorderUnrolled : postorderUnrolled;
+
+        struct Frame {
+            Node* node;
+            int depth;
+            bool expanded;  // 孩子已入栈，再次弹出时访问（中序、后序）
+        };
+        std::vector<Frame> stack;
+        stack.push_back({root, 0, false});
+        size_t maxDepth = 1;
+
+        while (!stack.empty()) {
+            Frame frame = stack.back();
+            stack.pop_back();
+            Node* node = frame.node;
+            if (frame.expanded) {
+                visit(node);
+                continue;
+            }
+            if (height - frame.depth <= threshold) {
+                subtree(node, visit);
+                continue;
+            }
+
+            int child = frame.depth + 1;
+            if (traversal_class == PRE) visit(node);
+            if (traversal_class == POST) stack.push_back({node, frame.depth, true});
+            if (node->right) stack.push_back({node->right, child, false});
+            if (traversal_class == IN) stack.push_back({node, frame.depth, true});
+            if (node->left) stack.push_back({node->left, child, false});
+            maxDepth = std::max(maxDepth, stack.size());
+        }
+        return maxDepth;
+    }
+
+    // 节点区的存放顺序与遍历顺序一致：按下标顺序扫描
+    void implicitTraversal(void (*visit)(Node*)) {
+        for (size_t i = 0; i < arenaCount; i++) visit(arena + i);
+    }
+
+    // 引擎能否用于高为 height 的这棵树的这种遍历顺序
+    bool engineApplicable(TraversalEngine engine, TraversalClass traversal_class, int height) const {
+        switch (engine) {
+        case ENGINE_RECURSIVE:
+            return traversal_class != LEVEL && height <= kMaxRecursiveHeight;
+        case ENGINE_STACK:
+            return true;
+        case ENGINE_CURSOR:
+            return LinkPolicy::enabled && traversal_class != LEVEL;
+        case ENGINE_MORRIS:
+            return traversal_class == PRE || traversal_class == IN;
+        case ENGINE_HYBRID:
+            return traversal_class != LEVEL;
+        case ENGINE_IMPLICIT:
+            return arena && root == arena
+                   && ((traversal_class == LEVEL && storage == STORAGE_LEVEL_ARENA)
+                       || (traversal_class == PRE && storage == STORAGE_PREORDER_ARENA));
+        default:
+            return false;
+        }
+    }
+
+    EngineKey engineKey(TraversalClass traversal_class, int height, size_t count) const {
+        EngineKey key;
+        key.kind = traversal_class;
+        key.storage = storage;
+        key.linked = LinkPolicy::enabled;
+        key.sizeBucket = EngineKey::bucketOf(count);
+        key.depthClass = EngineKey::classifyDepth(height, count);
+        return key;
+    }
+
+    TraversalEngine chooseEngine(TraversalClass traversal_class, int height, size_t count,
+                                 const EngineCalibration& table) const {
+        EngineChoice choice;
+        if (table.lookup(engineKey(traversal_class, height, count), choice)
+            && engineApplicable(choice.engine, traversal_class, height)) {
+            return choice.engine;
+        }
+        if (engineApplicable(ENGINE_IMPLICIT, traversal_class, height)) return ENGINE_IMPLICIT;
+        if (traversal_class == LEVEL) return ENGINE_STACK;
+        if (engineApplicable(ENGINE_RECURSIVE, traversal_class, height)) return ENGINE_RECURSIVE;
+        if (LinkPolicy::enabled) return ENGINE_CURSOR;
+        if (engineApplicable(ENGINE_MORRIS, traversal_class, height)) return ENGINE_MORRIS;
+        return ENGINE_HYBRID;
+    }
+
+    // 混合遍历的计时部分，height / count 为调用方刚统计的形状
+    TraversalStats hybridTimed(TraversalClass traversal_class, int threshold, int height, size_t count,
+                               void (*visit)(Node*)) {
+        TraversalStats stats;
+        const BenchClock& clock = BenchClock::instance();
+        uint64_t start = clock.now();
+        size_t maxDepth = hybridTraversal(traversal_class, threshold, height, visit);
+        uint64_t end = clock.now();
+
+        stats.setTiming(clock.elapsedNs(start, end), count);
+        stats.engine = ENGINE_HYBRID;
+        stats.max_stack_depth = maxDepth;
+        // 显式栈的帧加上递归部分最多 threshold / 2 + 1 层调用
+        stats.memory_usage = maxDepth * sizeof(Node*) * 2 + (std::min(threshold, height) / 2 + 1) * sizeof(Node*) * 2;
+        return stats;
+    }
+
     // 计算树的高度
-    int getHeight(TreeNode<T>* node) {
+    int getHeight(Node* node) {
         if (!node) return 0;
         return 1 + std::max(getHeight(node->left), getHeight(node->right));
     }
 
-    // 清空树
-    void clearTree(TreeNode<T>* node) {
-        if (!node) return;
-        clearTree(node->left);
-        clearTree(node->right);
-        delete node;
+    // 清空子树，返回释放的节点数
+    // 不递归也不用栈：有左孩子就右旋把左孩子提上来，没有左孩子时删除当前节点再处理右子树
+    static size_t clearTree(Node* node) {
+        size_t count = 0;
+        while (node) {
+            if (Node* left = node->left) {
+                node->left = left->right;
+                left->right = node;
+                node = left;
+            } else {
+                Node* right = node->right;
+                delete node;
+                node = right;
+                count++;
+            }
+        }
+        return count;
+    }
+
+    // 多线程清空：先按层拆出约 threads*4 棵互不相交的子树，各线程领取整棵子树释放，最后释放拆分用的上层节点
+    // 各线程同时 free 同一分配区的节点会争用分配器的锁，收益取决于分配器
+    static size_t clearTreeParallel(Node* root, unsigned threads) {
+        if (!root) return 0;
+        std::vector<Node*> upper;
+        std::vector<Node*> frontier{root};
+        std::vector<Node*> next;
+        while (!frontier.empty() && frontier.size() < threads * 4) {
+            next.clear();
+            for (Node* node : frontier) {
+                upper.push_back(node);
+                if (node->left) next.push_back(node->left);
+                if (node->right) next.push_back(node->right);
+            }
+            frontier.swap(next);
+        }
+
+        std::atomic<size_t> nextTask(0);
+        std::atomic<size_t> total(0);
+        auto work = [&]() {
+            size_t count = 0;
+            for (size_t t = nextTask++; t < frontier.size(); t = nextTask++) count += clearTree(frontier[t]);
+            total += count;
+        };
+        runWorkers(threads, work);
+
+        for (Node* node : upper) delete node;
+        return total + upper.size();
     }
 
 public:
     // 默认构造函数
-    BinaryTree() : root(nullptr) {}
+    BinaryTree() : root(nullptr), arena(nullptr), arenaCount(0) {}
+
+    // 不能隐式复制（会重复释放），需要副本时用 clone()
+    BinaryTree(const BinaryTree&) = delete;
+    BinaryTree& operator=(const BinaryTree&) = delete;
+
+    // 移动：接管节点（包括节点区）和遍历设置，原树变为空树
+    BinaryTree(BinaryTree&& other) noexcept
+        : root(other.root), arena(other.arena), arenaCount(other.arenaCount), storage(other.storage),
+          lastReclaimStats(other.lastReclaimStats), hybridCutoff(other.hybridCutoff) {
+        other.root = nullptr;
+        other.arena = nullptr;
+        other.arenaCount = 0;
+        other.storage = STORAGE_HEAP;
+    }
+
+    BinaryTree& operator=(BinaryTree&& other) noexcept {
+        if (this != &other) {
+            releaseNodes();
+            root = other.root;
+            arena = other.arena;
+            arenaCount = other.arenaCount;
+            storage = other.storage;
+            lastReclaimStats = other.lastReclaimStats;
+            hybridCutoff = other.hybridCutoff;
+            other.root = nullptr;
+            other.arena = nullptr;
+            other.arenaCount = 0;
+            other.storage = STORAGE_HEAP;
+        }
+        return *this;
+    }
 
-    // // 构造函数：从CSV文件加载树
-    // BinaryTree(const std::string& filename) : root(nullptr) {
-    //     loadFromCSV(filename);
-    // }
+    // 构造函数：从CSV文件加载树，失败时为空树
+    explicit BinaryTree(const std::string& filename) : root(nullptr), arena(nullptr), arenaCount(0) {
+        loadFromCSV(filename);
+    }
 
     // 析构函数
     ~BinaryTree() {
-        clearTree(root);
+        releaseNodes();
+    }
+
+    /*
+    * 清空整棵树并计时；threads > 1 时多线程释放（0 表示全部硬件线程）
+    * 并行建树得到的节点区一次整体释放，与线程数无关
+    */
+    TreeReclaimStats clear(unsigned threads = 1) {
+        const BenchClock& clock = BenchClock::instance();
+        threads = threads == 1 ? 1 : resolveThreads(threads);
+        uint64_t start = clock.now();
+        lastReclaimStats = TreeReclaimStats();
+        lastReclaimStats.threads = arena ? 1 : threads;
+        lastReclaimStats.nodes = releaseNodes(threads);
+        lastReclaimStats.ms = clock.elapsedNs(start, clock.now()) / 1e6;
+        return lastReclaimStats;
+    }
+
+    // 把节点交给后台回收线程后立即返回，树变为空树；回收耗时见 TreeReclaimer
+    void clearInBackground() {
+        lastReclaimStats = TreeReclaimStats();
+        lastReclaimStats.background = true;
+        if (!root) return;
+        Node* detachedRoot = root;
+        Node* detachedArena = arena;
+        size_t detachedCount = arenaCount;
+        root = nullptr;
+        arena = nullptr;
+        arenaCount = 0;
+        storage = STORAGE_HEAP;
+        TreeReclaimer::instance().submit([detachedRoot, detachedArena, detachedCount]() {
+            if (detachedArena) {
+                freeArena(detachedArena, detachedCount);
+                return detachedCount;
+            }
+            return clearTree(detachedRoot);
+        });
+    }
+
+    // 最近一次 clear / clearInBackground 的统计
+    const TreeReclaimStats& lastReclaim() const {
+        return lastReclaimStats;
+    }
+
+    // 获取根节点（只读）
+    const Node* getRoot() const {
+        return root;
+    }
+
+    // 统计节点总数
+    size_t countNodes() const {
+        if (!root) return 0;
+        size_t count = 0;
+        std::stack<const Node*> stack;
+        stack.push(root);
+        while (!stack.empty()) {
+            const Node* current = stack.top();
+            stack.pop();
+            count++;
+            if (current->right) stack.push(current->right);
+            if (current->left) stack.push(current->left);
+        }
+        return count;
+    }
+
+    // 节点区的存放方式；STORAGE_LEVEL_ARENA 时根就是节点区起点，层序第 i 个节点位于 getRoot() + i
+    TreeStorage storageKind() const {
+        return storage;
+    }
+
+    // 高度与节点数（逐层统计，O(n)）
+    void shape(int& height, size_t& count) const {
+        measureShape(height, count);
+    }
+
+    // 树的高度（逐层统计，退化成长链的树也不会栈溢出）
+    int height() const {
+        int h;
+        size_t count;
+        measureShape(h, count);
+        return h;
     }
 
-    TraversalStats Traversal(TraversalClass traversal_class, bool is_recursive, void (*visit)(TreeNode<T>*)) {
+    // 非递归遍历，visit 可以是任意可调用对象（如带状态的 lambda），接收 const Node*
+    // 不计时也不统计，用于序列化等需要上下文的场合
+    template<typename Visitor>
+    void forEach(TraversalClass traversal_class, Visitor&& visit) const {
+        if (!root) return;
+        std::vector<const Node*> stack;
+
+        switch (traversal_class) {
+        case PRE:
+            stack.push_back(root);
+            while (!stack.empty()) {
+                const Node* current = stack.back();
+                stack.pop_back();
+                visit(current);
+                if (current->right) stack.push_back(current->right);
+                if (current->left) stack.push_back(current->left);
+            }
+            break;
+        case IN: {
+            const Node* current = root;
+            while (current || !stack.empty()) {
+                while (current) {
+                    stack.push_back(current);
+                    current = current->left;
+                }
+                current = stack.back();
+                stack.pop_back();
+                visit(current);
+                current = current->right;
+            }
+            break;
+        }
+        case POST: {
+            const Node* current = root;
+            const Node* lastVisited = nullptr;
+            while (current || !stack.empty()) {
+                while (current) {
+                    stack.push_back(current);
+                    current = current->left;
+                }
+                const Node* top = stack.back();
+                if (top->right && top->right != lastVisited) {
+                    current = top->right;
+                } else {
+                    visit(top);
+                    lastVisited = top;
+                    stack.pop_back();
+                }
+            }
+            break;
+        }
+        case LEVEL: {
+            std::queue<const Node*> q;
+            q.push(root);
+            while (!q.empty()) {
+                const Node* current = q.front();
+                q.pop();
+                visit(current);
+                if (current->left) q.push(current->left);
+                if (current->right) q.push(current->right);
+            }
+            break;
+        }
+        }
+    }
+
+    /*
+    * 批量遍历：按遍历顺序把节点指针攒成 batchSize 个一批，visit 接收 VisitSpan<const Node*>
+    * 层序按整层交付（一层一次调用，与 batchSize 无关）
+    * 每批只调用一次 visit，访问函数可以在批内做循环展开、预取等
+    */
+    template<typename BatchVisitor>
+    TraversalStats BatchTraversal(TraversalClass traversal_class, size_t batchSize, BatchVisitor&& visit) const {
+        TraversalStats stats;
+        const BenchClock& clock = BenchClock::instance();
+        uint64_t start = clock.now();
+
+        if (traversal_class == LEVEL) {
+            std::vector<const Node*> level;
+            std::vector<const Node*> next;
+            if (root) level.push_back(root);
+            while (!level.empty()) {
+                stats.max_queue_length = std::max(stats.max_queue_length, level.size());
+                visit(VisitSpan<const Node*>{level.data(), level.size()});
+                next.clear();
+                for (const Node* node : level) {
+                    if (node->left) next.push_back(node->left);
+                    if (node->right) next.push_back(node->right);
+                }
+                level.swap(next);
+            }
+        } else {
+            BatchCollector<const Node*, BatchVisitor> collector(batchSize, visit);
+            forEach(traversal_class, [&collector](const Node* node) { collector.push(node); });
+            collector.flush();
+            stats.memory_usage = collector.memoryBytes();
+        }
+
+        uint64_t end = clock.now();
+        int height;
+        size_t count;
+        measureShape(height, count);
+        stats.setTiming(clock.elapsedNs(start, end), count);
+        if (traversal_class == LEVEL) {
+            stats.memory_usage = stats.max_queue_length * sizeof(Node*) * 2;
+        } else {
+            stats.max_stack_depth = height;
+            stats.memory_usage += height * sizeof(Node*);
+        }
+        return stats;
+    }
+
+    TraversalStats Traversal(TraversalClass traversal_class, bool is_recursive, void (*visit)(Node*)) {
         TraversalStats stats;   //状态记录
-        auto start = std::chrono::high_resolution_clock::now(); //开始计时
+        const BenchClock& clock = BenchClock::instance();
+        uint64_t start = clock.now(); //开始计时
 
         //是递归
         if (is_recursive) {
@@ -141,7 +1074,10 @@ public:
                 break;
             }
         }
-        //非递归
+        //非递归：有父指针时先序/中序/后序改用游标
+        else if (LinkPolicy::enabled && traversal_class != LEVEL) {
+            if constexpr (LinkPolicy::enabled) cursorTraversal(traversal_class, visit);
+        }
         else {
             switch (traversal_class) {
             case PRE:
@@ -159,33 +1095,149 @@ public:
             }
         }
 
-        auto end = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
-        stats.time_ms = duration.count() / 1000.0;
+        uint64_t end = clock.now();
+
+        int height;
+        size_t count;
+        measureShape(height, count);
+        stats.setTiming(clock.elapsedNs(start, end), count);
+
+        if (LinkPolicy::enabled && !is_recursive && traversal_class != LEVEL) {
+            // 游标不用栈，额外内存是每个节点的父指针
+            stats.memory_usage = count * sizeof(Node*);
+            stats.max_stack_depth = 0;
+            stats.engine = ENGINE_CURSOR;
+        } else {
+            stats.memory_usage = height * sizeof(Node*) * 2;
+            stats.max_stack_depth = height;
+            stats.engine = is_recursive && traversal_class != LEVEL ? ENGINE_RECURSIVE : ENGINE_STACK;
+        }
+
+        return stats;
+    }
+
+    /*
+    * 以下几个函数每次调用都重新统计树的形状（O(n)，不计入遍历时间），不缓存：
+    * 调用方可以经由访问函数拿到的 Node* 直接改动孩子指针，根不变时树也可能已经变高，
+    * 按旧高度选用递归会栈溢出
+    */
+
+    // 引擎能否用于这棵树的这种遍历顺序（递归还要求树高不超过 kMaxRecursiveHeight）
+    bool engineApplicable(TraversalEngine engine, TraversalClass traversal_class) const {
+        int height = 0;
+        size_t count;
+        if (engine == ENGINE_RECURSIVE) measureShape(height, count);
+        return engineApplicable(engine, traversal_class, height);
+    }
+
+    // 本树当前形状在校准表中对应的键
+    EngineKey engineKey(TraversalClass traversal_class) const {
+        int height;
+        size_t count;
+        measureShape(height, count);
+        return engineKey(traversal_class, height, count);
+    }
+
+    /*
+    * AUTO 模式选用的引擎：先查校准表，表中的引擎不适用（或没有这一项）时按经验规则：
+    * 存放顺序就是遍历顺序时下标扫描；树不太高时递归；太高时有父指针用游标，先序/中序用 Morris，后序用混合
+    */
+    TraversalEngine chooseEngine(TraversalClass traversal_class,
+                                 const EngineCalibration& table = EngineCalibration::instance()) const {
+        int height;
+        size_t count;
+        measureShape(height, count);
+        return chooseEngine(traversal_class, height, count, table);
+    }
+
+    // 混合引擎的切换阈值，限制在 [0, kMaxRecursiveHeight]
+    void setHybridThreshold(int threshold) {
+        hybridCutoff = std::max(0, std::min(threshold, kMaxRecursiveHeight));
+    }
+
+    int hybridThreshold() const {
+        return hybridCutoff;
+    }
+
+    // 以给定阈值做混合遍历（见 hybridTraversal）；层序没有混合版本，改用队列
+    TraversalStats HybridTraversal(TraversalClass traversal_class, int threshold, void (*visit)(Node*)) {
+        if (traversal_class == LEVEL) return Traversal(LEVEL, false, visit);
+        threshold = std::max(0, std::min(threshold, kMaxRecursiveHeight));
+        int height;
+        size_t count;
+        measureShape(height, count);
+        return hybridTimed(traversal_class, threshold, height, count, visit);
+    }
+
+    // 用指定引擎遍历；ENGINE_AUTO 时按 chooseEngine 选择，指定的引擎不适用时同样改由自动选择
+    // 实际使用的引擎记在返回的 stats.engine 中
+    TraversalStats Traversal(TraversalClass traversal_class, TraversalEngine engine, void (*visit)(Node*)) {
+        int height;
+        size_t count;
+        measureShape(height, count);
+        if (engine == ENGINE_AUTO || !engineApplicable(engine, traversal_class, height)) {
+            engine = chooseEngine(traversal_class, height, count, EngineCalibration::instance());
+        }
+        if (engine == ENGINE_HYBRID) return hybridTimed(traversal_class, hybridCutoff, height, count, visit);
 
-        stats.memory_usage = getHeight(root) * sizeof(TreeNode<T>*) * 2;
-        stats.max_stack_depth = getHeight(root);
+        TraversalStats stats;
+        const BenchClock& clock = BenchClock::instance();
+        uint64_t start = clock.now();
+
+        switch (engine) {
+        case ENGINE_RECURSIVE:
+            if (traversal_class == PRE) preorderRecursiveHelper(root, visit);
+            else if (traversal_class == IN) inorderRecursiveHelper(root, visit);
+            else postorderRecursiveHelper(root, visit);
+            break;
+        case ENGINE_CURSOR:
+            if constexpr (LinkPolicy::enabled) cursorTraversal(traversal_class, visit);
+            break;
+        case ENGINE_MORRIS:
+            morrisTraversal(traversal_class, visit);
+            break;
+        case ENGINE_IMPLICIT:
+            implicitTraversal(visit);
+            break;
+        default:
+            switch (traversal_class) {
+            case PRE: preorderNonRecursive(visit); break;
+            case IN: inorderNonRecursive(visit); break;
+            case POST: postorderNonRecursive(visit); break;
+            case LEVEL: levelorderNonRecursive(visit); break;
+            }
+            break;
+        }
 
+        uint64_t end = clock.now();
+        stats.setTiming(clock.elapsedNs(start, end), count);
+        stats.engine = engine;
+        if (engine == ENGINE_RECURSIVE || engine == ENGINE_STACK) {
+            stats.memory_usage = height * sizeof(Node*) * 2;
+            stats.max_stack_depth = height;
+        } else if (engine == ENGINE_CURSOR) {
+            stats.memory_usage = count * sizeof(Node*);
+        }
         return stats;
     }
 
     /*——————————————————————————————————*/
     // 递归辅助函数
-    void preorderRecursiveHelper(TreeNode<T>* node, void (*visit)(TreeNode<T>*)) {
+    void preorderRecursiveHelper(Node* node, void (*visit)(Node*)) {
         if (!node) return;
         visit(node);
         preorderRecursiveHelper(node->left, visit);
         preorderRecursiveHelper(node->right, visit);
     }
 
-    void inorderRecursiveHelper(TreeNode<T>* node, void (*visit)(TreeNode<T>*)) {
+    void inorderRecursiveHelper(Node* node, void (*visit)(Node*)) {
         if (!node) return;
         inorderRecursiveHelper(node->left, visit);
         visit(node);
         inorderRecursiveHelper(node->right, visit);
     }
 
-    void postorderRecursiveHelper(TreeNode<T>* node, void (*visit)(TreeNode<T>*)) {
+    void postorderRecursiveHelper(Node* node, void (*visit)(Node*)) {
         if (!node) return;
         postorderRecursiveHelper(node->left, visit);
         postorderRecursiveHelper(node->right, visit);
@@ -194,31 +1246,31 @@ public:
     /*——————————————————————————————————*/
 
     // 前序遍历（递归）
-    void preorderRecursive(void (*visit)(TreeNode<T>*)) {
+    void preorderRecursive(void (*visit)(Node*)) {
         /*——————*/
         preorderRecursiveHelper(root, visit);   //进行递归调用
         /*——————*/
     }
 
     // 中序遍历（递归）
-    void inorderRecursive(void (*visit)(TreeNode<T>*)) {
+    void inorderRecursive(void (*visit)(Node*)) {
         /*——————*/
         inorderRecursiveHelper(root, visit);
         /*——————*/
     }
 
     // 后序遍历（递归）
-    void postorderRecursive(void (*visit)(TreeNode<T>*)) {
+    void postorderRecursive(void (*visit)(Node*)) {
         /*——————*/
         postorderRecursiveHelper(root, visit);
         /*——————*/
     }
 
     // 前序非递归
-    void preorderNonRecursive(void (*visit)(TreeNode<T>*)) {
+    void preorderNonRecursive(void (*visit)(Node*)) {
         /*——————*/
-        std::stack<TreeNode<T>*> stack;
-        TreeNode<T>* current = root;
+        std::stack<Node*> stack;
+        Node* current = root;
         size_t maxDepth = 0;
 
         while (current || !stack.empty()) {
@@ -239,10 +1291,10 @@ public:
     }
 
     // 中序非递归
-    void inorderNonRecursive(void (*visit)(TreeNode<T>*)) {
+    void inorderNonRecursive(void (*visit)(Node*)) {
         /*——————*/
-        std::stack<TreeNode<T>*> stack;
-        TreeNode<T>* current = root;
+        std::stack<Node*> stack;
+        Node* current = root;
         size_t maxDepth = 0;
 
         while (current || !stack.empty()) {
@@ -263,11 +1315,11 @@ public:
     }
 
     // 后序非递归
-    void postorderNonRecursive(void (*visit)(TreeNode<T>*)) {
+    void postorderNonRecursive(void (*visit)(Node*)) {
         /*——————*/
-        std::stack<TreeNode<T>*> stack;
-        TreeNode<T>* current = root;
-        TreeNode<T>* lastVisited = nullptr;
+        std::stack<Node*> stack;
+        Node* current = root;
+        Node* lastVisited = nullptr;
         size_t maxDepth = 0;
 
         while (current || !stack.empty()) {
@@ -279,7 +1331,7 @@ public:
                 maxDepth = std::max(maxDepth, stack.size());
             }
 
-            TreeNode<T>* peekNode = stack.top();
+            Node* peekNode = stack.top();
 
             if (peekNode->right && lastVisited != peekNode->right) {
                 current = peekNode->right;
@@ -294,18 +1346,18 @@ public:
     }
 
     // 层序遍历
-    void levelorderNonRecursive(void (*visit)(TreeNode<T>*)) {
+    void levelorderNonRecursive(void (*visit)(Node*)) {
         /*——————*/
         if (!root) return;
 
-        std::queue<TreeNode<T>*> q;
+        std::queue<Node*> q;
         q.push(root);
         size_t maxQueueLength = 0;
 
         while (!q.empty()) {
             maxQueueLength = std::max(maxQueueLength, q.size());
 
-            TreeNode<T>* current = q.front();
+            Node* current = q.front();
             q.pop();
             visit(current);
 
@@ -319,55 +1371,379 @@ public:
     // 在BinaryTree类的public部分添加：
 
     // 设置根节点
-    void setRoot(TreeNode<T>* newRoot) {
+    void setRoot(Node* newRoot) {
         // 先清空旧树
-        clearTree(root);
+        releaseNodes();
         root = newRoot;
+        linkParents();
     }
 
     // 自动创建完全二叉树
     void autoCreateTree(int n) {
         // 先清空当前树
-        clearTree(root);
-        root = nullptr;
+        releaseNodes();
 
         if (n <= 0) return;
 
         // 创建根节点
-        root = new TreeNode<T>(T(0));
+        root = new Node(T(0));
 
         if (n == 1) return;
 
         // 使用队列来帮助按层创建节点
-        std::queue<TreeNode<T>*> nodeQueue;
+        std::queue<Node*> nodeQueue;
         nodeQueue.push(root);
 
         int createdCount = 1;
 
         while (!nodeQueue.empty() && createdCount < n) {
-            TreeNode<T>* parent = nodeQueue.front();
+            Node* parent = nodeQueue.front();
             nodeQueue.pop();
 
             // 创建左子节点
             if (createdCount < n) {
-                TreeNode<T>* leftChild = new TreeNode<T>(T(createdCount));
+                Node* leftChild = new Node(T(createdCount));
                 parent->left = leftChild;
+                leftChild->setParent(parent);
                 nodeQueue.push(leftChild);
                 createdCount++;
             }
 
             // 创建右子节点
             if (createdCount < n) {
-                TreeNode<T>* rightChild = new TreeNode<T>(T(createdCount));
+                Node* rightChild = new Node(T(createdCount));
                 parent->right = rightChild;
+                rightChild->setParent(parent);
                 nodeQueue.push(rightChild);
                 createdCount++;
             }
         }
     }
 
+    /*
+    * 并行建完全二叉树，形状和节点值与 autoCreateTree 相同
+    * 节点区一次性分配，按下标切成连续的几段，每个线程构造自己那段节点并填 2i+1 / 2i+2 链接：
+    * 孩子的地址由下标直接算出，线程之间不需要同步；每段内存由使用它的线程第一次写入
+    */
+    TreeBuildStats buildCompleteParallel(int n, unsigned threads = 0) {
+        const BenchClock& clock = BenchClock::instance();
+        uint64_t start = clock.now();
+        releaseNodes();
+
+        TreeBuildStats stats;
+        if (n <= 0) return stats;
+        size_t count = static_cast<size_t>(n);
+        threads = static_cast<unsigned>(std::min<size_t>(resolveThreads(threads), (count + 65535) / 65536));
+        threads = std::max(1u, threads);
+        Node* nodes = allocateArena(count);
+
+        parallelRanges(count, threads, [nodes, count](size_t b, size_t e) {
+            for (size_t i = b; i < e; i++) {
+                Node* node = new (nodes + i) Node(T(static_cast<int>(i)));
+                size_t l = 2 * i + 1;
+                if (l < count) node->left = nodes + l;
+                if (l + 1 < count) node->right = nodes + l + 1;
+                node->setParent(i ? nodes + (i - 1) / 2 : nullptr);
+            }
+        });
+        root = nodes;
+        storage = STORAGE_LEVEL_ARENA;
+
+        stats.ms = clock.elapsedNs(start, clock.now()) / 1e6;
+        stats.nodes = count;
+        stats.threads = threads;
+        return stats;
+    }
+
+    /*
+    * 并行建随机形状的树：子树大小为 s 时左子树大小在 [0, s-1] 中均匀选取（期望高度 O(log n)）
+    * 节点按先序存放在节点区里，每棵子树占一段连续下标，节点值为先序编号
+    * 主线程先拆出若干棵互不相交的子树，再由各线程领取整棵子树独立构造；同一 seed 的形状与线程数无关
+    */
+    TreeBuildStats buildRandomParallel(int n, uint64_t seed, unsigned threads = 0) {
+        const BenchClock& clock = BenchClock::instance();
+        uint64_t start = clock.now();
+        releaseNodes();
+
+        TreeBuildStats stats;
+        if (n <= 0) return stats;
+        size_t count = static_cast<size_t>(n);
+        threads = static_cast<unsigned>(std::min<size_t>(resolveThreads(threads), (count + 65535) / 65536));
+        threads = std::max(1u, threads);
+        allocateArena(count);
+
+        // 按层拆分，直到子树数量足够多（每线程约 8 棵）或都已很小
+        std::vector<SubtreeRange> tasks{{0, count, -1}};
+        std::vector<SubtreeRange> next;
+        const size_t wanted = threads > 1 ? threads * 8 : 1;
+        while (tasks.size() < wanted) {
+            next.clear();
+            bool split = false;
+            for (const SubtreeRange& range : tasks) {
+                if (range.size < 4096) {
+                    next.push_back(range);
+                    continue;
+                }
+                SubtreeRange left, right;
+                buildRandomNode(range, seed, left, right);
+                if (left.size) next.push_back(left);
+                if (right.size) next.push_back(right);
+                split = true;
+            }
+            tasks.swap(next);
+            if (!split) break;
+        }
+        // 大的子树先领，减少最后一个线程拖尾
+        std::sort(tasks.begin(), tasks.end(),
+                  [](const SubtreeRange& a, const SubtreeRange& b) { return a.size > b.size; });
+
+        std::atomic<size_t> nextTask(0);
+        auto work = [&]() {
+            for (size_t t = nextTask++; t < tasks.size(); t = nextTask++) fillRandomSubtree(tasks[t], seed);
+        };
+        runWorkers(threads, work);
+        root = arena;
+        storage = STORAGE_PREORDER_ARENA;
+
+        stats.ms = clock.elapsedNs(start, clock.now()) / 1e6;
+        stats.nodes = count;
+        stats.threads = threads;
+        return stats;
+    }
+
+    /*
+    * 多个生产者线程并发插入，得到一棵完全二叉树：
+    * 每次插入用原子计数器领取下一个层序位置 i，节点放在节点区第 i 格，父节点是第 (i-1)/2 格（与 autoCreateTreeByIndex 相同的下标规则）
+    * 父子两个节点谁后就位谁来连接这条边：每条边有一个到达计数，两端各加一次，看到 1 的一方连边，不需要全局锁
+    * 用法：auto inserter = tree.beginConcurrentInsert(capacity); 各线程调用 inserter.insert(v)；全部结束后 inserter.finish()
+    * finish 之前树保持为空，不能遍历
+    */
+    class ConcurrentInserter {
+    public:
+        ~ConcurrentInserter() {
+            finish();
+        }
+
+        ConcurrentInserter(const ConcurrentInserter&) = delete;
+        ConcurrentInserter& operator=(const ConcurrentInserter&) = delete;
+
+        // 无锁插入，容量用完时返回 false
+        bool insert(const T& value) {
+            size_t i = next.fetch_add(1, std::memory_order_relaxed);
+            if (i >= capacity) return false;
+            new (nodes + i) Node(value);
+            if (i > 0 && arrivals[i].fetch_add(1, std::memory_order_acq_rel) == 1) link(i);   // 父节点已先就位
+            for (size_t c = 2 * i + 1; c <= 2 * i + 2 && c < capacity; c++) {
+                if (arrivals[c].fetch_add(1, std::memory_order_acq_rel) == 1) link(c);      // 孩子已先就位
+            }
+            return true;
+        }
+
+        // 对照实现：整个插入在一把互斥锁内完成，父节点一定已经存在；不能与 insert 混用
+        bool insertLocked(const T& value) {
+            std::lock_guard<std::mutex> lock(mutex);
+            size_t i = next.load(std::memory_order_relaxed);
+            if (i >= capacity) return false;
+            next.store(i + 1, std::memory_order_relaxed);
+            new (nodes + i) Node(value);
+            if (i > 0) link(i);
+            return true;
+        }
+
+        // 所有生产者结束后调用：把节点区交给树，返回插入的节点数；可重复调用
+        size_t finish() {
+            if (!nodes) return tree.arenaCount;
+            size_t count = std::min(next.load(std::memory_order_acquire), capacity);
+            if (count == 0) {
+                freeArena(nodes, 0);
+            } else {
+                tree.arena = nodes;
+                tree.arenaCount = count;
+                tree.root = nodes;
+                tree.storage = STORAGE_LEVEL_ARENA;
+            }
+            nodes = nullptr;
+            arrivals.reset();
+            return count;
+        }
+
+    private:
+        friend class BinaryTree;
+
+        BinaryTree& tree;
+        Node* nodes;
+        size_t capacity;
+        std::atomic<size_t> next;
+        std::unique_ptr<std::atomic<uint8_t>[]> arrivals;   // 每个位置与父节点之间那条边的到达计数
+        std::mutex mutex;
+
+        ConcurrentInserter(BinaryTree& owner, size_t maxNodes)
+            : tree(owner), nodes(nullptr), capacity(maxNodes), next(0) {
+            tree.releaseNodes();
+            if (capacity == 0) return;
+            nodes = allocateNodes(capacity);
+            arrivals.reset(new std::atomic<uint8_t>[capacity]);
+            for (size_t i = 0; i < capacity; i++) arrivals[i].store(0, std::memory_order_relaxed);
+        }
+
+        // 两端都已构造好，连接第 c 格与它的父节点
+        void link(size_t c) {
+            Node* parent = nodes + (c - 1) / 2;
+            Node* child = nodes + c;
+            if (c & 1) {
+                parent->left = child;
+            } else {
+                parent->right = child;
+            }
+            child->setParent(parent);
+        }
+    };
+
+    // 清空当前树，预留 capacity 个节点的位置，开始并发插入
+    ConcurrentInserter beginConcurrentInsert(size_t capacity) {
+        return ConcurrentInserter(*this, capacity);
+    }
+
+    // 以 pattern 的形状为模板平铺生成 n 个节点的树
+    // 根处放一份模板；每份模板中叶子的左右空位按层次顺序各挂一份新模板，
+    // 节点数达到 n 时截断最后一份。节点值与 autoCreateTree 一致，按创建顺序编号
+    void autoCreateTreeFromPattern(const Node* pattern, int n) {
+        // 先清空当前树
+        releaseNodes();
+
+        if (n <= 0 || !pattern) return;
+
+        // 等待挂接模板的空位（指向某个节点 left/right 指针的地址）
+        std::queue<Node**> slots;
+        slots.push(&root);
+
+        int createdCount = 0;
+
+        while (!slots.empty() && createdCount < n) {
+            Node** slot = slots.front();
+            slots.pop();
+
+            // 按层次复制一份模板
+            std::queue<std::pair<const Node*, Node**>> copyQueue;
+            copyQueue.push({pattern, slot});
+
+            while (!copyQueue.empty() && createdCount < n) {
+                const Node* src = copyQueue.front().first;
+                Node** dst = copyQueue.front().second;
+                copyQueue.pop();
+
+                Node* node = new Node(T(createdCount));
+                *dst = node;
+                createdCount++;
+
+                if (!src->left && !src->right) {
+                    // 模板的叶子：两个空位留给后续的模板
+                    slots.push(&node->left);
+                    slots.push(&node->right);
+                    continue;
+                }
+
+                if (src->left) copyQueue.push({src->left, &node->left});
+                if (src->right) copyQueue.push({src->right, &node->right});
+            }
+        }
+        linkParents();
+    }
+
+    /*
+    * 深拷贝，副本的节点都放在一个节点区里（释放时整体释放）
+    * 源树在节点区中：按下标分段，各线程整段复制（数据可平凡复制时直接 memcpy），再把指针平移到新节点区
+    * 源树逐个分配：拆出若干棵互不相交的子树，先并行统计各子树大小得到在新节点区中的起点，
+    * 再并行按先序复制各子树，最后复制拆分用的上层节点
+    * 副本沿用本树的混合引擎阈值；threads 为 0 表示全部硬件线程
+    */
+    BinaryTree clone(unsigned threads = 0, TreeBuildStats* stats = nullptr) const {
+        const BenchClock& clock = BenchClock::instance();
+        uint64_t start = clock.now();
+        threads = resolveThreads(threads);
+
+        BinaryTree copy;
+        copy.hybridCutoff = hybridCutoff;
+        if (arena) {
+            threads = static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(threads, (arenaCount + 65535) / 65536)));
+            copy.cloneArena(*this, threads);
+        } else if (root) {
+            copy.cloneNodes(root, threads);
+        } else {
+            threads = 1;
+        }
+
+        if (stats) {
+            stats->ms = clock.elapsedNs(start, clock.now()) / 1e6;
+            stats->nodes = copy.arenaCount;
+            stats->threads = threads;
+        }
+        return copy;
+    }
+
+    // 复制另一棵树（父指针策略可以不同），用于在同一形状上对比两种节点布局
+    template<typename OtherPolicy>
+    void copyFrom(const BinaryTree<T, OtherPolicy>& other) {
+        typedef typename BinaryTree<T, OtherPolicy>::Node OtherNode;
+        const OtherNode* source = other.getRoot();
+        Node* newRoot = source ? new Node(source->data) : nullptr;
+        std::vector<std::pair<const OtherNode*, Node*>> stack;
+        if (source) stack.push_back({source, newRoot});
+        while (!stack.empty()) {
+            const OtherNode* src = stack.back().first;
+            Node* dst = stack.back().second;
+            stack.pop_back();
+            if (src->left) {
+                dst->left = new Node(src->left->data);
+                stack.push_back({src->left, dst->left});
+            }
+            if (src->right) {
+                dst->right = new Node(src->right->data);
+                stack.push_back({src->right, dst->right});
+            }
+        }
+        setRoot(newRoot);
+    }
+
+    // 从 CSV 边表（id,left,right,value）加载树，见 csvtreeloader.h
+    // 失败时保持原树不变；info 返回各阶段耗时与吞吐
+    bool loadFromCSV(const std::string& filename, std::string* error = nullptr, CsvTreeData* info = nullptr,
+                     unsigned threads = 0, const CsvProgressCallback& progress = CsvProgressCallback()) {
+        // 整数节点值按 T 的范围检查，不让越界的值在转换时悄悄回绕
+        int64_t minValue = INT64_MIN;
+        int64_t maxValue = INT64_MAX;
+        if constexpr (std::is_integral<T>::value) {
+            if (std::numeric_limits<T>::is_signed) minValue = static_cast<int64_t>(std::numeric_limits<T>::min());
+            else minValue = 0;
+            if (uint64_t(std::numeric_limits<T>::max()) < uint64_t(INT64_MAX)) {
+                maxValue = static_cast<int64_t>(std::numeric_limits<T>::max());
+            }
+        }
+        CsvTreeData data;
+        if (!loadCsvTree(filename, data, error, threads, progress, minValue, maxValue)) return false;
+
+        std::vector<Node*> nodes(data.nodeCount);
+        for (size_t i = 0; i < nodes.size(); i++) {
+            nodes[i] = new Node(static_cast<T>(data.values[i]));
+        }
+        for (size_t i = 0; i < nodes.size(); i++) {
+            if (data.left[i] >= 0) nodes[i]->left = nodes[data.left[i]];
+            if (data.right[i] >= 0) nodes[i]->right = nodes[data.right[i]];
+        }
+        setRoot(nodes[data.root]);
+
+        if (info) {
+            // 结构数组已转成指针树，只保留统计信息
+            std::vector<int32_t>().swap(data.left);
+            std::vector<int32_t>().swap(data.right);
+            std::vector<int64_t>().swap(data.values);
+            *info = std::move(data);
+        }
+        return true;
+    }
+
     // 递归的层序遍历助手函数
-    void levelorderRecursiveHelper(TreeNode<T>* node, int level, void (*visit)(TreeNode<T>*)) {
+    void levelorderRecursiveHelper(Node* node, int level, void (*visit)(Node*)) {
         if (!node || level < 0) return;
 
         if (level == 0) {
@@ -379,23 +1755,27 @@ public:
     }
 
     // 递归层序遍历（通过多次调用不同层级的递归实现）
-    TraversalStats levelOrderRecursive(void (*visit)(TreeNode<T>*)) {
+    TraversalStats levelOrderRecursive(void (*visit)(Node*)) {
         TraversalStats stats;
-        auto start = std::chrono::high_resolution_clock::now();
+        const BenchClock& clock = BenchClock::instance();
+        uint64_t start = clock.now();
 
         int height = getHeight(root);
         for (int level = 0; level < height; level++) {
             levelorderRecursiveHelper(root, level, visit);
         }
 
-        auto end = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
-        stats.time_ms = duration.count() / 1000.0;
+        uint64_t end = clock.now();
+        int measuredHeight;
+        size_t count;
+        measureShape(measuredHeight, count);
+        stats.setTiming(clock.elapsedNs(start, end), count);
 
-        stats.memory_usage = height * sizeof(TreeNode<T>*) * 2;
+        stats.memory_usage = height * sizeof(Node*) * 2;
         stats.max_stack_depth = height;
 
         return stats;
     }
 };
 
+#endif // BINARYTREE_CPP
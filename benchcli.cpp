@@ -0,0 +1,530 @@
+#include "benchcli.h"
+#include "benchsuite.h"
+#include "benchstore.h"
+#include "treestream.h"
+#include "pagedtree.h"
+#include "sharedtree.h"
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QTextStream>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QDir>
+#include <QFile>
+#include <cstring>
+
+// 防止编译器优化掉遍历的访问函数
+static void visitNodeForBench(TreeNode<int>* node)
+{
+    volatile int temp = node->data;
+    (void)temp;
+}
+
+static void visitLinkedNodeForBench(TreeNode<int, ParentLink>* node)
+{
+    volatile int temp = node->data;
+    (void)temp;
+}
+
+static void visitValueForBench(const int& value)
+{
+    volatile int temp = value;
+    (void)temp;
+}
+
+// 分页模式：树写成分页文件后即释放指针树，遍历只经过容量为 cacheBytes 的页缓存
+// 每个样本都重新打开文件，保证从冷缓存开始
+static bool runPagedSize(BinaryTree<int>& tree, int n, size_t cacheBytes, size_t readahead,
+                         const HarnessConfig& config, BenchRun& run, QTextStream& out, QTextStream& err)
+{
+    QString path = QDir::temp().filePath(QString("bintree_%1.btp").arg(n));
+    std::string error;
+    if (!pagedtree::save(tree, path.toStdString(), pagedtree::kDefaultPageSize, &error)) {
+        err << "写分页文件失败: " << QString::fromStdString(error) << "\n";
+        return false;
+    }
+    tree.setRoot(nullptr);
+
+    const TraversalClass kinds[] = {PRE, IN, POST, LEVEL};
+    const char* names[] = {"分页先序", "分页中序", "分页后序", "分页层序"};
+    PageCacheStats lastStats[4];
+    uint64_t fileBytes = 0;
+    bool ok = true;
+
+    std::vector<SampleSummary> summaries = bench::runInterleaved(4, [&](int alg) {
+        PagedTree<int> paged;
+        TraversalStats stats;
+        if (!paged.open(path.toStdString(), cacheBytes, readahead, true, &error)
+            || !paged.Traversal(kinds[alg], visitValueForBench, stats, &lastStats[alg], &error)) {
+            ok = false;
+            return 0.0;
+        }
+        fileBytes = paged.fileBytes();
+        return stats.time_ns;
+    }, config, [&]() { return !ok; });
+    QFile::remove(path);
+    if (!ok) {
+        err << "分页文件打开或遍历失败: " << QString::fromStdString(error) << "\n";
+        return false;
+    }
+
+    out << QString("\nN=%1 分页文件 %2 MB, 页缓存上限 %3 MB%4\n")
+               .arg(n)
+               .arg(fileBytes / 1048576.0, 0, 'f', 1)
+               .arg(cacheBytes / 1048576.0, 0, 'f', 1)
+               .arg(cacheBytes >= fileBytes ? "（缓存不小于文件，不是真正的外存测试）" : "");
+    for (int alg = 0; alg < 4; alg++) {
+        BenchRecord record;
+        record.algorithm = names[alg];
+        record.n = n;
+        record.summary = summaries[alg];
+        run.records.append(record);
+
+        const SampleSummary& s = record.summary;
+        const PageCacheStats& c = lastStats[alg];
+        out << QString("  %1 %2 ms %3 ns/节点 缺页 %4 命中率 %5% 读盘 %6 MB/%7 次 预读 %8/%9 页\n")
+                   .arg(record.algorithm, -8)
+                   .arg(s.median / 1e6, 10, 'f', 3)
+                   .arg(s.median / n, 8, 'f', 2)
+                   .arg(c.faults)
+                   .arg(c.hitRatio() * 100.0, 0, 'f', 2)
+                   .arg(c.bytesRead / 1048576.0, 0, 'f', 1)
+                   .arg(c.readCalls)
+                   .arg(c.readaheadUsed)
+                   .arg(c.readaheadPages);
+    }
+    out.flush();
+    return true;
+}
+
+bool isBenchCliRequested(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--bench") == 0) return true;
+    }
+    return false;
+}
+
+// 多进程模式：树放进 POSIX 共享内存，由 fork 出的进程池按子树分工遍历，结果经共享内存结果环交回
+// 同一任务划分在本进程内依次遍历作为对照，两者的节点数、和与指纹必须一致
+static bool runSharedSize(const BinaryTree<int>& tree, int n, unsigned processes, bench::CpuPinGuard& pinGuard,
+                          const HarnessConfig& config, BenchRun& run, QTextStream& out, QTextStream& err)
+{
+    SharedTreeArena<int> arena;
+    std::string error;
+    if (!arena.create(tree, processes, 8, &error)) {
+        err << "建立共享内存失败: " << QString::fromStdString(error) << "\n";
+        return false;
+    }
+    // 工作进程继承亲和性，启动时先解除绑核
+    pinGuard.suspend();
+    bool started = arena.startWorkers(&error);
+    pinGuard.resume();
+    if (!started) {
+        err << "启动工作进程失败: " << QString::fromStdString(error) << "\n";
+        return false;
+    }
+
+    const TraversalClass kinds[] = {PRE, IN, POST, LEVEL};
+    const char* names[] = {"多进程先序", "多进程中序", "多进程后序", "多进程层序",
+                           "单进程先序", "单进程中序", "单进程后序", "单进程层序"};
+    SharedRunResult results[8];
+    bool ok = true;
+    std::vector<SampleSummary> summaries = bench::runInterleaved(8, [&](int alg) {
+        if (alg >= 4) {
+            results[alg] = arena.runLocal(kinds[alg - 4]);
+        } else if (!arena.run(kinds[alg], results[alg], &error)) {
+            ok = false;
+        }
+        return results[alg].ns;
+    }, config, [&]() { return !ok; });
+    if (!ok) {
+        err << "多进程遍历失败: " << QString::fromStdString(error) << "\n";
+        return false;
+    }
+
+    out << QString("\nN=%1 共享内存 %2 MB, %3 个工作进程, %4 棵子树任务, 主进程访问上层 %5 个节点, 段 %6\n")
+               .arg(n)
+               .arg(arena.segmentBytes() / 1048576.0, 0, 'f', 1)
+               .arg(arena.workerCount())
+               .arg(arena.taskCount())
+               .arg(arena.upperNodeCount())
+               .arg(QString::fromStdString(arena.name()));
+    for (int alg = 0; alg < 8; alg++) {
+        BenchRecord record;
+        record.algorithm = names[alg];
+        record.n = n;
+        record.summary = summaries[alg];
+        run.records.append(record);
+
+        const SampleSummary& s = record.summary;
+        QString line = QString("  %1 %2 ms %3 ns/节点 %4 M节点/s")
+                           .arg(record.algorithm, -8)
+                           .arg(s.median / 1e6, 10, 'f', 3)
+                           .arg(s.median / n, 8, 'f', 2)
+                           .arg(s.median > 0.0 ? n * 1e3 / s.median : 0.0, 8, 'f', 1);
+        if (alg < 4) {
+            const SharedRunResult& local = results[alg + 4];
+            line += QString(" 最忙进程 %1 ms").arg(results[alg].busiestWorkerNs / 1e6, 0, 'f', 3);
+            if (summaries[alg].median > 0.0) {
+                line += QString(" 加速 %1x").arg(summaries[alg + 4].median / summaries[alg].median, 0, 'f', 2);
+            }
+            if (!results[alg].sameResult(local) || results[alg].nodes != static_cast<uint64_t>(n)) line += " 结果不一致！";
+        }
+        out << line << "\n";
+    }
+    out.flush();
+    return true;
+}
+
+// 校准模式：对一棵树的每种遍历顺序交替测试所有适用的引擎，最快者记入校准表
+template<typename Tree>
+static void calibrateTree(Tree& tree, const QString& label, void (*visit)(typename Tree::Node*),
+                          const HarnessConfig& config, QTextStream& out)
+{
+    const TraversalClass kinds[] = {PRE, IN, POST, LEVEL};
+    const char* kindNames[] = {"先序", "中序", "后序", "层序"};
+    const size_t n = tree.countNodes();
+    for (TraversalClass kind : kinds) {
+        std::vector<TraversalEngine> engines;
+        for (int e = ENGINE_RECURSIVE; e < ENGINE_COUNT; e++) {
+            if (tree.engineApplicable(static_cast<TraversalEngine>(e), kind)) engines.push_back(static_cast<TraversalEngine>(e));
+        }
+        std::vector<SampleSummary> summaries = bench::runInterleaved(static_cast<int>(engines.size()), [&](int alg) {
+            return tree.Traversal(kind, engines[alg], visit).time_ns;
+        }, config);
+
+        size_t best = 0;
+        QString detail;
+        for (size_t i = 0; i < engines.size(); i++) {
+            if (summaries[i].median < summaries[best].median) best = i;
+            detail += QString(" %1 %2").arg(engineName(engines[i])).arg(summaries[i].median / n, 0, 'f', 2);
+        }
+        double nsPerNode = summaries[best].median / n;
+        EngineCalibration::instance().set(tree.engineKey(kind), engines[best], nsPerNode);
+        out << QString("  %1 %2 -> %3 %4 ns/节点 （%5 ）\n")
+                   .arg(label, -10)
+                   .arg(kindNames[kind])
+                   .arg(engineName(engines[best]), -6)
+                   .arg(nsPerNode, 6, 'f', 2)
+                   .arg(detail);
+    }
+    out.flush();
+}
+
+// 梳状深树：右链上每个节点另挂一个左叶子，高度约 n/2，用来校准递归不安全的深度档
+static TreeNode<int>* buildCombTree(int n)
+{
+    TreeNode<int>* root = new TreeNode<int>(0);
+    TreeNode<int>* spine = root;
+    for (int i = 1; i < n; i++) {
+        TreeNode<int>* node = new TreeNode<int>(i);
+        if (i % 2) {
+            spine->left = node;
+        } else {
+            spine->right = node;
+            spine = node;
+        }
+    }
+    return root;
+}
+
+// 对每个规模建出各种存放方式与形状的树逐一校准，结果写入结果库目录
+// 并行建树时暂时解除绑核，否则所有建树线程都挤在测量用的那一个 CPU 上
+static bool runCalibration(const QVector<int>& sizes, const BenchStore& store, const HarnessConfig& config,
+                           bench::CpuPinGuard& pinGuard, QTextStream& out, QTextStream& err)
+{
+    const uint64_t seed = 0x5eedULL;
+    EngineCalibration& table = EngineCalibration::instance();
+    table.clear();
+    for (int n : sizes) {
+        out << QString("\nN=%1\n").arg(n);
+        BinaryTree<int> tree;
+        tree.autoCreateTree(n);
+        calibrateTree(tree, "完全/逐个分配", visitNodeForBench, config, out);
+        BinaryTree<int, ParentLink> linked;
+        linked.copyFrom(tree);
+        calibrateTree(linked, "完全/父指针", visitLinkedNodeForBench, config, out);
+
+        pinGuard.suspend();
+        tree.buildCompleteParallel(n);
+        pinGuard.resume();
+        calibrateTree(tree, "完全/层序节点区", visitNodeForBench, config, out);
+
+        pinGuard.suspend();
+        tree.buildRandomParallel(n, seed);
+        pinGuard.resume();
+        calibrateTree(tree, "随机/先序节点区", visitNodeForBench, config, out);
+        BinaryTree<int> heapRandom;
+        heapRandom.copyFrom(tree);
+        calibrateTree(heapRandom, "随机/逐个分配", visitNodeForBench, config, out);
+        linked.copyFrom(tree);
+        calibrateTree(linked, "随机/父指针", visitLinkedNodeForBench, config, out);
+
+        tree.setRoot(buildCombTree(n));
+        calibrateTree(tree, "梳状深树", visitNodeForBench, config, out);
+        linked.copyFrom(tree);
+        calibrateTree(linked, "梳状/父指针", visitLinkedNodeForBench, config, out);
+    }
+
+    QDir().mkpath(store.directory());
+    QString path = QDir(store.directory()).filePath(EngineCalibration::kFileName);
+    if (!table.save(path.toStdString())) {
+        err << "写校准表失败: " << path << "\n";
+        return false;
+    }
+    out << QString("\n校准表 %1 项 -> %2\n").arg(table.size()).arg(path);
+    return true;
+}
+
+int runBenchCli(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("二叉树遍历基准测试（命令行模式）");
+    parser.addHelpOption();
+
+    QCommandLineOption benchOpt("bench", "以命令行模式运行基准测试");
+    QCommandLineOption sizesOpt("sizes", "测试规模，逗号分隔", "list", "10000,100000,1000000");
+    QCommandLineOption repeatsOpt("repeats", "最少重复次数", "n", "5");
+    QCommandLineOption maxRepeatsOpt("max-repeats", "自动重复的上限", "n", "30");
+    QCommandLineOption warmupOpt("warmup", "每个算法的预热次数", "n", "1");
+    QCommandLineOption noPinOpt("no-pin", "不绑定 CPU");
+    QCommandLineOption storeOpt("store", "结果库目录", "dir", BenchStore::defaultDir());
+    QCommandLineOption saveOpt("save", "把本次结果保存到结果库");
+    QCommandLineOption baselineOpt("baseline", "与之对比的基线 id，latest 表示最近一次保存的结果", "id");
+    QCommandLineOption thresholdOpt("threshold", "判定回退的最小变慢比例", "ratio", "0.05");
+    QCommandLineOption alphaOpt("alpha", "显著性水平", "p", "0.05");
+    QCommandLineOption loadCsvOpt("load-csv", "从 CSV 边表（id,left,right,value）加载树并测试，忽略 --sizes", "file");
+    QCommandLineOption threadsOpt("threads", "CSV 解析线程数，0 表示使用全部硬件线程", "n", "0");
+    QCommandLineOption dumpOpt("dump", "把树（CSV 或 --sizes 的第一个规模）流式写到文件后退出，不做基准测试", "file");
+    QCommandLineOption pagedMemOpt("paged-mem", "分页外存模式：页缓存内存上限（MB），遍历不把树放在内存里", "mb");
+    QCommandLineOption readaheadOpt("readahead", "分页模式下每次缺页最多预读的页数", "pages", "8");
+    QCommandLineOption dumpOrderOpt("dump-order", "导出顺序：pre、in、post、level 或 prenull（带空标记的先序，可重建树）", "order", "prenull");
+    QCommandLineOption parentLinksOpt("parent-links", "同时测试带父指针的树：先序、中序、后序用不带栈的游标");
+    QCommandLineOption processesOpt("processes", "多进程模式：树放进 POSIX 共享内存，由 n 个工作进程按子树分工遍历，0 表示硬件线程数", "n");
+    QCommandLineOption calibrateOpt("calibrate", "校准遍历引擎：测出各种树形与规模下最快的引擎，写入结果库目录的 engine_calibration.txt 供自动模式使用");
+    parser.addOptions({benchOpt, sizesOpt, repeatsOpt, maxRepeatsOpt, warmupOpt, noPinOpt,
+                       storeOpt, saveOpt, baselineOpt, thresholdOpt, alphaOpt, loadCsvOpt, threadsOpt,
+                       dumpOpt, dumpOrderOpt, pagedMemOpt, readaheadOpt, parentLinksOpt, processesOpt,
+                       calibrateOpt});
+    parser.process(app);
+
+    QVector<int> sizes;
+    for (const QString& s : parser.value(sizesOpt).split(',', Qt::SkipEmptyParts)) {
+        int n = s.trimmed().toInt();
+        if (n <= 0) {
+            err << "无效的测试规模: " << s << "\n";
+            return 2;
+        }
+        sizes.append(n);
+    }
+
+    HarnessConfig config;
+    config.minRepeats = std::max(1, parser.value(repeatsOpt).toInt());
+    config.maxRepeats = std::max(config.minRepeats, parser.value(maxRepeatsOpt).toInt());
+    config.warmupRuns = std::max(0, parser.value(warmupOpt).toInt());
+    config.pinCpu = !parser.isSet(noPinOpt);
+
+    BenchStore store(parser.value(storeOpt));
+
+    // 先加载基线，避免跑完才发现基线不存在
+    BenchRun baseline;
+    if (parser.isSet(baselineOpt)) {
+        QString id = parser.value(baselineOpt);
+        if (id == "latest") id = store.latestRun();
+        QString message;
+        if (id.isEmpty() || !store.load(id, baseline, &message)) {
+            err << "无法加载基线 " << parser.value(baselineOpt) << ": " << message << "\n";
+            return 2;
+        }
+        if (baseline.unit != "ns") {
+            err << "基线 " << id << " 的时间单位为 " << baseline.unit << "，无法与纳秒结果对比\n";
+            return 2;
+        }
+    }
+
+    // CSV 树在绑核之前加载，解析线程可以用满所有核
+    BinaryTree<int> csvTree;
+    if (parser.isSet(loadCsvOpt)) {
+        QString path = parser.value(loadCsvOpt);
+        CsvTreeData info;
+        std::string error;
+        bool ok = csvTree.loadFromCSV(path.toStdString(), &error, &info,
+                                      std::max(0, parser.value(threadsOpt).toInt()),
+                                      [&err](size_t done, size_t total) {
+                                          err << QString("\r解析 %1%").arg(total ? 100.0 * done / total : 100.0, 5, 'f', 1);
+                                          err.flush();
+                                      });
+        err << "\n";
+        if (!ok) {
+            err << "加载失败: " << QString::fromStdString(error) << "\n";
+            return 2;
+        }
+        out << QString("CSV: %1 节点, %2 MB, %3 线程, 解析 %4 ms + 解析 id %5 ms + 校验 %6 ms, %7 MB/s\n")
+                   .arg(info.nodeCount)
+                   .arg(info.bytes / 1048576.0, 0, 'f', 1)
+                   .arg(info.threads)
+                   .arg(info.parseMs, 0, 'f', 1)
+                   .arg(info.resolveMs, 0, 'f', 1)
+                   .arg(info.validateMs, 0, 'f', 1)
+                   .arg(info.mbPerSec(), 0, 'f', 0);
+        sizes = {static_cast<int>(info.nodeCount)};
+    }
+
+    if (parser.isSet(dumpOpt)) {
+        const QStringList orders = {"pre", "in", "post", "level", "prenull"};
+        int order = orders.indexOf(parser.value(dumpOrderOpt));
+        if (order < 0) {
+            err << "无效的导出顺序: " << parser.value(dumpOrderOpt) << "\n";
+            return 2;
+        }
+        BinaryTree<int> generated;
+        if (!parser.isSet(loadCsvOpt)) generated.autoCreateTree(sizes.first());
+        const BinaryTree<int>& tree = parser.isSet(loadCsvOpt) ? csvTree : generated;
+
+        StreamStats stats;
+        std::string error;
+        std::string path = parser.value(dumpOpt).toStdString();
+        bool ok = order == STREAM_PRE_NULL
+                      ? treestream::writePreorderWithNulls(tree, path, &stats, &error)
+                      : treestream::writeSequence(tree, static_cast<TraversalClass>(order), path, &stats, &error);
+        if (!ok) {
+            err << "导出失败: " << QString::fromStdString(error) << "\n";
+            return 2;
+        }
+        out << QString("导出 %1 个节点, %2 MB, %3 ms, %4 MB/s, 等待后台 %5 ms\n")
+                   .arg(stats.nodes)
+                   .arg(stats.bytes / 1048576.0, 0, 'f', 1)
+                   .arg(stats.totalNs / 1e6, 0, 'f', 1)
+                   .arg(stats.mbPerSec(), 0, 'f', 0)
+                   .arg(stats.stallNs / 1e6, 0, 'f', 1);
+        return 0;
+    }
+
+    BenchRun run;
+    run.host = HostInfo::current();
+    run.id = bench::newRunId(run.host);
+    run.timestamp = QDateTime::currentDateTime().toString(Qt::ISODate);
+    run.treeShape = parser.isSet(loadCsvOpt) ? "CSV: " + QFileInfo(parser.value(loadCsvOpt)).fileName() : "完全二叉树";
+    if (parser.isSet(pagedMemOpt)) run.treeShape += QString(" (分页, 缓存 %1 MB)").arg(parser.value(pagedMemOpt));
+    if (parser.isSet(processesOpt)) run.treeShape += QString(" (共享内存多进程 %1)").arg(parser.value(processesOpt));
+    run.harness = config;
+    run.unit = "ns";
+
+    out << "CPU: " << run.host.cpuModel << "\n"
+        << "编译器: " << run.host.compiler << " [" << run.host.flags << "]\n"
+        << "版本: " << run.host.gitRev << "\n"
+        << "计时: " << BenchClock::instance().name() << "\n";
+
+    std::vector<AlgorithmSpec> algorithms = bench::traversalAlgorithms();
+    if (parser.isSet(loadCsvOpt) && csvTree.height() > 10000) {
+        // 很深的树用递归遍历会栈溢出
+        algorithms.erase(std::remove_if(algorithms.begin(), algorithms.end(),
+                                        [](const AlgorithmSpec& a) { return a.recursive; }),
+                         algorithms.end());
+        out << "树高超过 10000，跳过递归算法\n";
+    }
+    bench::CpuPinGuard pinGuard(config.pinCpu);
+
+    if (parser.isSet(calibrateOpt)) return runCalibration(sizes, store, config, pinGuard, out, err) ? 0 : 2;
+
+    for (int n : sizes) {
+        BinaryTree<int> generated;
+        if (!parser.isSet(loadCsvOpt)) generated.autoCreateTree(n);
+        BinaryTree<int>& tree = parser.isSet(loadCsvOpt) ? csvTree : generated;
+
+        if (parser.isSet(pagedMemOpt)) {
+            size_t cacheBytes = static_cast<size_t>(std::max(0.0, parser.value(pagedMemOpt).toDouble()) * 1048576.0);
+            size_t readahead = static_cast<size_t>(std::max(0, parser.value(readaheadOpt).toInt()));
+            if (!runPagedSize(tree, n, cacheBytes, readahead, config, run, out, err)) return 2;
+            continue;
+        }
+
+        if (parser.isSet(processesOpt)) {
+            int processes = std::max(0, parser.value(processesOpt).toInt());
+            unsigned workers = processes > 0 ? static_cast<unsigned>(processes)
+                                             : std::max(1u, std::thread::hardware_concurrency());
+            if (!runSharedSize(tree, n, workers, pinGuard, config, run, out, err)) return 2;
+            continue;
+        }
+
+        // 父指针树与指针树交替采样，游标版本排在普通算法之后
+        const TraversalClass linkedKinds[] = {PRE, IN, POST};
+        const char* linkedNames[] = {"父指针先序", "父指针中序", "父指针后序"};
+        BinaryTree<int, ParentLink> linked;
+        int linkedCount = 0;
+        if (parser.isSet(parentLinksOpt)) {
+            linked.copyFrom(tree);
+            linkedCount = 3;
+        }
+        const int plainCount = static_cast<int>(algorithms.size());
+
+        std::vector<SampleSummary> summaries = bench::runInterleaved(
+            plainCount + linkedCount, [&](int alg) {
+                if (alg >= plainCount) {
+                    return linked.Traversal(linkedKinds[alg - plainCount], false, visitLinkedNodeForBench).time_ns;
+                }
+                return tree.Traversal(algorithms[alg].type, algorithms[alg].recursive, visitNodeForBench).time_ns;
+            }, config);
+
+        out << QString("\nN=%1\n").arg(n);
+        if (linkedCount) {
+            out << QString("  父指针额外内存 %1 MB（节点 %2 -> %3 字节），栈版本最大栈 %4 字节\n")
+                       .arg(n * sizeof(TreeNode<int, ParentLink>*) / 1048576.0, 0, 'f', 1)
+                       .arg(sizeof(TreeNode<int>))
+                       .arg(sizeof(TreeNode<int, ParentLink>))
+                       .arg(tree.height() * sizeof(TreeNode<int>*));
+        }
+        for (int alg = 0; alg < plainCount + linkedCount; alg++) {
+            BenchRecord record;
+            record.algorithm = alg < plainCount ? algorithms[alg].name : linkedNames[alg - plainCount];
+            record.n = n;
+            record.summary = summaries[alg];
+            run.records.append(record);
+
+            const SampleSummary& s = record.summary;
+            out << QString("  %1 %2 ms %3 ns/节点 [%4, %5] %6 M节点/s 样本 %7\n")
+                       .arg(record.algorithm, -8)
+                       .arg(s.median / 1e6, 10, 'f', 3)
+                       .arg(s.median / n, 8, 'f', 2)
+                       .arg(s.ciLow / n, 0, 'f', 2)
+                       .arg(s.ciHigh / n, 0, 'f', 2)
+                       .arg(s.median > 0.0 ? n * 1e3 / s.median : 0.0, 8, 'f', 1)
+                       .arg(s.samples.size());
+        }
+        out.flush();
+    }
+
+    if (parser.isSet(saveOpt)) {
+        QString message;
+        if (!store.save(run, &message)) {
+            err << "保存失败: " << message << "\n";
+            return 2;
+        }
+        out << "\n已保存: " << run.id << " -> " << store.directory() << "\n";
+    }
+
+    if (baseline.isEmpty()) return 0;
+
+    QVector<Regression> regressions = bench::findRegressions(
+        baseline, run, parser.value(thresholdOpt).toDouble(), parser.value(alphaOpt).toDouble());
+
+    out << "\n对比基线 " << baseline.id << " (" << baseline.host.gitRev << ")\n";
+    if (regressions.isEmpty()) {
+        out << "未发现显著回退\n";
+        return 0;
+    }
+    for (const Regression& r : regressions) {
+        out << QString("  回退: %1 N=%2 %3 -> %4 ns/节点 (x%5, p=%6)\n")
+                   .arg(r.algorithm).arg(r.n)
+                   .arg(r.baselineMedian / r.n, 0, 'f', 2)
+                   .arg(r.currentMedian / r.n, 0, 'f', 2)
+                   .arg(r.ratio, 0, 'f', 2)
+                   .arg(r.pValue < 0 ? QString("n/a") : QString::number(r.pValue, 'g', 3));
+    }
+    return 1;
+}
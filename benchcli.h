@@ -0,0 +1,11 @@
+#ifndef BENCHCLI_H
+#define BENCHCLI_H
+
+// 命令行基准测试入口：tree --bench [选项]
+// 返回值：0 正常，1 检测到性能回退，2 参数或文件错误
+int runBenchCli(int argc, char *argv[]);
+
+// 命令行参数中是否要求进入基准测试模式
+bool isBenchCliRequested(int argc, char *argv[]);
+
+#endif // BENCHCLI_H
@@ -0,0 +1,106 @@
+#ifndef BENCHCLOCK_H
+#define BENCHCLOCK_H
+
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define BENCHCLOCK_X86 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#include <cpuid.h>
+#endif
+#endif
+
+/*
+* 高精度计时时钟
+* x86 上若 CPU 支持不变 TSC（频率恒定、各核同步），直接读时间戳计数器，
+* 启动时与 steady_clock 对照校准出每纳秒的计数；否则退回 steady_clock
+*/
+class BenchClock {
+public:
+    static const BenchClock& instance() {
+        static const BenchClock clock;
+        return clock;
+    }
+
+    // 当前时刻（计数）
+    uint64_t now() const {
+#ifdef BENCHCLOCK_X86
+        if (tsc) {
+            _mm_lfence();   // 防止前面的指令被乱序到计时点之后
+            uint64_t t = __rdtsc();
+            _mm_lfence();
+            return t;
+        }
+#endif
+        return steadyNow();
+    }
+
+    // 两个时刻之间的纳秒数
+    double elapsedNs(uint64_t start, uint64_t end) const {
+        return (end - start) / ticksPerNs;
+    }
+
+    bool usesTsc() const { return tsc; }
+    double frequencyGHz() const { return ticksPerNs; }
+    const char* name() const { return tsc ? "invariant TSC" : "steady_clock"; }
+
+private:
+    bool tsc = false;
+    double ticksPerNs = 1.0;
+
+    BenchClock() {
+        if (!hasInvariantTsc()) return;
+        calibrate();
+        tsc = ticksPerNs > 0.0;
+        if (!tsc) ticksPerNs = 1.0;
+    }
+
+    static uint64_t steadyNow() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    // CPUID 0x80000007: EDX 第 8 位表示不变 TSC
+    static bool hasInvariantTsc() {
+#ifdef BENCHCLOCK_X86
+#if defined(_MSC_VER)
+        int regs[4];
+        __cpuid(regs, 0x80000000);
+        if (static_cast<unsigned>(regs[0]) < 0x80000007u) return false;
+        __cpuid(regs, 0x80000007);
+        return (regs[3] & (1 << 8)) != 0;
+#else
+        unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+        if (__get_cpuid_max(0x80000000u, nullptr) < 0x80000007u) return false;
+        if (!__get_cpuid(0x80000007u, &eax, &ebx, &ecx, &edx)) return false;
+        return (edx & (1u << 8)) != 0;
+#endif
+#else
+        return false;
+#endif
+    }
+
+    // 用约 20ms 的 steady_clock 区间校准 TSC 频率，取三次中的中间值
+    void calibrate() {
+#ifdef BENCHCLOCK_X86
+        double rates[3];
+        for (double& rate : rates) {
+            uint64_t s0 = steadyNow();
+            uint64_t t0 = __rdtsc();
+            while (steadyNow() - s0 < 20000000ull) {}
+            uint64_t s1 = steadyNow();
+            uint64_t t1 = __rdtsc();
+            rate = static_cast<double>(t1 - t0) / static_cast<double>(s1 - s0);
+        }
+        double lo = rates[0] < rates[1] ? rates[0] : rates[1];
+        double hi = rates[0] < rates[1] ? rates[1] : rates[0];
+        ticksPerNs = rates[2] < lo ? lo : (rates[2] > hi ? hi : rates[2]);
+#endif
+    }
+};
+
+#endif // BENCHCLOCK_H
@@ -0,0 +1,212 @@
+#ifndef BENCHHARNESS_H
+#define BENCHHARNESS_H
+
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <functional>
+#include <cmath>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+// 测试框架配置
+struct HarnessConfig {
+    int warmupRuns = 1;             // 每个算法正式计时前的预热次数
+    int minRepeats = 3;             // 最少重复次数
+    int maxRepeats = 30;            // 自动重复时的上限
+    bool autoRepeat = true;         // 是否重复直到结果稳定
+    double targetRelCI = 0.03;      // 稳定判据：95% 置信区间半宽 / 中位数
+    bool shuffleOrder = true;       // 每轮随机打乱算法顺序，避免固定顺序带来的缓存偏差
+    bool pinCpu = true;             // 测试期间绑定到当前 CPU
+    double outlierCutoff = 3.5;     // 修正 z 分数超过该值的样本视为离群点
+    int bootstrapResamples = 1000;  // 自助法重采样次数
+    unsigned seed = 20240521;       // 打乱顺序与自助法所用随机种子
+};
+
+// 一组样本的稳健统计结果
+struct SampleSummary {
+    double median = 0.0;
+    double mad = 0.0;               // 中位数绝对偏差（已乘 1.4826，与标准差同尺度）
+    double ciLow = 0.0;             // 中位数 95% 置信区间下界
+    double ciHigh = 0.0;            // 中位数 95% 置信区间上界
+    size_t kept = 0;                // 剔除离群点后的样本数
+    size_t rejected = 0;            // 被剔除的离群点个数
+    std::vector<double> samples;    // 原始样本
+
+    double relativeCI() const {
+        if (median <= 0.0) return 0.0;
+        return (ciHigh - ciLow) / 2.0 / median;
+    }
+};
+
+namespace bench {
+
+inline double median(std::vector<double> v) {
+    if (v.empty()) return 0.0;
+    size_t mid = v.size() / 2;
+    std::nth_element(v.begin(), v.begin() + mid, v.end());
+    double m = v[mid];
+    if (v.size() % 2 == 0) {
+        m = (m + *std::max_element(v.begin(), v.begin() + mid)) / 2.0;
+    }
+    return m;
+}
+
+// 中位数绝对偏差，乘 1.4826 后可作为正态分布标准差的稳健估计
+inline double mad(const std::vector<double>& v, double med) {
+    std::vector<double> dev;
+    dev.reserve(v.size());
+    for (double x : v) dev.push_back(std::fabs(x - med));
+    return 1.4826 * median(dev);
+}
+
+// 按修正 z 分数剔除离群点（MAD 为 0 时不剔除）
+inline std::vector<double> rejectOutliers(const std::vector<double>& v, double cutoff, size_t* rejected) {
+    double med = median(v);
+    double m = mad(v, med);
+    std::vector<double> kept;
+    kept.reserve(v.size());
+    for (double x : v) {
+        if (m > 0.0 && std::fabs(x - med) / m > cutoff) continue;
+        kept.push_back(x);
+    }
+    if (rejected) *rejected = v.size() - kept.size();
+    return kept;
+}
+
+// 中位数的百分位自助法 95% 置信区间
+inline void bootstrapMedianCI(const std::vector<double>& v, int resamples, std::mt19937& rng,
+                              double& low, double& high) {
+    if (v.size() < 2 || resamples <= 0) {
+        low = high = median(v);
+        return;
+    }
+    std::uniform_int_distribution<size_t> pick(0, v.size() - 1);
+    std::vector<double> medians(resamples);
+    std::vector<double> resample(v.size());
+    for (int r = 0; r < resamples; r++) {
+        for (double& x : resample) x = v[pick(rng)];
+        medians[r] = median(resample);
+    }
+    std::sort(medians.begin(), medians.end());
+    low = medians[static_cast<size_t>(0.025 * (resamples - 1))];
+    high = medians[static_cast<size_t>(0.975 * (resamples - 1))];
+}
+
+inline SampleSummary summarize(const std::vector<double>& raw, const HarnessConfig& config, std::mt19937& rng) {
+    SampleSummary summary;
+    summary.samples = raw;
+    if (raw.empty()) return summary;
+
+    std::vector<double> kept = rejectOutliers(raw, config.outlierCutoff, &summary.rejected);
+    summary.kept = kept.size();
+    summary.median = median(kept);
+    summary.mad = mad(kept, summary.median);
+    bootstrapMedianCI(kept, config.bootstrapResamples, rng, summary.ciLow, summary.ciHigh);
+    return summary;
+}
+
+// 测试期间把当前线程绑定到它正在运行的 CPU，析构时恢复原来的亲和性
+class CpuPinGuard {
+public:
+    explicit CpuPinGuard(bool enable) {
+#ifdef __linux__
+        if (!enable) return;
+        int cpu = sched_getcpu();
+        if (cpu < 0 || sched_getaffinity(0, sizeof(oldMask), &oldMask) != 0) return;
+        cpu_set_t mask;
+        CPU_ZERO(&mask);
+        CPU_SET(cpu, &mask);
+        pinnedCpu = sched_setaffinity(0, sizeof(mask), &mask) == 0 ? cpu : -1;
+#else
+        (void)enable;
+#endif
+    }
+
+    ~CpuPinGuard() {
+#ifdef __linux__
+        if (pinnedCpu >= 0) sched_setaffinity(0, sizeof(oldMask), &oldMask);
+#endif
+    }
+
+    CpuPinGuard(const CpuPinGuard&) = delete;
+    CpuPinGuard& operator=(const CpuPinGuard&) = delete;
+
+    // 绑定的 CPU 编号，未绑定时为 -1
+    int cpu() const { return pinnedCpu; }
+
+    // 暂时恢复绑定前的亲和性（例如并行建树，新线程会继承当前线程的亲和性），resume 重新绑回同一个 CPU
+    void suspend() {
+#ifdef __linux__
+        if (pinnedCpu >= 0) sched_setaffinity(0, sizeof(oldMask), &oldMask);
+#endif
+    }
+
+    void resume() {
+#ifdef __linux__
+        if (pinnedCpu < 0) return;
+        cpu_set_t mask;
+        CPU_ZERO(&mask);
+        CPU_SET(pinnedCpu, &mask);
+        sched_setaffinity(0, sizeof(mask), &mask);
+#endif
+    }
+
+private:
+    int pinnedCpu = -1;
+#ifdef __linux__
+    cpu_set_t oldMask;
+#endif
+};
+
+/*
+* 交错运行 algCount 个算法并返回每个算法的统计结果
+* run(alg) 执行一次算法并返回耗时；shouldStop() 返回 true 时提前结束
+* 先对每个算法预热，然后每轮按随机顺序各跑一次，
+* 达到 minRepeats 后若所有算法的置信区间都足够窄（或已到 maxRepeats）就停止
+*/
+inline std::vector<SampleSummary> runInterleaved(int algCount,
+                                                 const std::function<double(int)>& run,
+                                                 const HarnessConfig& config,
+                                                 const std::function<bool()>& shouldStop = nullptr) {
+    std::mt19937 rng(config.seed);
+    std::vector<std::vector<double>> samples(algCount);
+    std::vector<SampleSummary> summaries(algCount);
+
+    std::vector<int> order(algCount);
+    std::iota(order.begin(), order.end(), 0);
+
+    for (int w = 0; w < config.warmupRuns; w++) {
+        for (int alg : order) run(alg);
+    }
+
+    int maxRepeats = config.autoRepeat ? std::max(config.maxRepeats, config.minRepeats) : config.minRepeats;
+    for (int repeat = 0; repeat < maxRepeats; repeat++) {
+        if (shouldStop && shouldStop()) break;
+
+        if (config.shuffleOrder) std::shuffle(order.begin(), order.end(), rng);
+        for (int alg : order) samples[alg].push_back(run(alg));
+
+        if (repeat + 1 < config.minRepeats) continue;
+        if (!config.autoRepeat) continue;
+
+        bool stable = true;
+        for (int alg = 0; alg < algCount && stable; alg++) {
+            summaries[alg] = summarize(samples[alg], config, rng);
+            stable = summaries[alg].relativeCI() <= config.targetRelCI;
+        }
+        if (stable) break;
+    }
+
+    for (int alg = 0; alg < algCount; alg++) {
+        summaries[alg] = summarize(samples[alg], config, rng);
+    }
+    return summaries;
+}
+
+} // namespace bench
+
+#endif // BENCHHARNESS_H
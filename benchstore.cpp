@@ -0,0 +1,326 @@
+#include "benchstore.h"
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QSysInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <cmath>
+
+// 构建时由 tree.pro 传入，缺省时为 unknown
+#ifndef BENCH_GIT_REV
+#define BENCH_GIT_REV "unknown"
+#endif
+
+// ================================================================
+// HostInfo
+// ================================================================
+
+HostInfo HostInfo::current()
+{
+    HostInfo host;
+
+    // CPU 型号：Linux 下读取 /proc/cpuinfo，其它平台退回到架构名
+    QFile cpuinfo("/proc/cpuinfo");
+    if (cpuinfo.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        const QStringList lines = QString::fromUtf8(cpuinfo.readAll()).split('\n');
+        for (const QString& line : lines) {
+            if (line.startsWith("model name")) {
+                host.cpuModel = line.section(':', 1).trimmed();
+                break;
+            }
+        }
+    }
+    if (host.cpuModel.isEmpty()) {
+        host.cpuModel = QSysInfo::currentCpuArchitecture();
+    }
+
+#if defined(__clang__)
+    host.compiler = QString("clang %1").arg(__clang_version__);
+#elif defined(__GNUC__)
+    host.compiler = QString("gcc %1").arg(__VERSION__);
+#elif defined(_MSC_VER)
+    host.compiler = QString("msvc %1").arg(_MSC_FULL_VER);
+#else
+    host.compiler = "unknown";
+#endif
+
+    // 影响性能的编译选项
+    QStringList flags;
+#ifdef NDEBUG
+    flags << "NDEBUG";
+#endif
+#ifdef QT_NO_DEBUG
+    flags << "release";
+#else
+    flags << "debug";
+#endif
+#ifdef __OPTIMIZE__
+    flags << "optimize";
+#endif
+#ifdef __SSE4_2__
+    flags << "sse4.2";
+#endif
+#ifdef __AVX2__
+    flags << "avx2";
+#endif
+    host.flags = flags.join(' ');
+
+    host.gitRev = BENCH_GIT_REV;
+    host.os = QSysInfo::prettyProductName();
+    return host;
+}
+
+// ================================================================
+// BenchRun
+// ================================================================
+
+const BenchRecord* BenchRun::find(const QString& algorithm, int n) const
+{
+    for (const BenchRecord& record : records) {
+        if (record.n == n && record.algorithm == algorithm) return &record;
+    }
+    return nullptr;
+}
+
+static QJsonObject toJson(const BenchRun& run)
+{
+    QJsonObject host;
+    host["cpu"] = run.host.cpuModel;
+    host["compiler"] = run.host.compiler;
+    host["flags"] = run.host.flags;
+    host["gitRev"] = run.host.gitRev;
+    host["os"] = run.host.os;
+
+    QJsonObject harness;
+    harness["warmupRuns"] = run.harness.warmupRuns;
+    harness["minRepeats"] = run.harness.minRepeats;
+    harness["maxRepeats"] = run.harness.maxRepeats;
+    harness["autoRepeat"] = run.harness.autoRepeat;
+    harness["shuffleOrder"] = run.harness.shuffleOrder;
+    harness["pinCpu"] = run.harness.pinCpu;
+
+    QJsonArray results;
+    for (const BenchRecord& record : run.records) {
+        QJsonObject r;
+        r["algorithm"] = record.algorithm;
+        r["n"] = record.n;
+        r["median"] = record.summary.median;
+        r["mad"] = record.summary.mad;
+        r["ciLow"] = record.summary.ciLow;
+        r["ciHigh"] = record.summary.ciHigh;
+        r["rejected"] = static_cast<int>(record.summary.rejected);
+        QJsonArray samples;
+        for (double x : record.summary.samples) samples.append(x);
+        r["samples"] = samples;
+        results.append(r);
+    }
+
+    QJsonObject root;
+    root["version"] = 1;
+    root["id"] = run.id;
+    root["timestamp"] = run.timestamp;
+    root["treeShape"] = run.treeShape;
+    root["unit"] = run.unit;
+    root["host"] = host;
+    root["harness"] = harness;
+    root["results"] = results;
+    return root;
+}
+
+static BenchRun fromJson(const QJsonObject& root)
+{
+    BenchRun run;
+    run.id = root["id"].toString();
+    run.timestamp = root["timestamp"].toString();
+    run.treeShape = root["treeShape"].toString();
+    run.unit = root["unit"].toString("ms");
+
+    QJsonObject host = root["host"].toObject();
+    run.host.cpuModel = host["cpu"].toString();
+    run.host.compiler = host["compiler"].toString();
+    run.host.flags = host["flags"].toString();
+    run.host.gitRev = host["gitRev"].toString();
+    run.host.os = host["os"].toString();
+
+    QJsonObject harness = root["harness"].toObject();
+    run.harness.warmupRuns = harness["warmupRuns"].toInt(run.harness.warmupRuns);
+    run.harness.minRepeats = harness["minRepeats"].toInt(run.harness.minRepeats);
+    run.harness.maxRepeats = harness["maxRepeats"].toInt(run.harness.maxRepeats);
+    run.harness.autoRepeat = harness["autoRepeat"].toBool(run.harness.autoRepeat);
+    run.harness.shuffleOrder = harness["shuffleOrder"].toBool(run.harness.shuffleOrder);
+    run.harness.pinCpu = harness["pinCpu"].toBool(run.harness.pinCpu);
+
+    const QJsonArray results = root["results"].toArray();
+    for (const QJsonValue& value : results) {
+        QJsonObject r = value.toObject();
+        BenchRecord record;
+        record.algorithm = r["algorithm"].toString();
+        record.n = r["n"].toInt();
+        record.summary.median = r["median"].toDouble();
+        record.summary.mad = r["mad"].toDouble();
+        record.summary.ciLow = r["ciLow"].toDouble();
+        record.summary.ciHigh = r["ciHigh"].toDouble();
+        record.summary.rejected = r["rejected"].toInt();
+        const QJsonArray samples = r["samples"].toArray();
+        for (const QJsonValue& x : samples) record.summary.samples.push_back(x.toDouble());
+        record.summary.kept = record.summary.samples.size() - record.summary.rejected;
+        run.records.append(record);
+    }
+    return run;
+}
+
+// ================================================================
+// BenchStore
+// ================================================================
+
+BenchStore::BenchStore(const QString& dir) : dir(dir) {}
+
+QString BenchStore::defaultDir()
+{
+    return QDir::current().filePath("bench_results");
+}
+
+bool BenchStore::save(const BenchRun& run, QString* errorMessage) const
+{
+    if (!QDir().mkpath(dir)) {
+        if (errorMessage) *errorMessage = QString("无法创建目录 %1").arg(dir);
+        return false;
+    }
+
+    // 先写临时文件，写完整并提交后才换成正式文件名；磁盘满等错误不会留下截断的结果
+    QSaveFile file(QDir(dir).filePath(run.id + ".json"));
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (errorMessage) *errorMessage = file.errorString();
+        return false;
+    }
+    QByteArray json = QJsonDocument(toJson(run)).toJson(QJsonDocument::Indented);
+    if (file.write(json) != json.size()) {
+        if (errorMessage) *errorMessage = file.errorString();
+        file.cancelWriting();
+        return false;
+    }
+    if (!file.commit()) {
+        if (errorMessage) *errorMessage = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+bool BenchStore::load(const QString& id, BenchRun& run, QString* errorMessage) const
+{
+    QFile file(QDir(dir).filePath(id + ".json"));
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (errorMessage) *errorMessage = file.errorString();
+        return false;
+    }
+
+    QJsonParseError parseError;
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (doc.isNull() || !doc.isObject()) {
+        if (errorMessage) *errorMessage = parseError.errorString();
+        return false;
+    }
+
+    run = fromJson(doc.object());
+    return true;
+}
+
+QStringList BenchStore::listRuns() const
+{
+    // id 以时间戳开头，按文件名排序即按时间排序
+    QStringList ids;
+    const QFileInfoList files = QDir(dir).entryInfoList({"*.json"}, QDir::Files, QDir::Name);
+    for (const QFileInfo& info : files) ids << info.completeBaseName();
+    return ids;
+}
+
+QString BenchStore::latestRun() const
+{
+    QStringList ids = listRuns();
+    return ids.isEmpty() ? QString() : ids.last();
+}
+
+// ================================================================
+// 回退检测
+// ================================================================
+
+namespace bench {
+
+QString newRunId(const HostInfo& host)
+{
+    return QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss") + "-" + host.gitRev;
+}
+
+double mannWhitneyGreater(const std::vector<double>& current, const std::vector<double>& baseline)
+{
+    const size_t n1 = current.size();
+    const size_t n2 = baseline.size();
+    if (n1 == 0 || n2 == 0) return 1.0;
+
+    // 合并后排序求秩，相同值取平均秩
+    std::vector<std::pair<double, int>> all;
+    all.reserve(n1 + n2);
+    for (double x : current) all.push_back({x, 0});
+    for (double x : baseline) all.push_back({x, 1});
+    std::sort(all.begin(), all.end());
+
+    double rankSumCurrent = 0.0;
+    double tieTerm = 0.0;
+    for (size_t i = 0; i < all.size();) {
+        size_t j = i;
+        while (j < all.size() && all[j].first == all[i].first) j++;
+        double avgRank = (i + 1 + j) / 2.0;
+        for (size_t k = i; k < j; k++) {
+            if (all[k].second == 0) rankSumCurrent += avgRank;
+        }
+        double t = static_cast<double>(j - i);
+        tieTerm += t * t * t - t;
+        i = j;
+    }
+
+    double u = rankSumCurrent - n1 * (n1 + 1) / 2.0;
+    double mean = n1 * n2 / 2.0;
+    double total = static_cast<double>(n1 + n2);
+    double variance = n1 * n2 / 12.0 * ((total + 1) - tieTerm / (total * (total - 1)));
+    if (variance <= 0.0) return u > mean ? 0.0 : 1.0;
+
+    // 正态近似，带连续性校正
+    double z = (u - mean - 0.5) / std::sqrt(variance);
+    return 0.5 * std::erfc(z / std::sqrt(2.0));
+}
+
+QVector<Regression> findRegressions(const BenchRun& baseline, const BenchRun& current,
+                                    double minSlowdown, double alpha)
+{
+    QVector<Regression> regressions;
+    for (const BenchRecord& record : current.records) {
+        const BenchRecord* base = baseline.find(record.algorithm, record.n);
+        if (!base || base->summary.median <= 0.0) continue;
+
+        Regression r;
+        r.algorithm = record.algorithm;
+        r.n = record.n;
+        r.baselineMedian = base->summary.median;
+        r.currentMedian = record.summary.median;
+        r.ratio = r.currentMedian / r.baselineMedian;
+        if (r.ratio <= 1.0 + minSlowdown) continue;
+
+        bool significant;
+        if (record.summary.samples.size() >= 3 && base->summary.samples.size() >= 3) {
+            r.pValue = mannWhitneyGreater(record.summary.samples, base->summary.samples);
+            significant = r.pValue < alpha;
+        } else {
+            r.pValue = -1.0;
+            significant = record.summary.ciLow > base->summary.ciHigh;
+        }
+
+        if (significant) regressions.append(r);
+    }
+    return regressions;
+}
+
+} // namespace bench
@@ -0,0 +1,90 @@
+#ifndef BENCHSTORE_H
+#define BENCHSTORE_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include "benchharness.h"
+
+// 运行环境信息
+struct HostInfo {
+    QString cpuModel;
+    QString compiler;
+    QString flags;
+    QString gitRev;
+    QString os;
+
+    // 采集当前进程的运行环境
+    static HostInfo current();
+};
+
+// 某个算法在某个规模下的一条结果
+struct BenchRecord {
+    QString algorithm;
+    int n = 0;
+    SampleSummary summary;
+};
+
+// 一次完整的测试（可保存为基线）
+struct BenchRun {
+    QString id;
+    QString timestamp;
+    QString treeShape;
+    QString unit = "ms";
+    HostInfo host;
+    HarnessConfig harness;
+    QVector<BenchRecord> records;
+
+    bool isEmpty() const { return records.isEmpty(); }
+    const BenchRecord* find(const QString& algorithm, int n) const;
+};
+
+// 相对基线的性能回退
+struct Regression {
+    QString algorithm;
+    int n = 0;
+    double baselineMedian = 0.0;
+    double currentMedian = 0.0;
+    double ratio = 0.0;      // 当前 / 基线
+    double pValue = 1.0;     // 单侧 Mann-Whitney U 检验，样本不足时为 -1
+};
+
+// 本地结果库：每次测试保存为目录下的一个 JSON 文件
+class BenchStore
+{
+public:
+    explicit BenchStore(const QString& dir = defaultDir());
+
+    // 默认目录：当前工作目录下的 bench_results
+    static QString defaultDir();
+
+    bool save(const BenchRun& run, QString* errorMessage = nullptr) const;
+    bool load(const QString& id, BenchRun& run, QString* errorMessage = nullptr) const;
+    // 按时间从旧到新列出所有已保存的测试 id
+    QStringList listRuns() const;
+    // 最近一次保存的测试 id，没有时返回空串
+    QString latestRun() const;
+
+    QString directory() const { return dir; }
+
+private:
+    QString dir;
+};
+
+namespace bench {
+
+// 生成新的测试 id（时间戳 + git 版本）
+QString newRunId(const HostInfo& host);
+
+// 单侧 Mann-Whitney U 检验：current 是否显著大于 baseline，返回 p 值
+double mannWhitneyGreater(const std::vector<double>& current, const std::vector<double>& baseline);
+
+// 找出所有显著变慢的 (算法, 规模)：
+// 中位数变慢超过 minSlowdown，且 U 检验 p < alpha；
+// 样本数不足 3 时改用置信区间不重叠作为判据
+QVector<Regression> findRegressions(const BenchRun& baseline, const BenchRun& current,
+                                    double minSlowdown = 0.05, double alpha = 0.05);
+
+} // namespace bench
+
+#endif // BENCHSTORE_H
@@ -0,0 +1,32 @@
+#ifndef BENCHSUITE_H
+#define BENCHSUITE_H
+
+#include <vector>
+#include "BinaryTree.cpp"
+
+// 趋势测试中的一种算法
+struct AlgorithmSpec {
+    const char* name;
+    TraversalClass type;
+    bool recursive;
+};
+
+namespace bench {
+
+// 趋势测试的 7 种算法，图表、命令行与结果库共用同一套名称和顺序
+inline const std::vector<AlgorithmSpec>& traversalAlgorithms() {
+    static const std::vector<AlgorithmSpec> algorithms = {
+        {"先序递归", PRE, true},
+        {"先序非递归", PRE, false},
+        {"中序递归", IN, true},
+        {"中序非递归", IN, false},
+        {"后序递归", POST, true},
+        {"后序非递归", POST, false},
+        {"层序遍历", LEVEL, false},
+    };
+    return algorithms;
+}
+
+} // namespace bench
+
+#endif // BENCHSUITE_H
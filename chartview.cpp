@@ -4,6 +4,12 @@
 #include <QProgressDialog>
 #include <QThread>
 #include <algorithm>
+#include <QInputDialog>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QFileDialog>
+#include <QElapsedTimer>
 
 // template class BinaryTree<int>;
 
@@ -23,10 +29,24 @@ const std::vector<bool> MyChartView::lineStyleConfig = {
 
 MyChartView::MyChartView(QWidget *parent)
     : QWidget(parent)
+    , patternTree(nullptr)
+    , lastRunMetric(METRIC_NS_PER_NODE)
     , chart(nullptr)
     , chartView(nullptr)
 {
     setupUI();
+
+    // 在任何测试绑核之前启动后台回收线程，使它不继承绑定的 CPU
+    TreeReclaimer::instance();
+
+    // 自动引擎用的校准表从结果库目录加载，与 tree --bench --calibrate 默认写出的位置相同
+    QString calibrationPath = QDir(BenchStore::defaultDir()).filePath(EngineCalibration::kFileName);
+    EngineCalibration& table = EngineCalibration::instance();
+    if (table.load(calibrationPath.toStdString())) {
+        textLog->append(QString("已加载引擎校准表 %1（%2 项）").arg(calibrationPath).arg(table.size()));
+    } else {
+        textLog->append(QString("未找到引擎校准表 %1，自动模式按经验规则选引擎").arg(calibrationPath));
+    }
 }
 
 MyChartView::~MyChartView()
@@ -34,6 +54,23 @@ MyChartView::~MyChartView()
     if (chart) {
         delete chart;
     }
+    deleteTree(patternTree);
+}
+
+void MyChartView::setPatternTree(BinaryTree<int>* pattern)
+{
+    deleteTree(patternTree);
+    patternTree = pattern;
+
+    if (!patternTree || patternTree->countNodes() == 0) {
+        comboTreeShape->setCurrentIndex(comboTreeShape->findData(SHAPE_COMPLETE));
+        textLog->append("手绘形状为空，继续使用完全二叉树");
+        return;
+    }
+
+    comboTreeShape->setCurrentIndex(comboTreeShape->findData(SHAPE_PATTERN));
+    textLog->append(QString("已载入手绘形状模板：%1 个节点，高度 %2")
+                        .arg(patternTree->countNodes()).arg(patternTree->height()));
 }
 
 void MyChartView::setupUI()
@@ -55,13 +92,73 @@ void MyChartView::setupUI()
     comboTraversalType->addItem("层序遍历", LEVEL);
     comboTraversalType->setFixedWidth(120);
 
+    comboTreeShape = new QComboBox();
+    comboTreeShape->addItem("完全二叉树", SHAPE_COMPLETE);
+    comboTreeShape->addItem("手绘形状平铺", SHAPE_PATTERN);
+    comboTreeShape->addItem("随机形状", SHAPE_RANDOM);
+    comboTreeShape->setFixedWidth(120);
+    comboTreeShape->setToolTip("手绘形状需先在“演示”页导出");
+
+    comboTimeMetric = new QComboBox();
+    comboTimeMetric->addItem("总时间 (ms)", METRIC_TOTAL_MS);
+    comboTimeMetric->addItem("每节点 (ns)", METRIC_NS_PER_NODE);
+    comboTimeMetric->addItem("吞吐 (百万节点/秒)", METRIC_THROUGHPUT);
+    comboTimeMetric->setCurrentIndex(1);
+    comboTimeMetric->setFixedWidth(150);
+    comboTimeMetric->setToolTip("每节点时间与吞吐量可直接比较不同规模的结果");
+
     btnCompare = new QPushButton("单次对比");
+    btnBinaryFile = new QPushButton("二进制文件加载对比");
+    btnBinaryFile->setToolTip("把 N 个节点的树写成二进制文件，比较 mmap 零拷贝加载与重新创建节点的启动时间");
+    btnLoadCsv = new QPushButton("加载 CSV 树");
+    btnLoadCsv->setToolTip("并行加载 id,left,right,value 格式的边表，并在该树上运行全部遍历算法");
+    btnStream = new QPushButton("流式序列化");
+    btnStream->setToolTip("把 N 个节点的树按各遍历顺序流式写盘（双缓冲后台写出），再由带空标记的先序编码重建");
+    btnSuccinct = new QPushButton("简洁编码对比");
+    btnSuccinct->setToolTip("比较指针树与每节点约 2 位的简洁编码（层序位图 + rank/select）的内存与每节点耗时");
+    editBatchSize = new QLineEdit(QString::number(kDefaultBatchSize));
+    editBatchSize->setFixedWidth(60);
+    editBatchSize->setToolTip("批量访问时每批的节点数；层序总是按整层交付");
+    btnBatch = new QPushButton("批量访问对比");
+    btnBatch->setToolTip("同一逐节点计算分别用逐节点回调与按批回调完成，比较指针树、下标链接视图与简洁编码");
+    btnAggregate = new QPushButton("SIMD 聚合对比");
+    btnAggregate->setToolTip("求和、最小、最大与阈值计数：回调累加对比连续数组上的 SSE4.1/AVX2 内核与指针树的 gather 路径");
+    btnPersistent = new QPushButton("持久化版本对比");
+    btnPersistent->setToolTip("路径复制的结构共享版本与整棵 clone() 比较快照、单次更新的耗时和保留多个版本的内存");
+    btnConcurrent = new QPushButton("并发读写压测");
+    btnConcurrent->setToolTip("多个读者无锁遍历的同时，写者以不同强度摘下/挂上子树，节点经纪元回收释放；比较读者吞吐");
+    btnConcurrentInsert = new QPushButton("并发插入对比");
+    btnConcurrentInsert->setToolTip("1..N 个生产者线程并发插入完全二叉树：原子计数器领取层序位置的无锁插入对比全局互斥锁");
+    btnHybrid = new QPushButton("混合阈值扫描");
+    btnHybrid->setToolTip("先序、中序、后序的混合遍历：上层显式栈、剩余高度不超过阈值的子树用展开的递归；画出耗时随阈值的变化");
+    btnFixedShape = new QPushButton("定形特化对比");
+    btnFixedShape->setToolTip("完全二叉树底部的满子树用按高度展开的内核或编译期排列表遍历，小树用固定节点数的排列表，对比通用遍历");
+    btnRankRange = new QPushButton("名次区间并行");
+    btnRankRange->setToolTip("完全二叉树的层序下标与先序/中序/后序名次 O(log n) 互换：随机访问第 k 个节点，并把一次遍历按名次切段交给多个线程");
 
     singleTestLayout->addWidget(new QLabel("单次测试 - 节点数(N):"));
     singleTestLayout->addWidget(editDataSize);
     singleTestLayout->addWidget(new QLabel("遍历类型:"));
     singleTestLayout->addWidget(comboTraversalType);
+    singleTestLayout->addWidget(new QLabel("树形状:"));
+    singleTestLayout->addWidget(comboTreeShape);
+    singleTestLayout->addWidget(new QLabel("纵轴:"));
+    singleTestLayout->addWidget(comboTimeMetric);
     singleTestLayout->addWidget(btnCompare);
+    singleTestLayout->addWidget(btnBinaryFile);
+    singleTestLayout->addWidget(btnLoadCsv);
+    singleTestLayout->addWidget(btnStream);
+    singleTestLayout->addWidget(btnSuccinct);
+    singleTestLayout->addWidget(new QLabel("批大小:"));
+    singleTestLayout->addWidget(editBatchSize);
+    singleTestLayout->addWidget(btnBatch);
+    singleTestLayout->addWidget(btnAggregate);
+    singleTestLayout->addWidget(btnPersistent);
+    singleTestLayout->addWidget(btnConcurrent);
+    singleTestLayout->addWidget(btnConcurrentInsert);
+    singleTestLayout->addWidget(btnHybrid);
+    singleTestLayout->addWidget(btnFixedShape);
+    singleTestLayout->addWidget(btnRankRange);
     singleTestLayout->addStretch();
 
     // 第二行：趋势测试参数
@@ -81,7 +178,25 @@ void MyChartView::setupUI()
 
     editRepeatTimes = new QLineEdit("3");
     editRepeatTimes->setFixedWidth(60);
-    editRepeatTimes->setToolTip("每个节点数重复测试次数");
+    editRepeatTimes->setToolTip("每个节点数最少重复测试次数");
+
+    editWarmup = new QLineEdit("1");
+    editWarmup->setFixedWidth(40);
+    editWarmup->setToolTip("每个算法正式计时前的预热次数");
+
+    checkAutoRepeat = new QCheckBox("自动重复至稳定");
+    checkAutoRepeat->setChecked(true);
+    checkAutoRepeat->setToolTip("持续重复，直到每个算法中位数的 95% 置信区间半宽不超过 3%");
+
+    checkPinCpu = new QCheckBox("绑定CPU");
+    checkPinCpu->setChecked(true);
+
+    checkSaveResults = new QCheckBox("保存结果");
+    checkSaveResults->setChecked(true);
+    checkSaveResults->setToolTip("把趋势测试结果连同主机信息保存到 " + BenchStore::defaultDir());
+
+    btnCompareBaseline = new QPushButton("对比基线...");
+    btnCompareBaseline->setToolTip("在当前趋势图上叠加一次已保存的结果，并标出显著回退");
 
     btnTrend = new QPushButton("趋势图(详细统计)");
     btnQuickTrend = new QPushButton("快速趋势图");
@@ -94,8 +209,14 @@ void MyChartView::setupUI()
     trendParamsLayout->addWidget(editStepSize);
     trendParamsLayout->addWidget(new QLabel("重复次数:"));
     trendParamsLayout->addWidget(editRepeatTimes);
+    trendParamsLayout->addWidget(new QLabel("预热:"));
+    trendParamsLayout->addWidget(editWarmup);
+    trendParamsLayout->addWidget(checkAutoRepeat);
+    trendParamsLayout->addWidget(checkPinCpu);
     trendParamsLayout->addWidget(btnTrend);
     trendParamsLayout->addWidget(btnQuickTrend);
+    trendParamsLayout->addWidget(checkSaveResults);
+    trendParamsLayout->addWidget(btnCompareBaseline);
     trendParamsLayout->addStretch();
 
     // 第三行：统计信息显示
@@ -133,8 +254,21 @@ void MyChartView::setupUI()
 
     // 连接信号槽
     connect(btnCompare, &QPushButton::clicked, this, &MyChartView::onCompareClicked);
+    connect(btnBinaryFile, &QPushButton::clicked, this, &MyChartView::onBinaryFileClicked);
+    connect(btnLoadCsv, &QPushButton::clicked, this, &MyChartView::onLoadCsvClicked);
+    connect(btnStream, &QPushButton::clicked, this, &MyChartView::onStreamClicked);
+    connect(btnSuccinct, &QPushButton::clicked, this, &MyChartView::onSuccinctClicked);
+    connect(btnBatch, &QPushButton::clicked, this, &MyChartView::onBatchClicked);
+    connect(btnAggregate, &QPushButton::clicked, this, &MyChartView::onAggregateClicked);
+    connect(btnPersistent, &QPushButton::clicked, this, &MyChartView::onPersistentClicked);
+    connect(btnConcurrent, &QPushButton::clicked, this, &MyChartView::onConcurrentClicked);
+    connect(btnConcurrentInsert, &QPushButton::clicked, this, &MyChartView::onConcurrentInsertClicked);
+    connect(btnHybrid, &QPushButton::clicked, this, &MyChartView::onHybridClicked);
+    connect(btnFixedShape, &QPushButton::clicked, this, &MyChartView::onFixedShapeClicked);
+    connect(btnRankRange, &QPushButton::clicked, this, &MyChartView::onRankRangeClicked);
     connect(btnTrend, &QPushButton::clicked, this, &MyChartView::onTrendClicked);
     connect(btnQuickTrend, &QPushButton::clicked, this, &MyChartView::onQuickTrendClicked);
+    connect(btnCompareBaseline, &QPushButton::clicked, this, &MyChartView::onCompareBaselineClicked);
 }
 
 void MyChartView::onCompareClicked()
@@ -175,7 +309,12 @@ void MyChartView::onTrendClicked()
         return;
     }
 
-    runDetailedTrendTest(minNodes, maxNodes, stepSize, repeatTimes);
+    if (editWarmup->text().toInt() < 0) {
+        QMessageBox::warning(this, "输入错误", "预热次数不能为负数");
+        return;
+    }
+
+    runDetailedTrendTest(minNodes, maxNodes, stepSize, harnessConfigFromUI(repeatTimes));
 }
 
 void MyChartView::onQuickTrendClicked()
@@ -185,7 +324,24 @@ void MyChartView::onQuickTrendClicked()
     int maxNodes = 10000;
     int stepSize = 1000;
 
-    runDetailedTrendTest(minNodes, maxNodes, stepSize, 1);
+    HarnessConfig config;
+    config.warmupRuns = 0;
+    config.minRepeats = 1;
+    config.autoRepeat = false;
+    config.pinCpu = checkPinCpu->isChecked();
+
+    runDetailedTrendTest(minNodes, maxNodes, stepSize, config);
+}
+
+HarnessConfig MyChartView::harnessConfigFromUI(int repeatTimes) const
+{
+    HarnessConfig config;
+    config.warmupRuns = editWarmup->text().toInt();
+    config.minRepeats = repeatTimes;
+    config.maxRepeats = std::max(repeatTimes, 30);
+    config.autoRepeat = checkAutoRepeat->isChecked();
+    config.pinCpu = checkPinCpu->isChecked();
+    return config;
 }
 
 void MyChartView::runPerformanceTest(int n, TraversalClass traversalType)
@@ -199,6 +355,8 @@ void MyChartView::runPerformanceTest(int n, TraversalClass traversalType)
 
     QString traversalName = getTraversalTypeName(traversalType);
     textLog->append(QString("开始测试：%1，N=%2").arg(traversalName).arg(n));
+    textLog->append(describeTreeShape());
+    textLog->append(QString("计时: %1").arg(BenchClock::instance().name()));
     textLog->append("=======================================");
 
     // 根据遍历类型决定测试哪些算法
@@ -234,34 +392,86 @@ void MyChartView::runPerformanceTest(int n, TraversalClass traversalType)
         visitCount = 0;
 
         TraversalStats stats = performSingleAlgorithm(tree, traversalType, isRecursive);
-        times.append(stats.time_ms);
+        times.append(metricValue(stats.time_ns, n));
         maxStackDepths.append(stats.max_stack_depth);
         maxQueueLengths.append(stats.max_queue_length);
 
         // 输出结果
         QString result;
         if (traversalType == LEVEL) {
-            result = QString("%1: %2 ms | 访问节点: %3 | 最大队列长度: %4")
+            result = QString("%1: %2 | 访问节点: %3 | 最大队列长度: %4")
                          .arg(algorithmNames[i])
-                         .arg(stats.time_ms, 0, 'f', 2)
+                         .arg(formatTiming(stats.time_ns, n))
                          .arg(visitCount)
                          .arg(stats.max_queue_length);
         } else if (!isRecursive) {
-            result = QString("%1: %2 ms | 访问节点: %3 | 最大栈深: %4")
+            result = QString("%1: %2 | 访问节点: %3 | 最大栈深: %4")
                          .arg(algorithmNames[i])
-                         .arg(stats.time_ms, 0, 'f', 2)
+                         .arg(formatTiming(stats.time_ns, n))
                          .arg(visitCount)
                          .arg(stats.max_stack_depth);
         } else {
-            result = QString("%1: %2 ms | 访问节点: %3")
+            result = QString("%1: %2 | 访问节点: %3")
                          .arg(algorithmNames[i])
-                         .arg(stats.time_ms, 0, 'f', 2)
+                         .arg(formatTiming(stats.time_ns, n))
                          .arg(visitCount);
         }
+        result += QString(" | 额外内存: %1 字节").arg(stats.memory_usage);
 
         textLog->append(result);
     }
 
+    // 先序、中序另外测线索二叉树：无栈、不写树（建线索不计时）
+    if (traversalType == PRE || traversalType == IN) {
+        ThreadedBinaryTree<int> threaded(*tree);
+        visitCount = 0;
+        TraversalStats stats = threaded.Traversal(traversalType, visitValueForStats);
+        QString name = traversalType == PRE ? "先序线索" : "中序线索";
+        algorithmNames.append(name);
+        times.append(metricValue(stats.time_ns, n));
+        textLog->append(QString("%1: %2 | 访问节点: %3 | 额外内存: 0 字节（节点 %4 字节，与指针树相同）")
+                            .arg(name)
+                            .arg(formatTiming(stats.time_ns, n))
+                            .arg(visitCount)
+                            .arg(sizeof(ThreadedNode<int>)));
+    }
+
+    // 先序、中序、后序另外测带父指针的树：游标不用栈，代价是每个节点多一个指针（复制不计时）
+    if (traversalType != LEVEL) {
+        BinaryTree<int, ParentLink> linked;
+        linked.copyFrom(*tree);
+        visitCount = 0;
+        TraversalStats stats = linked.Traversal(traversalType, false, visitLinkedNodeForStats);
+        QString name = getTraversalTypeName(traversalType).left(2) + "父指针";
+        algorithmNames.append(name);
+        times.append(metricValue(stats.time_ns, n));
+        textLog->append(QString("%1: %2 | 访问节点: %3 | 最大栈深: 0 | 额外内存: %4 字节（节点 %5 字节，指针树 %6 字节）")
+                            .arg(name)
+                            .arg(formatTiming(stats.time_ns, n))
+                            .arg(visitCount)
+                            .arg(stats.memory_usage)
+                            .arg(sizeof(TreeNode<int, ParentLink>))
+                            .arg(sizeof(TreeNode<int>)));
+    }
+
+    // 自动模式：按校准表（没有时按经验规则）为这棵树选引擎
+    {
+        EngineCalibration& table = EngineCalibration::instance();
+        visitCount = 0;
+        TraversalStats stats = tree->Traversal(traversalType, ENGINE_AUTO, visitNodeForStats);
+        QString name = getTraversalTypeName(traversalType).left(2) + "自动";
+        algorithmNames.append(name);
+        times.append(metricValue(stats.time_ns, n));
+        textLog->append(QString("%1: %2 | 访问节点: %3 | 选用: %4（%5）| 额外内存: %6 字节")
+                            .arg(name)
+                            .arg(formatTiming(stats.time_ns, n))
+                            .arg(visitCount)
+                            .arg(engineName(stats.engine))
+                            .arg(table.size() ? QString("校准表 %1").arg(QString::fromStdString(table.source()))
+                                              : QString("未校准，经验规则"))
+                            .arg(stats.memory_usage));
+    }
+
     textLog->append("=======================================\n");
 
     // 更新图表（柱状图对比）
@@ -271,7 +481,7 @@ void MyChartView::runPerformanceTest(int n, TraversalClass traversalType)
     deleteTree(tree);
 }
 
-void MyChartView::runDetailedTrendTest(int minNodes, int maxNodes, int stepSize, int repeatTimes)
+void MyChartView::runDetailedTrendTest(int minNodes, int maxNodes, int stepSize, const HarnessConfig& config)
 {
     // 生成测试节点数序列
     QVector<int> testSizes;
@@ -290,21 +500,46 @@ void MyChartView::runDetailedTrendTest(int minNodes, int maxNodes, int stepSize,
     progress.setMinimumDuration(0);
     progress.setValue(0);
 
+    TreeReclaimer& reclaimer = TreeReclaimer::instance();
+    TreeReclaimStats reclaimedBefore = reclaimer.total();
+
+    // 测试期间绑定当前 CPU，结束时自动恢复
+    bench::CpuPinGuard pinGuard(config.pinCpu);
+
+    // 测试过程中切换指标不影响本次曲线
+    const int metric = comboTimeMetric->currentData().toInt();
+
     clearChart();
     textLog->append("开始详细统计趋势测试...");
-    textLog->append(QString("测试范围: %1 ~ %2 (步长: %3, 重复次数: %4)")
-                        .arg(minNodes).arg(maxNodes).arg(stepSize).arg(repeatTimes));
+    textLog->append(QString("测试范围: %1 ~ %2 (步长: %3, 重复次数: %4%5)")
+                        .arg(minNodes).arg(maxNodes).arg(stepSize).arg(config.minRepeats)
+                        .arg(config.autoRepeat ? QString("~%1 自动至稳定").arg(config.maxRepeats) : QString()));
+    textLog->append(QString("预热: %1 次 | 算法顺序: %2 | CPU: %3 | 计时: %4")
+                        .arg(config.warmupRuns)
+                        .arg(config.shuffleOrder ? "每轮随机" : "固定")
+                        .arg(pinGuard.cpu() >= 0 ? QString("绑定 #%1").arg(pinGuard.cpu()) : QString("未绑定"))
+                        .arg(BenchClock::instance().name()));
+    textLog->append(describeTreeShape());
     textLog->append("=======================================");
 
-    // 7种算法的配置
-    QStringList algorithmNames = {
-        "先序递归", "先序非递归",
-        "中序递归", "中序非递归",
-        "后序递归", "后序非递归",
-        "层序遍历"
-    };
-    QVector<TraversalClass> traversalTypes = {PRE, PRE, IN, IN, POST, POST, LEVEL};
-    QVector<bool> recursiveFlags = {true, false, true, false, true, false, false};
+    // 7种算法的配置（与命令行、结果库共用）
+    QStringList algorithmNames;
+    QVector<TraversalClass> traversalTypes;
+    QVector<bool> recursiveFlags;
+    for (const AlgorithmSpec& spec : bench::traversalAlgorithms()) {
+        algorithmNames << spec.name;
+        traversalTypes << spec.type;
+        recursiveFlags << spec.recursive;
+    }
+
+    // 本次测试记录
+    BenchRun run;
+    run.host = HostInfo::current();
+    run.id = bench::newRunId(run.host);
+    run.timestamp = QDateTime::currentDateTime().toString(Qt::ISODate);
+    run.treeShape = describeTreeShape();
+    run.harness = config;
+    run.unit = "ns";
     QColor colors[7] = {
         QColor(255, 0, 0), QColor(255, 100, 100),
         QColor(0, 255, 0), QColor(100, 255, 100),
@@ -312,9 +547,10 @@ void MyChartView::runDetailedTrendTest(int minNodes, int maxNodes, int stepSize,
         QColor(255, 165, 0)
     };
 
-    // 初始化 Series
+    // 初始化 Series：主折线为中位数，上下边界为中位数的 95% 置信区间
     QVector<QLineSeries*> allSeries;
-    QVector<QLineSeries*> errorSeries;
+    QVector<QLineSeries*> ciUpperSeries;
+    QVector<QLineSeries*> ciLowerSeries;
     QVector<QVector<double>> allTimes(7);
     QVector<QVector<double>> allStackDepths(7);
     QVector<QVector<double>> allQueueLengths(7);
@@ -325,11 +561,14 @@ void MyChartView::runDetailedTrendTest(int minNodes, int maxNodes, int stepSize,
         series->setColor(colors[i]);
         allSeries.append(series);
 
-        QLineSeries *errorSeriesItem = new QLineSeries();
-        errorSeriesItem->setName(algorithmNames[i] + " 误差范围");
-        errorSeriesItem->setColor(colors[i].lighter(150));
-        errorSeriesItem->setOpacity(0.3);
-        errorSeries.append(errorSeriesItem);
+        QLineSeries *upper = new QLineSeries();
+        upper->setName(algorithmNames[i] + " 95% 置信区间");
+        upper->setColor(colors[i].lighter(150));
+        ciUpperSeries.append(upper);
+
+        QLineSeries *lower = new QLineSeries();
+        lower->setColor(colors[i].lighter(150));
+        ciLowerSeries.append(lower);
     }
 
     // --- 主测试循环 ---
@@ -340,7 +579,13 @@ void MyChartView::runDetailedTrendTest(int minNodes, int maxNodes, int stepSize,
 
         // 【优化关键点 1】: 在重复测试循环之外创建树，复用数据结构
         // 极大地减少了 new/delete 的开销，解决了“速度慢”的问题
+        // 并行建树时暂时解除绑核，否则建树线程都会挤在同一个 CPU 上
+        pinGuard.suspend();
         BinaryTree<int>* tree = createBigTree(n);
+        pinGuard.resume();
+
+        // 上一规模的树与建树并行回收；计时前等回收结束，避免干扰测量
+        reclaimer.waitIdle();
 
         // 【优化关键点 2】: 检查树是否创建成功，防止空树导致曲线掉落
         if (!tree) {
@@ -348,71 +593,77 @@ void MyChartView::runDetailedTrendTest(int minNodes, int maxNodes, int stepSize,
             continue;
         }
 
-        // 存储当前规模下，7种算法每次重复的数据
-        QVector<QVector<double>> currentSizeTimes(7);
-        QVector<size_t> currentAvgStack(7, 0);
-        QVector<size_t> currentAvgQueue(7, 0);
-
-        // 重复测试
-        for (int repeat = 0; repeat < repeatTimes; repeat++) {
-            for (int alg = 0; alg < 7; alg++) {
-                visitCount = 0; // 重置计数器
-
-                // 执行算法
-                TraversalStats stats = performSingleAlgorithm(tree, traversalTypes[alg], recursiveFlags[alg]);
-
-                // 记录数据
-                currentSizeTimes[alg].append(stats.time_ms);
-
-                // 累加空间占用数据（只需统计总和，最后取平均）
-                if (traversalTypes[alg] == LEVEL) {
-                    currentAvgQueue[alg] += stats.max_queue_length;
-                } else if (!recursiveFlags[alg]) {
-                    currentAvgStack[alg] += stats.max_stack_depth;
-                }
+        // 空间占用数据（预热轮不计入）
+        QVector<size_t> sumStack(7, 0);
+        QVector<size_t> sumQueue(7, 0);
+        QVector<int> runCount(7, 0);
+        int warmupLeft = config.warmupRuns * 7;
+
+        // 交错、随机顺序地重复测试，直到结果稳定
+        std::vector<SampleSummary> summaries = bench::runInterleaved(7, [&](int alg) {
+            visitCount = 0; // 重置计数器
+
+            // 执行算法
+            TraversalStats stats = performSingleAlgorithm(tree, traversalTypes[alg], recursiveFlags[alg]);
+
+            if (warmupLeft > 0) {
+                warmupLeft--;
+            } else {
+                runCount[alg]++;
+                sumQueue[alg] += stats.max_queue_length;
+                sumStack[alg] += stats.max_stack_depth;
             }
-        }
+            return stats.time_ns;
+        }, config, [&]() {
+            QCoreApplication::processEvents(); // 保持界面不卡死
+            return progress.wasCanceled();
+        });
 
         // 【优化关键点 3】: 测试完当前规模的所有重复次数后，再销毁树
         deleteTree(tree);
 
         // --- 数据处理与绘图 ---
         for (int alg = 0; alg < 7; alg++) {
-            if (currentSizeTimes[alg].isEmpty()) continue;
-
-            // 1. 计算平均时间
-            double sumTime = 0;
-            for (double t : currentSizeTimes[alg]) sumTime += t;
-            double avgTime = sumTime / currentSizeTimes[alg].size();
-
-            // 2. 计算标准差
-            double stdDev = 0;
-            for (double t : currentSizeTimes[alg]) stdDev += std::pow(t - avgTime, 2);
-            stdDev = std::sqrt(stdDev / currentSizeTimes[alg].size());
-
-            // 3. 记录到全局数据
-            allTimes[alg].append(avgTime);
-            allSeries[alg]->append(n, avgTime);
-            errorSeries[alg]->append(n, avgTime - stdDev);
-            errorSeries[alg]->append(n, avgTime + stdDev);
-
-            // 4. 处理空间复杂度数据
+            const SampleSummary& summary = summaries[alg];
+            if (summary.samples.empty()) continue;
+
+            // 1. 记录中位数与置信区间
+            BenchRecord record;
+            record.algorithm = algorithmNames[alg];
+            record.n = n;
+            record.summary = summary;
+            run.records.append(record);
+
+            // 吞吐量是时间的倒数，置信区间上下界互换
+            double lo = metricValue(summary.ciLow, n, metric);
+            double hi = metricValue(summary.ciHigh, n, metric);
+            allTimes[alg].append(summary.median / 1e6);
+            allSeries[alg]->append(n, metricValue(summary.median, n, metric));
+            ciUpperSeries[alg]->append(n, std::max(lo, hi));
+            ciLowerSeries[alg]->append(n, std::min(lo, hi));
+
+            // 2. 处理空间复杂度数据
             QString extraInfo = "";
             if (traversalTypes[alg] == LEVEL) {
-                size_t avgQ = currentAvgQueue[alg] / repeatTimes;
+                size_t avgQ = sumQueue[alg] / std::max(1, runCount[alg]);
                 allQueueLengths[alg].append(avgQ);
                 extraInfo = QString(" | Q: %1").arg(avgQ);
             } else if (!recursiveFlags[alg]) {
-                size_t avgS = currentAvgStack[alg] / repeatTimes;
+                size_t avgS = sumStack[alg] / std::max(1, runCount[alg]);
                 allStackDepths[alg].append(avgS);
                 extraInfo = QString(" | S: %1").arg(avgS);
             }
 
             // 输出简略日志 (避免刷屏)
             if (alg == 0 || alg == 6) { // 只打印第一个和最后一个作为进度提示
-                textLog->append(QString("  -> %1: Avg %2 ms%3")
+                textLog->append(QString("  -> %1: 中位数 %2 | CI [%3, %4] ns | MAD %5 ns | 样本 %6 (剔除 %7)%8")
                                     .arg(algorithmNames[alg])
-                                    .arg(avgTime, 0, 'f', 2)
+                                    .arg(formatTiming(summary.median, n))
+                                    .arg(summary.ciLow, 0, 'f', 0)
+                                    .arg(summary.ciHigh, 0, 'f', 0)
+                                    .arg(summary.mad, 0, 'f', 0)
+                                    .arg(summary.samples.size())
+                                    .arg(summary.rejected)
                                     .arg(extraInfo));
             }
         }
@@ -424,19 +675,1210 @@ void MyChartView::runDetailedTrendTest(int minNodes, int maxNodes, int stepSize,
 
     progress.close();
 
+    reclaimer.waitIdle();
+    TreeReclaimStats reclaimed = reclaimer.total();
+    textLog->append(QString("后台回收: %1 个节点，共 %2 ms（不阻塞界面，也不计入遍历时间）")
+                        .arg(reclaimed.nodes - reclaimedBefore.nodes)
+                        .arg(reclaimed.ms - reclaimedBefore.ms, 0, 'f', 1));
+
     if (allSeries[0]->count() > 0) {
-        updateDetailedTrendChart("遍历算法性能详细统计", allSeries, errorSeries,
-                                 testSizes, algorithmNames, allTimes);
+        updateDetailedTrendChart("遍历算法性能详细统计（中位数与 95% 置信区间）", allSeries,
+                                 ciUpperSeries, ciLowerSeries,
+                                 testSizes, algorithmNames);
         displayStatisticsSummary(testSizes, algorithmNames, allTimes,
                                  allStackDepths, allQueueLengths);
         textLog->append("\n详细统计测试完成！");
+
+        lastRun = run;
+        lastRunMetric = metric;
+        if (checkSaveResults->isChecked()) {
+            QString message;
+            BenchStore store;
+            if (store.save(run, &message)) {
+                textLog->append(QString("结果已保存: %1 (%2)").arg(run.id, store.directory()));
+            } else {
+                textLog->append("保存结果失败: " + message);
+            }
+        }
     } else {
+        qDeleteAll(allSeries);
+        qDeleteAll(ciUpperSeries);
+        qDeleteAll(ciLowerSeries);
         textLog->append("\n测试未产生有效数据。");
     }
 
     lblStatsInfo->setText("测试结束");
 }
 
+// 二进制树文件：写出后比较三种启动方式，再比较就地遍历与指针树遍历
+void MyChartView::onBinaryFileClicked()
+{
+    int n = editDataSize->text().toInt();
+    if (n <= 0) {
+        QMessageBox::warning(this, "输入错误", "请输入有效的节点数");
+        return;
+    }
+
+    const BenchClock& clock = BenchClock::instance();
+    QString path = QDir::temp().filePath(QString("bintree_%1.btf").arg(n));
+    std::string error;
+
+    textLog->append(QString("二进制文件加载对比：N=%1").arg(n));
+    textLog->append(describeTreeShape());
+    textLog->append("=======================================");
+
+    // 1. 重建：逐个 new 节点（即现在每次启动的做法）
+    uint64_t t0 = clock.now();
+    BinaryTree<int>* tree = createBigTree(n);
+    double buildNs = clock.elapsedNs(t0, clock.now());
+
+    // 2. 写出文件
+    t0 = clock.now();
+    bool saved = treefile::save(*tree, path.toStdString(), &error);
+    double writeNs = clock.elapsedNs(t0, clock.now());
+    if (!saved) {
+        textLog->append("写出失败：" + QString::fromStdString(error));
+        deleteTree(tree);
+        return;
+    }
+    double fileMB = QFileInfo(path).size() / 1048576.0;
+    textLog->append(QString("写出: %1 MB, %2 ms, %3 MB/s")
+                        .arg(fileMB, 0, 'f', 1)
+                        .arg(writeNs / 1e6, 0, 'f', 2)
+                        .arg(writeNs > 0 ? fileMB * 1e9 / writeNs : 0.0, 0, 'f', 0));
+
+    // 3. 读文件并重建指针树
+    t0 = clock.now();
+    MappedTreeFile<int> file;
+    BinaryTree<int> rebuilt;
+    if (file.open(path.toStdString(), true, &error)) treefile::rebuild(file.view(), rebuilt);
+    double rebuildNs = clock.elapsedNs(t0, clock.now());
+    file.close();
+
+    // 4. mmap 打开并校验全部内容
+    t0 = clock.now();
+    bool opened = file.open(path.toStdString(), true, &error);
+    double mapVerifyNs = clock.elapsedNs(t0, clock.now());
+    file.close();
+
+    // 5. mmap 打开，只检查文件头和链接（节点数据按需换页）
+    t0 = clock.now();
+    opened = opened && file.open(path.toStdString(), false, &error);
+    double mapNs = clock.elapsedNs(t0, clock.now());
+
+    if (!opened) {
+        textLog->append("打开失败：" + QString::fromStdString(error));
+        deleteTree(tree);
+        return;
+    }
+
+    // 6. 从内存中已有的树做快照（多线程深拷贝到一个节点区）
+    TreeBuildStats cloneStats;
+    BinaryTree<int> snapshot = tree->clone(0, &cloneStats);
+    textLog->append(QString("内存快照: %1 线程, %2 百万节点/秒")
+                        .arg(cloneStats.threads)
+                        .arg(cloneStats.nodesPerSec() / 1e6, 0, 'f', 1));
+    snapshot.clearInBackground();
+
+    QVector<QString> names = {"创建节点", "读文件+重建", "mmap+校验", "mmap", "内存快照"};
+    QVector<double> times = {buildNs / 1e6, rebuildNs / 1e6, mapVerifyNs / 1e6, mapNs / 1e6, cloneStats.ms};
+    for (int i = 0; i < names.size(); i++) {
+        textLog->append(QString("%1: %2 ms (%3x)")
+                            .arg(names[i], -8)
+                            .arg(times[i], 0, 'f', 3)
+                            .arg(times[i] > 0 ? times[0] / times[i] : 0.0, 0, 'f', 1));
+    }
+    textLog->append("注：文件刚写出，位于页缓存中，mmap 时间为热启动");
+
+    // 就地遍历与指针树遍历对比
+    visitCount = 0;
+    TraversalStats pointerStats = tree->Traversal(PRE, false, visitNodeForStats);
+    visitCount = 0;
+    TraversalStats mappedStats = file.view().Traversal(PRE, false, visitValueForStats);
+    textLog->append(QString("先序非递归（指针树）: %1").arg(formatTiming(pointerStats.time_ns, n)));
+    textLog->append(QString("先序非递归（mmap 就地）: %1 | 访问节点: %2")
+                        .arg(formatTiming(mappedStats.time_ns, n)).arg(visitCount));
+    textLog->append("=======================================\n");
+
+    updateBarChart("启动方式", names, times, n, "启动时间 (ms)");
+
+    deleteTree(tree);
+    file.close();
+    QFile::remove(path);
+}
+
+// 加载 CSV 边表，报告各阶段耗时与吞吐，然后在加载的树上运行全部遍历算法
+void MyChartView::onLoadCsvClicked()
+{
+    QString path = QFileDialog::getOpenFileName(this, "加载 CSV 树", QString(), "CSV 文件 (*.csv *.txt);;所有文件 (*)");
+    if (path.isEmpty()) return;
+
+    // 进度回调在本线程上触发，可直接更新界面
+    QProgressDialog progress("正在解析 " + QFileInfo(path).fileName() + "...", QString(), 0, 1000, this);
+    progress.setWindowModality(Qt::WindowModal);
+    progress.setMinimumDuration(300);
+    QElapsedTimer elapsed;
+    elapsed.start();
+    auto onProgress = [&](size_t done, size_t total) {
+        double mb = done / 1048576.0;
+        progress.setValue(total ? static_cast<int>(done * 1000 / total) : 1000);
+        progress.setLabelText(QString("正在解析: %1 / %2 MB (%3 MB/s)")
+                                  .arg(mb, 0, 'f', 0)
+                                  .arg(total / 1048576.0, 0, 'f', 0)
+                                  .arg(elapsed.elapsed() > 0 ? mb * 1000.0 / elapsed.elapsed() : 0.0, 0, 'f', 0));
+        QCoreApplication::processEvents();
+    };
+
+    BinaryTree<int> tree;
+    CsvTreeData info;
+    std::string error;
+    bool ok = tree.loadFromCSV(path.toStdString(), &error, &info, 0, onProgress);
+    progress.setValue(1000);
+    if (!ok) {
+        QMessageBox::warning(this, "加载失败", QString::fromStdString(error));
+        return;
+    }
+
+    int n = static_cast<int>(info.nodeCount);
+    int height = tree.height();
+    textLog->append(QString("CSV 加载：%1").arg(path));
+    textLog->append(QString("节点: %1 | 高度: %2 | 文件: %3 MB | 线程: %4")
+                        .arg(n).arg(height).arg(info.bytes / 1048576.0, 0, 'f', 1).arg(info.threads));
+    textLog->append(QString("解析 %1 ms + 解析 id %2 ms + 校验 %3 ms = %4 ms, %5 MB/s")
+                        .arg(info.parseMs, 0, 'f', 1)
+                        .arg(info.resolveMs, 0, 'f', 1)
+                        .arg(info.validateMs, 0, 'f', 1)
+                        .arg(info.totalMs(), 0, 'f', 1)
+                        .arg(info.mbPerSec(), 0, 'f', 0));
+    textLog->append("=======================================");
+
+    // 很深的树用递归遍历会栈溢出，只测非递归算法
+    const int maxRecursiveHeight = 10000;
+    QVector<QString> names;
+    QVector<double> values;
+    for (const AlgorithmSpec& alg : bench::traversalAlgorithms()) {
+        if (alg.recursive && height > maxRecursiveHeight) {
+            textLog->append(QString("%1: 跳过（高度超过 %2）").arg(alg.name).arg(maxRecursiveHeight));
+            continue;
+        }
+        visitCount = 0;
+        TraversalStats stats = tree.Traversal(alg.type, alg.recursive, visitNodeForStats);
+        names.append(alg.name);
+        values.append(metricValue(stats.time_ns, n));
+        textLog->append(QString("%1: %2 | 访问节点: %3").arg(alg.name).arg(formatTiming(stats.time_ns, n)).arg(visitCount));
+    }
+    textLog->append("=======================================\n");
+
+    updateBarChart(QFileInfo(path).fileName(), names, values, n);
+}
+
+// 流式序列化：各遍历顺序写盘的吞吐，以及由带空标记的先序编码一遍重建树
+void MyChartView::onStreamClicked()
+{
+    int n = editDataSize->text().toInt();
+    if (n <= 0) {
+        QMessageBox::warning(this, "输入错误", "请输入有效的节点数");
+        return;
+    }
+
+    BinaryTree<int>* tree = createBigTree(n);
+    QString path = QDir::temp().filePath(QString("bintree_%1.bts").arg(n));
+    std::string error;
+
+    textLog->append(QString("流式序列化：N=%1，块大小 %2 MB x 2").arg(n).arg(treestream::kDefaultBlockSize >> 20));
+    textLog->append(describeTreeShape());
+    textLog->append("=======================================");
+
+    QVector<QString> names;
+    QVector<double> rates;
+    auto report = [&](const QString& name, const StreamStats& s) {
+        names.append(name);
+        rates.append(s.mbPerSec());
+        textLog->append(QString("%1: %2 MB, %3 ms, %4 MB/s, %5 块, 等待后台 %6 ms")
+                            .arg(name, -10)
+                            .arg(s.bytes / 1048576.0, 0, 'f', 1)
+                            .arg(s.totalNs / 1e6, 0, 'f', 2)
+                            .arg(s.mbPerSec(), 0, 'f', 0)
+                            .arg(s.blocks)
+                            .arg(s.stallNs / 1e6, 0, 'f', 2));
+    };
+
+    const TraversalClass kinds[] = {PRE, IN, POST, LEVEL};
+    const char* kindNames[] = {"先序序列", "中序序列", "后序序列", "层序序列"};
+    for (int i = 0; i < 4; i++) {
+        StreamStats stats;
+        if (!treestream::writeSequence(*tree, kinds[i], path.toStdString(), &stats, &error)) {
+            textLog->append("写出失败：" + QString::fromStdString(error));
+            deleteTree(tree);
+            QFile::remove(path);
+            return;
+        }
+        report(kindNames[i], stats);
+    }
+
+    StreamStats writeStats;
+    StreamStats readStats;
+    BinaryTree<int> rebuilt;
+    bool ok = treestream::writePreorderWithNulls(*tree, path.toStdString(), &writeStats, &error)
+              && treestream::readPreorderWithNulls(path.toStdString(), rebuilt, &readStats, &error);
+    if (!ok) {
+        textLog->append("空标记编码失败：" + QString::fromStdString(error));
+        deleteTree(tree);
+        QFile::remove(path);
+        return;
+    }
+    report("空标记先序写", writeStats);
+    report("空标记先序读", readStats);
+    textLog->append(QString("重建: %1 个节点（原树 %2），最大栈深 %3，树高 %4")
+                        .arg(rebuilt.countNodes()).arg(tree->countNodes())
+                        .arg(readStats.maxStackDepth).arg(tree->height()));
+    textLog->append("=======================================\n");
+
+    updateBarChart("流式序列化", names, rates, n, "吞吐 (MB/s)");
+
+    deleteTree(tree);
+    QFile::remove(path);
+}
+
+// 简洁编码与指针树对比：内存占用与四种遍历的每节点耗时（非递归，中位数）
+void MyChartView::onSuccinctClicked()
+{
+    int n = editDataSize->text().toInt();
+    if (n <= 0) {
+        QMessageBox::warning(this, "输入错误", "请输入有效的节点数");
+        return;
+    }
+
+    BinaryTree<int>* tree = createBigTree(n);
+    const BenchClock& clock = BenchClock::instance();
+    uint64_t t0 = clock.now();
+    SuccinctTree<int> succinct(*tree);
+    double buildNs = clock.elapsedNs(t0, clock.now());
+
+    // glibc 每次分配带 8 字节头并按 16 字节对齐
+    size_t nodeBytes = sizeof(TreeNode<int>);
+    size_t heapNodeBytes = std::max<size_t>(32, (nodeBytes + 8 + 15) / 16 * 16);
+    double pointerMB = double(heapNodeBytes) * n / 1048576.0;
+    double succinctMB = succinct.memoryBytes() / 1048576.0;
+
+    textLog->append(QString("简洁编码对比：N=%1").arg(n));
+    textLog->append(describeTreeShape());
+    textLog->append("=======================================");
+    textLog->append(QString("指针树: %1 MB（每节点 %2 字节，含分配器开销约 %3 字节）")
+                        .arg(pointerMB, 0, 'f', 2).arg(nodeBytes).arg(heapNodeBytes));
+    textLog->append(QString("简洁编码: %1 MB（结构 %2 位/节点 + 数据 %3 字节/节点），构建 %4 ms")
+                        .arg(succinctMB, 0, 'f', 2)
+                        .arg(succinct.bitsPerNode(), 0, 'f', 2)
+                        .arg(sizeof(int))
+                        .arg(buildNs / 1e6, 0, 'f', 2));
+    textLog->append(QString("内存比: %1x").arg(succinctMB > 0 ? pointerMB / succinctMB : 0.0, 0, 'f', 1));
+
+    HarnessConfig config = harnessConfigFromUI(std::max(1, editRepeatTimes->text().toInt()));
+    bench::CpuPinGuard pinGuard(config.pinCpu);
+    const TraversalClass kinds[] = {PRE, IN, POST, LEVEL};
+    std::vector<SampleSummary> summaries = bench::runInterleaved(8, [&](int alg) {
+        TraversalClass kind = kinds[alg / 2];
+        return alg % 2 == 0 ? tree->Traversal(kind, false, visitNodeForStats).time_ns
+                            : succinct.Traversal(kind, false, visitValueForStats).time_ns;
+    }, config);
+
+    QVector<QString> names;
+    QVector<double> values;
+    for (int alg = 0; alg < 8; alg++) {
+        QString name = QString("%1%2").arg(alg % 2 == 0 ? "指针" : "简洁").arg(getTraversalTypeName(kinds[alg / 2]));
+        names.append(name);
+        values.append(metricValue(summaries[alg].median, n));
+        textLog->append(QString("%1: %2").arg(name, -8).arg(formatTiming(summaries[alg].median, n)));
+    }
+    textLog->append("=======================================\n");
+
+    updateBarChart("指针树 vs 简洁编码", names, values, n);
+    deleteTree(tree);
+}
+
+// 批量访问对比用的逐节点计算：整数混合哈希后累加（相当于给树算指纹）
+static inline uint32_t nodeWork(int value)
+{
+    uint32_t h = static_cast<uint32_t>(value) * 0x9E3779B1u;
+    h ^= h >> 15;
+    h *= 0x85EBCA77u;
+    h ^= h >> 13;
+    return h;
+}
+
+static uint32_t workSum = 0;
+
+static void workOnNode(TreeNode<int>* node)
+{
+    workSum += nodeWork(node->data);
+}
+
+static void workOnValue(const int& value)
+{
+    workSum += nodeWork(value);
+}
+
+// 逐节点回调与按批回调做同样的计算：批内是连续的 int，循环可以被向量化
+void MyChartView::onBatchClicked()
+{
+    int n = editDataSize->text().toInt();
+    size_t batchSize = static_cast<size_t>(editBatchSize->text().toInt());
+    if (n <= 0 || batchSize == 0) {
+        QMessageBox::warning(this, "输入错误", "请输入有效的节点数和批大小");
+        return;
+    }
+    TraversalClass kind = static_cast<TraversalClass>(comboTraversalType->currentData().toInt());
+
+    BinaryTree<int>* tree = createBigTree(n);
+    std::vector<TreeLink> links;
+    std::vector<int> payload;
+    treefile::flatten(tree->getRoot(), links, payload);
+    FlatTreeView<int> flat(links.data(), payload.data(), links.size());
+    SuccinctTree<int> succinct(*tree);
+
+    auto batchNodes = [](VisitSpan<const TreeNode<int>*> batch) {
+        uint32_t sum = 0;
+        for (const TreeNode<int>* node : batch) sum += nodeWork(node->data);
+        workSum += sum;
+    };
+    auto batchValues = [](VisitSpan<int> batch) {
+        uint32_t sum = 0;
+        for (size_t i = 0; i < batch.size; i++) sum += nodeWork(batch[i]);
+        workSum += sum;
+    };
+
+    textLog->append(QString("批量访问对比：%1，N=%2，批大小 %3%4")
+                        .arg(getTraversalTypeName(kind)).arg(n).arg(batchSize)
+                        .arg(kind == LEVEL ? "（层序按整层交付）" : ""));
+    textLog->append(describeTreeShape());
+    textLog->append("=======================================");
+
+    // 每种布局逐节点、按批交替采样；同时检查两种方式算出的指纹相同
+    const int algCount = 6;
+    uint32_t sums[algCount] = {0};
+    HarnessConfig config = harnessConfigFromUI(std::max(1, editRepeatTimes->text().toInt()));
+    bench::CpuPinGuard pinGuard(config.pinCpu);
+    std::vector<SampleSummary> summaries = bench::runInterleaved(algCount, [&](int alg) {
+        workSum = 0;
+        double ns = 0.0;
+        switch (alg) {
+        case 0: ns = tree->Traversal(kind, false, workOnNode).time_ns; break;
+        case 1: ns = tree->BatchTraversal(kind, batchSize, batchNodes).time_ns; break;
+        case 2: ns = flat.Traversal(kind, false, workOnValue).time_ns; break;
+        case 3: ns = flat.BatchTraversal(kind, batchSize, batchValues).time_ns; break;
+        case 4: ns = succinct.Traversal(kind, false, workOnValue).time_ns; break;
+        case 5: ns = succinct.BatchTraversal(kind, batchSize, batchValues).time_ns; break;
+        }
+        sums[alg] = workSum;
+        return ns;
+    }, config);
+
+    const char* layouts[] = {"指针树", "下标视图", "简洁编码"};
+    QVector<QString> names;
+    QVector<double> values;
+    for (int alg = 0; alg < algCount; alg++) {
+        QString name = QString("%1%2").arg(layouts[alg / 2]).arg(alg % 2 == 0 ? "逐节点" : "按批");
+        names.append(name);
+        values.append(metricValue(summaries[alg].median, n));
+        QString line = QString("%1: %2").arg(name, -8).arg(formatTiming(summaries[alg].median, n));
+        if (alg % 2 == 1 && summaries[alg].median > 0.0) {
+            line += QString(" | 加速 %1x").arg(summaries[alg - 1].median / summaries[alg].median, 0, 'f', 2);
+        }
+        textLog->append(line);
+    }
+    bool consistent = std::all_of(sums + 1, sums + algCount, [&](uint32_t s) { return s == sums[0]; });
+    textLog->append(QString("指纹 %1 %2").arg(sums[0], 8, 16, QChar('0')).arg(consistent ? "一致" : "不一致！"));
+    textLog->append("=======================================\n");
+
+    updateBarChart("逐节点回调 vs 按批回调", names, values, n);
+    deleteTree(tree);
+}
+
+// 回调方式的聚合：每个节点调用一次，逐个累加
+static ValueAggregate callbackAggregate;
+static int32_t callbackThreshold = 0;
+
+static void aggregateOnNode(TreeNode<int>* node)
+{
+    int32_t v = node->data;
+    callbackAggregate.sum += v;
+    callbackAggregate.min = std::min(callbackAggregate.min, v);
+    callbackAggregate.max = std::max(callbackAggregate.max, v);
+    callbackAggregate.countAbove += v > callbackThreshold;
+    callbackAggregate.count++;
+}
+
+// 整树与逐层聚合：回调累加 vs 连续数组上的各 SIMD 内核 vs 指针树按批 gather
+void MyChartView::onAggregateClicked()
+{
+    int n = editDataSize->text().toInt();
+    if (n <= 0) {
+        QMessageBox::warning(this, "输入错误", "请输入有效的节点数");
+        return;
+    }
+
+    BinaryTree<int>* tree = createBigTree(n);
+    std::vector<TreeLink> links;
+    std::vector<int> payload;
+    treefile::flatten(tree->getRoot(), links, payload);
+    FlatTreeView<int> flat(links.data(), payload.data(), links.size());
+    SuccinctTree<int> succinct(*tree);
+    callbackThreshold = n / 2;
+
+    // 只列出本机支持的内核
+    struct Variant {
+        QString name;
+        std::function<ValueAggregate()> run;
+    };
+    std::vector<Variant> variants;
+    variants.push_back({"回调累加", [&]() {
+        callbackAggregate = ValueAggregate();
+        tree->Traversal(PRE, false, aggregateOnNode);
+        return callbackAggregate;
+    }});
+    variants.push_back({QString("指针 gather %1").arg(treeagg::kernelName(treeagg::bestKernel())), [&]() {
+        return treeagg::aggregateTree(*tree, callbackThreshold);
+    }});
+    for (treeagg::Kernel kernel : {treeagg::KERNEL_SCALAR, treeagg::KERNEL_SSE41, treeagg::KERNEL_AVX2}) {
+        if (!treeagg::kernelSupported(kernel)) continue;
+        variants.push_back({QString("连续数组 %1").arg(treeagg::kernelName(kernel)), [&, kernel]() {
+            return treeagg::aggregateTree(flat, callbackThreshold, kernel);
+        }});
+    }
+    std::vector<ValueAggregate> pointerLevels;
+    std::vector<ValueAggregate> succinctLevels;
+    variants.push_back({"指针逐层", [&]() {
+        pointerLevels = treeagg::aggregateLevels(*tree, callbackThreshold);
+        ValueAggregate total;
+        for (const ValueAggregate& level : pointerLevels) total.merge(level);
+        return total;
+    }});
+    variants.push_back({"简洁编码逐层", [&]() {
+        succinctLevels = treeagg::aggregateLevels(succinct, callbackThreshold);
+        ValueAggregate total;
+        for (const ValueAggregate& level : succinctLevels) total.merge(level);
+        return total;
+    }});
+
+    textLog->append(QString("SIMD 聚合对比：N=%1，阈值 %2，运行时选择 %3")
+                        .arg(n).arg(callbackThreshold).arg(treeagg::kernelName(treeagg::bestKernel())));
+    textLog->append(describeTreeShape());
+    textLog->append("=======================================");
+
+    const BenchClock& clock = BenchClock::instance();
+    std::vector<ValueAggregate> results(variants.size());
+    HarnessConfig config = harnessConfigFromUI(std::max(1, editRepeatTimes->text().toInt()));
+    bench::CpuPinGuard pinGuard(config.pinCpu);
+    std::vector<SampleSummary> summaries = bench::runInterleaved(static_cast<int>(variants.size()), [&](int alg) {
+        uint64_t start = clock.now();
+        results[alg] = variants[alg].run();
+        return clock.elapsedNs(start, clock.now());
+    }, config);
+
+    QVector<QString> names;
+    QVector<double> values;
+    for (size_t alg = 0; alg < variants.size(); alg++) {
+        names.append(variants[alg].name);
+        values.append(metricValue(summaries[alg].median, n));
+        QString line = QString("%1: %2").arg(variants[alg].name, -12).arg(formatTiming(summaries[alg].median, n));
+        if (alg > 0 && summaries[alg].median > 0.0) {
+            line += QString(" | 相对回调 %1x").arg(summaries[0].median / summaries[alg].median, 0, 'f', 2);
+        }
+        if (!(results[alg] == results[0])) line += " | 结果不一致！";
+        textLog->append(line);
+    }
+
+    const ValueAggregate& total = results[0];
+    textLog->append(QString("和 %1，最小 %2，最大 %3，均值 %4，大于阈值 %5 个")
+                        .arg(total.sum).arg(total.min).arg(total.max)
+                        .arg(total.mean(), 0, 'f', 1).arg(total.countAbove));
+    textLog->append(QString("共 %1 层，两种逐层结果%2；最深一层 %3 个节点，和 %4")
+                        .arg(pointerLevels.size())
+                        .arg(pointerLevels == succinctLevels ? "一致" : "不一致！")
+                        .arg(pointerLevels.empty() ? 0 : pointerLevels.back().count)
+                        .arg(pointerLevels.empty() ? 0 : pointerLevels.back().sum));
+    textLog->append("=======================================\n");
+
+    updateBarChart("回调 vs SIMD 聚合", names, values, n);
+    deleteTree(tree);
+}
+
+// 持久化版本的值之和：用于确认旧版本在后续更新后保持不变
+static int64_t versionValueSum = 0;
+
+static void sumVersionValue(const int& value)
+{
+    versionValueSum += value;
+}
+
+// 结构共享的持久化版本 vs 整棵 clone()：快照、单次更新与保留多个版本的内存
+void MyChartView::onPersistentClicked()
+{
+    int n = editDataSize->text().toInt();
+    if (n <= 0) {
+        QMessageBox::warning(this, "输入错误", "请输入有效的节点数");
+        return;
+    }
+    const int updates = 1000;
+
+    BinaryTree<int>* tree = createBigTree(n);
+    const BenchClock& clock = BenchClock::instance();
+
+    textLog->append(QString("持久化版本对比：N=%1，连续 %2 次更新").arg(n).arg(updates));
+    textLog->append(describeTreeShape());
+    textLog->append("=======================================");
+
+    uint64_t start = clock.now();
+    PersistentTree<int> base(*tree);
+    textLog->append(QString("转为持久化版本: %1 ms").arg(clock.elapsedNs(start, clock.now()) / 1e6, 0, 'f', 2));
+
+    // 快照：复制版本句柄（只加根的引用计数） vs 整棵复制
+    const int snapshots = 100000;
+    std::vector<PersistentTree<int>> handles;
+    handles.reserve(snapshots);
+    start = clock.now();
+    for (int i = 0; i < snapshots; i++) handles.push_back(base);
+    double snapshotNs = clock.elapsedNs(start, clock.now()) / snapshots;
+    handles.clear();
+
+    TreeBuildStats cloneStats;
+    BinaryTree<int> copy = tree->clone(0, &cloneStats);
+    textLog->append(QString("快照: 持久化 %1 ns | clone() %2 ms（%3 线程）| 相差 %4x")
+                        .arg(snapshotNs, 0, 'f', 1)
+                        .arg(cloneStats.ms, 0, 'f', 2).arg(cloneStats.threads)
+                        .arg(snapshotNs > 0.0 ? cloneStats.ms * 1e6 / snapshotNs : 0.0, 0, 'f', 0));
+
+    // 更新：每次沿随机路径走到叶子并改值，旧版本全部保留
+    std::vector<TreePath> paths(updates);
+    uint64_t seed = kRandomShapeSeed;
+    for (TreePath& path : paths) {
+        const TreeNode<int>* node = tree->getRoot();
+        while (node && (node->left || node->right)) {
+            seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+            bool right = node->right && (!node->left || (seed >> 63));
+            path.push_back(right);
+            node = right ? node->right : node->left;
+        }
+    }
+    std::vector<PersistentTree<int>> versions;
+    versions.reserve(updates + 1);
+    versions.push_back(base);
+    size_t pathNodes = 0;
+    start = clock.now();
+    for (int i = 0; i < updates; i++) {
+        versions.push_back(versions.back().withValue(paths[i], -i));
+        pathNodes += paths[i].size() + 1;
+    }
+    double updateNs = clock.elapsedNs(start, clock.now()) / updates;
+    textLog->append(QString("单次更新: 持久化 %1 ns（平均复制 %2 个节点）| 复制后修改 ≈ %3 ms")
+                        .arg(updateNs, 0, 'f', 1)
+                        .arg(static_cast<double>(pathNodes) / updates, 0, 'f', 1)
+                        .arg(cloneStats.ms, 0, 'f', 2));
+
+    // 内存：共享节点只算一次；整棵复制按每个版本一份估算
+    size_t distinct = PersistentTree<int>::distinctNodes(versions);
+    double sharedMb = distinct * sizeof(PersistentNode<int>) / 1048576.0;
+    double clonedMb = static_cast<double>(versions.size()) * n * sizeof(TreeNode<int>) / 1048576.0;
+    textLog->append(QString("保留 %1 个版本: 持久化 %2 个节点 %3 MB（比单个版本多 %4%）| 整棵复制 %5 MB")
+                        .arg(versions.size()).arg(distinct)
+                        .arg(sharedMb, 0, 'f', 1)
+                        .arg(n ? (distinct - static_cast<double>(n)) * 100.0 / n : 0.0, 0, 'f', 2)
+                        .arg(clonedMb, 0, 'f', 1));
+
+    // 遍历：最旧与最新版本都按原来的遍历方式走一遍，最旧版本的值应与原树一致
+    int64_t originalSum = 0;
+    tree->forEach(PRE, [&originalSum](const TreeNode<int>* node) { originalSum += node->data; });
+    TraversalStats treeStats = tree->Traversal(PRE, false, visitNodeForStats);
+    textLog->append(QString("%1 先序: %2 | 值之和 %3").arg(QString("指针树"), -8)
+                        .arg(formatTiming(treeStats.time_ns, n)).arg(originalSum));
+    QVector<QString> names{"指针树"};
+    QVector<double> values{metricValue(treeStats.time_ns, n)};
+    int64_t oldestSum = 0;
+    for (int which = 0; which < 2; which++) {
+        QString name = which == 0 ? "最旧版本" : "最新版本";
+        versionValueSum = 0;
+        TraversalStats stats = (which == 0 ? versions.front() : versions.back()).Traversal(PRE, false, sumVersionValue);
+        if (which == 0) oldestSum = versionValueSum;
+        textLog->append(QString("%1 先序: %2 | 值之和 %3").arg(name, -8)
+                            .arg(formatTiming(stats.time_ns, n)).arg(versionValueSum));
+        names.append(name);
+        values.append(metricValue(stats.time_ns, n));
+    }
+    textLog->append(oldestSum == originalSum ? "最旧版本未被后续更新改动" : "最旧版本被改动了！");
+    textLog->append("=======================================\n");
+
+    updateBarChart("持久化版本遍历", names, values, n);
+    versions.clear();
+    copy.clear();
+    deleteTree(tree);
+}
+
+// 并发读写压测：多个读者无锁遍历，同时写者以不同强度摘下、挂上子树和改值
+void MyChartView::onConcurrentClicked()
+{
+    int n = editDataSize->text().toInt();
+    if (n <= 0) {
+        QMessageBox::warning(this, "输入错误", "请输入有效的节点数");
+        return;
+    }
+
+    BinaryTree<int>* tree = createBigTree(n);
+    int height = tree->height();
+    ConcurrentTree<int> shared(*tree);
+    deleteTree(tree);
+
+    // 写者每次摘下一棵靠近叶子的子树，再在同一位置挂上 31 个节点的小树
+    BinaryTree<int> patch;
+    patch.buildCompleteParallel(31, 1);
+    const size_t writeDepth = static_cast<size_t>(std::max(1, height - 5));
+    const unsigned readers = std::max(1u, std::min(8u, std::thread::hardware_concurrency() - 1));
+    const int durationMs = 500;
+
+    textLog->append(QString("并发读写压测：N=%1，高度 %2，%3 个读者，每档 %4 ms，写者改动深度 %5")
+                        .arg(n).arg(height).arg(readers).arg(durationMs).arg(writeDepth));
+    textLog->append(describeTreeShape());
+    textLog->append("=======================================");
+
+    struct WriterLoad {
+        QString name;
+        bool enabled;
+        int pauseUs;    // 两次写之间的间隔
+    };
+    const WriterLoad loads[] = {
+        {"无写者", false, 0},
+        {"每毫秒一次写", true, 1000},
+        {"每 50 微秒一次写", true, 50},
+        {"连续写", true, 0},
+    };
+
+    const BenchClock& clock = BenchClock::instance();
+    QVector<QString> names;
+    QVector<double> values;
+    double baseline = 0.0;
+    for (const WriterLoad& load : loads) {
+        std::atomic<bool> stop{false};
+        std::atomic<uint64_t> visited{0};
+        std::atomic<uint64_t> passes{0};
+        ConcurrentTreeStats before = shared.statistics();
+
+        std::vector<std::thread> readerThreads;
+        for (unsigned r = 0; r < readers; r++) {
+            readerThreads.emplace_back([&, r]() {
+                TraversalClass kind = static_cast<TraversalClass>(r % 4);
+                int64_t sum = 0;
+                while (!stop.load(std::memory_order_relaxed)) {
+                    visited.fetch_add(shared.forEach(kind, [&sum](const int& value) { sum += value; }),
+                                      std::memory_order_relaxed);
+                    passes.fetch_add(1, std::memory_order_relaxed);
+                }
+                volatile int64_t sink = sum;
+                (void)sink;
+            });
+        }
+        std::thread writer;
+        if (load.enabled) {
+            writer = std::thread([&]() {
+                uint64_t seed = kRandomShapeSeed;
+                auto coin = [&seed]() {
+                    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+                    return (seed >> 63) != 0;
+                };
+                for (int op = 0; !stop.load(std::memory_order_relaxed); op++) {
+                    TreePath path = shared.walk(writeDepth, coin);
+                    if (path.size() < 2) continue;
+                    if (op % 4 == 3) {
+                        shared.replaceValue(path, op);
+                    } else {
+                        bool isRight = path.back() != 0;
+                        shared.detachSubtree(path);
+                        path.pop_back();
+                        shared.attachSubtree(path, isRight, patch);
+                    }
+                    if (load.pauseUs > 0) std::this_thread::sleep_for(std::chrono::microseconds(load.pauseUs));
+                }
+            });
+        }
+
+        uint64_t start = clock.now();
+        std::this_thread::sleep_for(std::chrono::milliseconds(durationMs));
+        stop.store(true);
+        for (std::thread& t : readerThreads) t.join();
+        if (writer.joinable()) writer.join();
+        double seconds = clock.elapsedNs(start, clock.now()) / 1e9;
+
+        ConcurrentTreeStats after = shared.statistics();
+        double readMnps = visited.load() / seconds / 1e6;
+        if (!load.enabled) baseline = readMnps;
+        QString line = QString("%1: 读者 %2 百万节点/秒（%3 次遍历）")
+                           .arg(load.name, -10).arg(readMnps, 0, 'f', 1).arg(passes.load());
+        if (load.enabled) {
+            line += QString(" | 写 %1 次/秒 | 回收 %2 / 摘下 %3 个节点，待回收峰值 %4")
+                        .arg((after.writes - before.writes) / seconds, 0, 'f', 0)
+                        .arg(after.freed - before.freed)
+                        .arg(after.retired - before.retired)
+                        .arg(after.peakPending);
+            if (baseline > 0.0) line += QString(" | 相对无写者 %1x").arg(readMnps / baseline, 0, 'f', 2);
+        }
+        textLog->append(line);
+        names.append(load.name);
+        values.append(readMnps);
+    }
+    textLog->append(QString("压测后节点数 %1").arg(shared.size()));
+    textLog->append("=======================================\n");
+
+    updateBarChart("写者强度对读者吞吐的影响", names, values, n, "读者吞吐 (百万节点/秒)");
+}
+
+// 多个生产者并发插入完全二叉树：原子领取层序位置的无锁插入 vs 一把互斥锁
+void MyChartView::onConcurrentInsertClicked()
+{
+    int n = editDataSize->text().toInt();
+    if (n <= 0) {
+        QMessageBox::warning(this, "输入错误", "请输入有效的节点数");
+        return;
+    }
+
+    std::vector<unsigned> producerCounts;
+    unsigned maxProducers = std::max(4u, std::thread::hardware_concurrency());
+    for (unsigned p = 1; p <= maxProducers; p *= 2) producerCounts.push_back(p);
+
+    struct Variant {
+        QString name;
+        unsigned producers;
+        bool locked;
+    };
+    std::vector<Variant> variants;
+    for (unsigned p : producerCounts) {
+        variants.push_back({QString("无锁 %1 线程").arg(p), p, false});
+        variants.push_back({QString("互斥锁 %1 线程").arg(p), p, true});
+    }
+
+    textLog->append(QString("并发插入对比：N=%1，生产者 1..%2 个线程，本机 %3 个硬件线程")
+                        .arg(n).arg(producerCounts.back()).arg(std::thread::hardware_concurrency()));
+    textLog->append("=======================================");
+
+    const BenchClock& clock = BenchClock::instance();
+    std::vector<bool> complete(variants.size(), true);
+    HarnessConfig config = harnessConfigFromUI(std::max(1, editRepeatTimes->text().toInt()));
+    std::vector<SampleSummary> summaries = bench::runInterleaved(static_cast<int>(variants.size()), [&](int alg) {
+        const Variant& variant = variants[alg];
+        BinaryTree<int> tree;
+        uint64_t start = clock.now();
+        auto inserter = tree.beginConcurrentInsert(static_cast<size_t>(n));
+        std::vector<std::thread> producers;
+        for (unsigned p = 0; p < variant.producers; p++) {
+            producers.emplace_back([&, p]() {
+                for (int v = static_cast<int>(p); v < n; v += static_cast<int>(variant.producers)) {
+                    if (variant.locked) {
+                        inserter.insertLocked(v);
+                    } else {
+                        inserter.insert(v);
+                    }
+                }
+            });
+        }
+        for (std::thread& t : producers) t.join();
+        size_t inserted = inserter.finish();
+        double ns = clock.elapsedNs(start, clock.now());
+        // 检查结果确实是 n 个节点的完全二叉树
+        int expectedHeight = 0;
+        while ((static_cast<size_t>(1) << expectedHeight) - 1 < static_cast<size_t>(n)) expectedHeight++;
+        if (inserted != static_cast<size_t>(n) || tree.height() != expectedHeight) complete[alg] = false;
+        return ns;
+    }, config);
+
+    QVector<QString> names;
+    QVector<double> values;
+    for (size_t alg = 0; alg < variants.size(); alg++) {
+        double mnps = summaries[alg].median > 0.0 ? n * 1e3 / summaries[alg].median : 0.0;
+        QString line = QString("%1: %2 ms | %3 百万节点/秒")
+                           .arg(variants[alg].name, -12)
+                           .arg(summaries[alg].median / 1e6, 0, 'f', 2)
+                           .arg(mnps, 0, 'f', 1);
+        if (alg >= 2 && summaries[alg].median > 0.0) {
+            line += QString(" | 相对单线程 %1x").arg(summaries[alg % 2].median / summaries[alg].median, 0, 'f', 2);
+        }
+        if (!complete[alg]) line += " | 结果不是完全二叉树！";
+        textLog->append(line);
+        names.append(variants[alg].name);
+        values.append(mnps);
+    }
+    textLog->append("=======================================\n");
+
+    updateBarChart("并发插入：无锁 vs 互斥锁", names, values, n, "吞吐量 (百万节点/秒)");
+}
+
+// 混合遍历的阈值扫描：阈值从 0（全程显式栈）到树高（全程递归），三种深度优先顺序交替采样
+void MyChartView::onHybridClicked()
+{
+    int n = editDataSize->text().toInt();
+    if (n <= 0) {
+        QMessageBox::warning(this, "输入错误", "请输入有效的节点数");
+        return;
+    }
+
+    BinaryTree<int>* tree = createBigTree(n);
+    int height = tree->height();
+    bool recursionSafe = height <= kMaxRecursiveHeight;
+    // 很高的树只扫描到 64，更大的阈值与全程递归没有区别却有栈溢出的风险
+    int maxThreshold = std::min(height, 64);
+    QVector<int> thresholds;
+    for (int t = 0; t <= maxThreshold; t++) thresholds.append(t);
+
+    textLog->append(QString("混合阈值扫描：N=%1，树高 %2，阈值 0~%3").arg(n).arg(height).arg(maxThreshold));
+    textLog->append(describeTreeShape());
+    textLog->append("=======================================");
+
+    // 每种顺序：各阈值的混合遍历，另加递归与显式栈两个参照
+    const TraversalClass kinds[] = {PRE, IN, POST};
+    const int perKind = thresholds.size() + 2;
+    HarnessConfig config = harnessConfigFromUI(std::max(1, editRepeatTimes->text().toInt()));
+    bench::CpuPinGuard pinGuard(config.pinCpu);
+    std::vector<SampleSummary> summaries = bench::runInterleaved(3 * perKind, [&](int alg) {
+        TraversalClass kind = kinds[alg / perKind];
+        int slot = alg % perKind;
+        if (slot < thresholds.size()) return tree->HybridTraversal(kind, thresholds[slot], visitNodeForStats).time_ns;
+        if (slot == thresholds.size() && recursionSafe) return tree->Traversal(kind, true, visitNodeForStats).time_ns;
+        return tree->Traversal(kind, false, visitNodeForStats).time_ns;
+    }, config);
+
+    QStringList seriesNames;
+    QVector<QVector<double>> values;
+    for (int k = 0; k < 3; k++) {
+        QString name = getTraversalTypeName(kinds[k]).left(2) + "混合";
+        seriesNames.append(name);
+        QVector<double> line;
+        int best = 0;
+        for (int i = 0; i < thresholds.size(); i++) {
+            double median = summaries[k * perKind + i].median;
+            line.append(metricValue(median, n));
+            if (median < summaries[k * perKind + best].median) best = i;
+        }
+        values.append(line);
+
+        double recursive = summaries[k * perKind + thresholds.size()].median;
+        double stack = summaries[k * perKind + thresholds.size() + 1].median;
+        textLog->append(QString("%1: 最佳阈值 %2 %3 | 阈值 0 %4 | 阈值 %5 %6")
+                            .arg(name)
+                            .arg(thresholds[best])
+                            .arg(formatTiming(summaries[k * perKind + best].median, n))
+                            .arg(formatTiming(summaries[k * perKind].median, n))
+                            .arg(maxThreshold)
+                            .arg(formatTiming(summaries[k * perKind + maxThreshold].median, n)));
+        textLog->append(QString("    参照：递归 %1 | 显式栈 %2")
+                            .arg(recursionSafe ? formatTiming(recursive, n) : QString("树太高，跳过"))
+                            .arg(formatTiming(stack, n)));
+    }
+    textLog->append(QString("当前默认阈值 %1").arg(kDefaultHybridThreshold));
+    textLog->append("=======================================\n");
+
+    updateSweepChart(QString("混合遍历耗时与切换阈值 (N=%1)").arg(n), "切换阈值（剩余高度）", thresholds, seriesNames, values);
+    deleteTree(tree);
+}
+
+// 固定节点数的小树：同形状指针树的递归遍历 vs 编译期排列表，每个样本重复到约 2^20 次访问
+template<size_t N>
+static void benchSmallTree(TraversalClass kind, const HarnessConfig& config, double& pointerNs, double& fixedNs,
+                           bool& consistent)
+{
+    BinaryTree<int> tree;
+    tree.buildCompleteParallel(static_cast<int>(N), 1);
+    FixedCompleteTree<int, N> fixed;
+    fixed.assign(tree);
+
+    const size_t reps = std::max<size_t>(1, (size_t(1) << 20) / N);
+    uint32_t sums[2] = {0, 0};
+    std::vector<SampleSummary> summaries = bench::runInterleaved(2, [&](int alg) {
+        workSum = 0;
+        double ns = 0.0;
+        for (size_t r = 0; r < reps; r++) {
+            ns += alg == 0 ? tree.Traversal(kind, true, workOnNode).time_ns : fixed.Traversal(kind, workOnValue).time_ns;
+        }
+        sums[alg] = workSum;
+        return ns / reps;
+    }, config);
+    pointerNs = summaries[0].median;
+    fixedNs = summaries[1].median;
+    consistent = sums[0] == sums[1];
+}
+
+// 完全二叉树的定形特化：底部满子树展开（指针内核 / 编译期排列表）对比通用的递归、显式栈遍历
+void MyChartView::onFixedShapeClicked()
+{
+    int n = editDataSize->text().toInt();
+    if (n <= 0) {
+        QMessageBox::warning(this, "输入错误", "请输入有效的节点数");
+        return;
+    }
+    TraversalClass kind = static_cast<TraversalClass>(comboTraversalType->currentData().toInt());
+    if (kind == LEVEL) {
+        QMessageBox::warning(this, "不适用", "层序遍历没有定形特化版本，请选择先序、中序或后序");
+        return;
+    }
+
+    // 特化只对完全二叉树成立，不随树形状选项变化
+    BinaryTree<int> tree;
+    TreeBuildStats build = tree.buildCompleteParallel(n);
+    int height = tree.height();
+    textLog->append(QString("定形特化对比：%1，N=%2（完全二叉树，树高 %3，建树 %4 ms）")
+                        .arg(getTraversalTypeName(kind)).arg(n).arg(height).arg(build.ms, 0, 'f', 2));
+    textLog->append("=======================================");
+
+    const bool recursionSafe = height <= kMaxRecursiveHeight;
+    QVector<QString> names = {"通用递归", "通用显式栈", "展开内核 h≤4", "展开内核 h≤6", "排列表 h≤4", "排列表 h≤6"};
+    uint32_t sums[6] = {0};
+    HarnessConfig config = harnessConfigFromUI(std::max(1, editRepeatTimes->text().toInt()));
+    bench::CpuPinGuard pinGuard(config.pinCpu);
+    std::vector<SampleSummary> summaries = bench::runInterleaved(names.size(), [&](int alg) {
+        workSum = 0;
+        double ns = 0.0;
+        switch (alg) {
+        case 0: ns = tree.Traversal(kind, recursionSafe, workOnNode).time_ns; break;
+        case 1: ns = tree.Traversal(kind, false, workOnNode).time_ns; break;
+        case 2: ns = fixedtree::traverseComplete<4>(tree, kind, false, workOnNode).time_ns; break;
+        case 3: ns = fixedtree::traverseComplete<6>(tree, kind, false, workOnNode).time_ns; break;
+        case 4: ns = fixedtree::traverseComplete<4>(tree, kind, true, workOnNode).time_ns; break;
+        case 5: ns = fixedtree::traverseComplete<6>(tree, kind, true, workOnNode).time_ns; break;
+        }
+        sums[alg] = workSum;
+        return ns;
+    }, config);
+
+    QVector<double> values;
+    for (int alg = 0; alg < names.size(); alg++) {
+        values.append(metricValue(summaries[alg].median, n));
+        QString line = QString("%1: %2").arg(names[alg], -10).arg(formatTiming(summaries[alg].median, n));
+        if (alg >= 2 && summaries[alg].median > 0.0) {
+            line += QString(" | 相对通用递归 %1x").arg(summaries[0].median / summaries[alg].median, 0, 'f', 2);
+        }
+        textLog->append(line);
+    }
+    bool consistent = std::all_of(sums + 1, sums + 6, [&](uint32_t s) { return s == sums[0]; });
+    textLog->append(QString("指纹 %1 %2").arg(sums[0], 8, 16, QChar('0')).arg(consistent ? "一致" : "不一致！"));
+
+    // 小树：整棵树的访问顺序在编译期算成表
+    textLog->append("小树（每样本重复至约 2^20 次访问）：");
+    auto reportSmall = [&](size_t size, double pointerNs, double fixedNs, bool same) {
+        textLog->append(QString("  N=%1: 指针树递归 %2 ns/节点 | 排列表 %3 ns/节点 | %4x%5")
+                            .arg(size, 4)
+                            .arg(pointerNs / size, 0, 'f', 2)
+                            .arg(fixedNs / size, 0, 'f', 2)
+                            .arg(fixedNs > 0.0 ? pointerNs / fixedNs : 0.0, 0, 'f', 2)
+                            .arg(same ? "" : " 结果不一致！"));
+    };
+    double pointerNs, fixedNs;
+    bool same;
+    benchSmallTree<15>(kind, config, pointerNs, fixedNs, same);
+    reportSmall(15, pointerNs, fixedNs, same);
+    benchSmallTree<63>(kind, config, pointerNs, fixedNs, same);
+    reportSmall(63, pointerNs, fixedNs, same);
+    benchSmallTree<255>(kind, config, pointerNs, fixedNs, same);
+    reportSmall(255, pointerNs, fixedNs, same);
+    benchSmallTree<1023>(kind, config, pointerNs, fixedNs, same);
+    reportSmall(1023, pointerNs, fixedNs, same);
+    textLog->append("=======================================\n");
+
+    updateBarChart("定形特化 vs 通用遍历", names, values, n);
+}
+
+// 完全二叉树的名次区间：随机访问第 k 个节点的开销，以及把一次遍历按名次切段并行完成
+void MyChartView::onRankRangeClicked()
+{
+    int n = editDataSize->text().toInt();
+    if (n <= 0) {
+        QMessageBox::warning(this, "输入错误", "请输入有效的节点数");
+        return;
+    }
+    TraversalClass kind = static_cast<TraversalClass>(comboTraversalType->currentData().toInt());
+
+    // 下标算术只对完全二叉树成立，不随树形状选项变化
+    BinaryTree<int> tree;
+    TreeBuildStats build = tree.buildCompleteParallel(n);
+    CompleteTreeIndex index(static_cast<uint64_t>(n));
+    unsigned workers = std::max(2u, std::thread::hardware_concurrency());
+    textLog->append(QString("名次区间：%1，N=%2（完全二叉树，树高 %3，建树 %4 ms），%5 个工作线程")
+                        .arg(getTraversalTypeName(kind)).arg(n).arg(index.height())
+                        .arg(build.ms, 0, 'f', 2).arg(workers));
+    textLog->append("=======================================");
+
+    // 正确性：整段名次遍历与普通遍历的顺序逐个相同
+    std::vector<const TreeNode<int>*> expected;
+    expected.reserve(n);
+    tree.forEach(kind, [&](const TreeNode<int>* node) { expected.push_back(node); });
+    size_t position = 0;
+    bool sameOrder = true;
+    forEachCompleteRange(tree, index, kind, 0, n, [&](const TreeNode<int>* node) {
+        sameOrder = sameOrder && expected[position++] == node;
+    });
+    textLog->append(QString("按名次遍历与普通遍历的顺序%1").arg(sameOrder ? "一致" : "不一致！"));
+
+    // 随机访问：名次 -> 层序下标 -> 名次
+    const BenchClock& clock = BenchClock::instance();
+    const int probes = 100000;
+    std::vector<uint64_t> ranks(probes);
+    std::mt19937_64 rng(kRandomShapeSeed);
+    for (uint64_t& r : ranks) r = rng() % static_cast<uint64_t>(n);
+    uint64_t checksum = 0;
+    bool roundTrip = true;
+    uint64_t start = clock.now();
+    for (uint64_t r : ranks) checksum += index.select(kind, r);
+    double selectNs = clock.elapsedNs(start, clock.now()) / probes;
+    start = clock.now();
+    for (uint64_t r : ranks) roundTrip = roundTrip && index.rank(kind, index.select(kind, r)) == r;
+    double roundTripNs = clock.elapsedNs(start, clock.now()) / probes;
+    textLog->append(QString("随机访问第 k 个：%1 ns/次 | 往返（名次→下标→名次）%2 ns/次，%3（校验和 %4）")
+                        .arg(selectNs, 0, 'f', 1).arg(roundTripNs, 0, 'f', 1)
+                        .arg(roundTrip ? "全部一致" : "不一致！").arg(checksum % 100000));
+
+    // 遍历：普通非递归、单线程按名次整段、按名次切段多线程；各自算指纹比对
+    QVector<QString> names = {"普通非递归", "按名次整段", QString("切段 %1 线程").arg(workers)};
+    uint32_t sums[3] = {0, 0, 0};
+    HarnessConfig config = harnessConfigFromUI(std::max(1, editRepeatTimes->text().toInt()));
+    std::vector<SampleSummary> summaries = bench::runInterleaved(names.size(), [&](int alg) {
+        uint64_t begin = clock.now();
+        if (alg == 0) {
+            workSum = 0;
+            tree.Traversal(kind, false, workOnNode);
+            sums[alg] = workSum;
+        } else if (alg == 1) {
+            uint32_t sum = 0;
+            forEachCompleteRange(tree, index, kind, 0, n, [&](const TreeNode<int>* node) { sum += nodeWork(node->data); });
+            sums[alg] = sum;
+        } else {
+            std::vector<uint32_t> partial(workers, 0);
+            std::vector<std::thread> threads;
+            for (unsigned w = 0; w < workers; w++) {
+                threads.emplace_back([&, w]() {
+                    uint64_t first, last;
+                    index.partition(w, workers, first, last);
+                    uint32_t sum = 0;
+                    forEachCompleteRange(tree, index, kind, first, last, [&](const TreeNode<int>* node) {
+                        sum += nodeWork(node->data);
+                    });
+                    partial[w] = sum;
+                });
+            }
+            for (std::thread& t : threads) t.join();
+            uint32_t sum = 0;
+            for (uint32_t s : partial) sum += s;
+            sums[alg] = sum;
+        }
+        return clock.elapsedNs(begin, clock.now());
+    }, config);
+
+    QVector<double> values;
+    for (int alg = 0; alg < names.size(); alg++) {
+        values.append(metricValue(summaries[alg].median, n));
+        QString line = QString("%1: %2").arg(names[alg], -10).arg(formatTiming(summaries[alg].median, n));
+        if (alg > 0 && summaries[alg].median > 0.0) {
+            line += QString(" | 相对普通遍历 %1x").arg(summaries[0].median / summaries[alg].median, 0, 'f', 2);
+        }
+        textLog->append(line);
+    }
+    bool consistent = sums[1] == sums[0] && sums[2] == sums[0];
+    textLog->append(QString("指纹 %1 %2").arg(sums[0], 8, 16, QChar('0')).arg(consistent ? "一致" : "不一致！"));
+    textLog->append("=======================================\n");
+
+    updateBarChart("按名次区间遍历", names, values, n);
+}
+
+// 在当前趋势图上叠加所选基线的中位数曲线，并标出显著回退的点
+void MyChartView::onCompareBaselineClicked()
+{
+    if (lastRun.isEmpty()) {
+        QMessageBox::warning(this, "无法对比", "请先运行一次趋势测试");
+        return;
+    }
+
+    BenchStore store;
+    QStringList ids = store.listRuns();
+    ids.removeAll(lastRun.id);
+    if (ids.isEmpty()) {
+        QMessageBox::information(this, "无法对比", "结果库中没有可用的基线：" + store.directory());
+        return;
+    }
+
+    bool ok = false;
+    QString id = QInputDialog::getItem(this, "选择基线", "基线:", ids, ids.size() - 1, false, &ok);
+    if (!ok) return;
+
+    BenchRun baseline;
+    QString message;
+    if (!store.load(id, baseline, &message)) {
+        QMessageBox::warning(this, "加载失败", message);
+        return;
+    }
+    if (baseline.unit != lastRun.unit) {
+        QMessageBox::warning(this, "无法对比", QString("时间单位不一致：%1 / %2").arg(baseline.unit, lastRun.unit));
+        return;
+    }
+
+    textLog->append(QString("\n=========== 对比基线 %1 ===========").arg(baseline.id));
+    textLog->append(QString("基线主机: %1 | %2 [%3] | 版本 %4")
+                        .arg(baseline.host.cpuModel, baseline.host.compiler,
+                             baseline.host.flags, baseline.host.gitRev));
+    textLog->append(baseline.treeShape);
+
+    QList<QAbstractAxis*> axesX = chart->axes(Qt::Horizontal);
+    QList<QAbstractAxis*> axesY = chart->axes(Qt::Vertical);
+    if (axesX.isEmpty() || axesY.isEmpty()) return;
+
+    // 基线曲线：与当前算法同色的细点线
+    const std::vector<AlgorithmSpec>& algorithms = bench::traversalAlgorithms();
+    QList<QAbstractSeries*> currentSeries = chart->series();
+    for (const AlgorithmSpec& spec : algorithms) {
+        QLineSeries* baseSeries = new QLineSeries();
+        baseSeries->setName(QString("%1 (基线)").arg(spec.name));
+        for (const BenchRecord& record : lastRun.records) {
+            if (record.algorithm != spec.name) continue;
+            const BenchRecord* base = baseline.find(record.algorithm, record.n);
+            if (base) baseSeries->append(record.n, metricValue(base->summary.median, record.n, lastRunMetric));
+        }
+        if (baseSeries->count() == 0) {
+            delete baseSeries;
+            continue;
+        }
+
+        QColor color = Qt::gray;
+        for (QAbstractSeries* s : currentSeries) {
+            QLineSeries* line = qobject_cast<QLineSeries*>(s);
+            if (line && line->name() == spec.name) color = line->color();
+        }
+        QPen pen(color);
+        pen.setWidth(1);
+        pen.setStyle(Qt::DotLine);
+        baseSeries->setPen(pen);
+
+        chart->addSeries(baseSeries);
+        baseSeries->attachAxis(axesX.first());
+        baseSeries->attachAxis(axesY.first());
+    }
+
+    // 显著回退：红色标记
+    QVector<Regression> regressions = bench::findRegressions(baseline, lastRun);
+    if (regressions.isEmpty()) {
+        textLog->append("未发现显著回退");
+        return;
+    }
+
+    QScatterSeries* marks = new QScatterSeries();
+    marks->setName("显著回退");
+    marks->setColor(Qt::red);
+    marks->setMarkerSize(10);
+    for (const Regression& r : regressions) {
+        marks->append(r.n, metricValue(r.currentMedian, r.n, lastRunMetric));
+        textLog->append(QString("回退: %1 N=%2 %3 → %4 ns/节点 (x%5, p=%6)")
+                            .arg(r.algorithm).arg(r.n)
+                            .arg(r.baselineMedian / r.n, 0, 'f', 2)
+                            .arg(r.currentMedian / r.n, 0, 'f', 2)
+                            .arg(r.ratio, 0, 'f', 2)
+                            .arg(r.pValue < 0 ? QString("n/a") : QString::number(r.pValue, 'g', 3)));
+    }
+    chart->addSeries(marks);
+    marks->attachAxis(axesX.first());
+    marks->attachAxis(axesY.first());
+}
+
 TraversalStats MyChartView::performSingleAlgorithm(BinaryTree<int>* tree, TraversalClass traversalType, bool isRecursive)
 {
     // 直接调用Traversal函数，传入遍历类型和是否递归
@@ -472,7 +1914,7 @@ void MyChartView::clearChart()
 }
 
 void MyChartView::updateBarChart(const QString& title, const QVector<QString>& algorithmNames,
-                                 const QVector<double>& times, int n)
+                                 const QVector<double>& times, int n, const QString& yTitle)
 {
     clearChart();
 
@@ -498,7 +1940,7 @@ void MyChartView::updateBarChart(const QString& title, const QVector<QString>& a
 
     // 设置Y轴
     QValueAxis *axisY = new QValueAxis();
-    axisY->setTitleText("时间 (ms)");
+    axisY->setTitleText(yTitle.isEmpty() ? metricTitle() : yTitle);
     axisY->setMin(0);
 
     // 计算合适的Y轴最大值
@@ -516,24 +1958,29 @@ void MyChartView::updateBarChart(const QString& title, const QVector<QString>& a
 
 void MyChartView::updateDetailedTrendChart(const QString& title,
                                            const QVector<QLineSeries*>& allSeries,
-                                           const QVector<QLineSeries*>& errorSeries,
+                                           const QVector<QLineSeries*>& ciUpperSeries,
+                                           const QVector<QLineSeries*>& ciLowerSeries,
                                            const QVector<int>& testSizes,
-                                           const QStringList& algorithmNames,
-                                           const QVector<QVector<double>>& allTimes)
+                                           const QStringList& algorithmNames)
 {
     clearChart();
 
-    // 首先添加误差区域（作为背景）
-    for (int i = 0; i < errorSeries.size(); i++) {
-        QLineSeries* errorSerie = errorSeries[i];
+    // 首先添加置信区间带（作为背景）
+    for (int i = 0; i < ciUpperSeries.size(); i++) {
+        QLineSeries* upper = ciUpperSeries[i];
 
-        // 创建区域系列来显示误差范围
-        QAreaSeries *areaSeries = new QAreaSeries(errorSerie);
-        areaSeries->setName(errorSerie->name());
-        areaSeries->setColor(errorSerie->color());
-        areaSeries->setOpacity(0.1);
-        areaSeries->setVisible(false); // 隐藏误差区域的图例
+        // 上下边界之间填充，显示中位数的 95% 置信区间
+        QAreaSeries *areaSeries = new QAreaSeries(upper, ciLowerSeries[i]);
+        areaSeries->setName(upper->name());
+        areaSeries->setColor(upper->color());
+        areaSeries->setBorderColor(upper->color());
+        areaSeries->setOpacity(0.25);
         chart->addSeries(areaSeries);
+
+        // 隐藏置信区间带的图例
+        for (QLegendMarker* marker : chart->legend()->markers(areaSeries)) {
+            marker->setVisible(false);
+        }
     }
 
     // 添加主折线，根据全局配置设置线型
@@ -578,17 +2025,24 @@ void MyChartView::updateDetailedTrendChart(const QString& title,
     // 设置Y轴
     QValueAxis *axisY = qobject_cast<QValueAxis*>(chart->axes(Qt::Vertical).first());
     if (axisY) {
-        axisY->setTitleText("平均时间 (ms)");
+        axisY->setTitleText(metricTitle() + " 中位数");
         axisY->setLabelFormat("%.2f");
 
         // 计算Y轴范围
         double minTime = std::numeric_limits<double>::max();
         double maxTime = 0;
 
-        for (const QVector<double>& times : allTimes) {
-            for (double time : times) {
-                if (time < minTime) minTime = time;
-                if (time > maxTime) maxTime = time;
+        // 按图上实际绘制的指标值计算
+        for (QLineSeries* series : allSeries) {
+            for (const QPointF& p : series->points()) {
+                if (p.y() < minTime) minTime = p.y();
+                if (p.y() > maxTime) maxTime = p.y();
+            }
+        }
+        // 置信区间上界也要完整显示
+        for (QLineSeries* upper : ciUpperSeries) {
+            for (const QPointF& p : upper->points()) {
+                if (p.y() > maxTime) maxTime = p.y();
             }
         }
 
@@ -609,6 +2063,43 @@ void MyChartView::updateDetailedTrendChart(const QString& title,
     }
 }
 
+void MyChartView::updateSweepChart(const QString& title, const QString& xTitle, const QVector<int>& xs,
+                                   const QStringList& seriesNames, const QVector<QVector<double>>& values)
+{
+    clearChart();
+
+    double maxValue = 0.0;
+    for (int i = 0; i < seriesNames.size(); i++) {
+        QLineSeries* series = new QLineSeries();
+        series->setName(seriesNames[i]);
+        for (int j = 0; j < xs.size(); j++) {
+            series->append(xs[j], values[i][j]);
+            maxValue = std::max(maxValue, values[i][j]);
+        }
+        QPen pen = series->pen();
+        pen.setWidth(2);
+        series->setPen(pen);
+        chart->addSeries(series);
+    }
+
+    chart->createDefaultAxes();
+    QValueAxis *axisX = qobject_cast<QValueAxis*>(chart->axes(Qt::Horizontal).first());
+    if (axisX) {
+        axisX->setTitleText(xTitle);
+        axisX->setLabelFormat("%d");
+        if (!xs.isEmpty()) axisX->setRange(xs.first(), xs.last());
+    }
+    QValueAxis *axisY = qobject_cast<QValueAxis*>(chart->axes(Qt::Vertical).first());
+    if (axisY) {
+        axisY->setTitleText(metricTitle() + " 中位数");
+        axisY->setLabelFormat("%.2f");
+        if (maxValue > 0.0) axisY->setRange(0, maxValue * 1.1);
+    }
+
+    chart->setTitle(title);
+    chart->legend()->setVisible(true);
+}
+
 void MyChartView::displayStatisticsSummary(const QVector<int>& testSizes,
                                            const QStringList& algorithmNames,
                                            const QVector<QVector<double>>& allTimes,
@@ -663,20 +2154,115 @@ BinaryTree<int>* MyChartView::createBigTree(int n)
     if (n <= 0) return nullptr;
 
     BinaryTree<int>* tree = new BinaryTree<int>();
+    TreeBuildStats build;
+
+    switch (comboTreeShape->currentData().toInt()) {
+    case SHAPE_PATTERN:
+        if (patternTree) {
+            // 按手绘形状平铺（单线程逐个分配）
+            const BenchClock& clock = BenchClock::instance();
+            uint64_t start = clock.now();
+            tree->autoCreateTreeFromPattern(patternTree->getRoot(), n);
+            build.ms = clock.elapsedNs(start, clock.now()) / 1e6;
+            build.nodes = n;
+            break;
+        }
+        build = tree->buildCompleteParallel(n);
+        break;
+    case SHAPE_RANDOM:
+        // 固定种子，同一 N 每次得到相同的形状
+        build = tree->buildRandomParallel(n, kRandomShapeSeed);
+        break;
+    default:
+        build = tree->buildCompleteParallel(n);
+        break;
+    }
 
-    // 使用自动创建树的方法
-    tree->autoCreateTree(n);
-
+    // 建树单独报告，不计入遍历时间
+    textLog->append(QString("建树: %1 ms | %2 百万节点/秒 | %3 线程")
+                        .arg(build.ms, 0, 'f', 2)
+                        .arg(build.nodesPerSec() / 1e6, 0, 'f', 1)
+                        .arg(build.threads));
     return tree;
 }
 
+double MyChartView::metricValue(double ns, int n) const
+{
+    return metricValue(ns, n, comboTimeMetric->currentData().toInt());
+}
+
+double MyChartView::metricValue(double ns, int n, int metric)
+{
+    switch (metric) {
+    case METRIC_NS_PER_NODE:
+        return n > 0 ? ns / n : 0.0;
+    case METRIC_THROUGHPUT:
+        return ns > 0.0 ? n * 1e3 / ns : 0.0;   // 百万节点/秒
+    default:
+        return ns / 1e6;
+    }
+}
+
+QString MyChartView::metricTitle() const
+{
+    switch (comboTimeMetric->currentData().toInt()) {
+    case METRIC_NS_PER_NODE:
+        return "每节点时间 (ns)";
+    case METRIC_THROUGHPUT:
+        return "吞吐量 (百万节点/秒)";
+    default:
+        return "时间 (ms)";
+    }
+}
+
+// 日志中同时给出总时间、每节点时间和吞吐量
+QString MyChartView::formatTiming(double ns, int n)
+{
+    return QString("%1 ms, %2 ns/节点, %3 M节点/s")
+        .arg(ns / 1e6, 0, 'f', 3)
+        .arg(n > 0 ? ns / n : 0.0, 0, 'f', 2)
+        .arg(ns > 0.0 ? n * 1e3 / ns : 0.0, 0, 'f', 1);
+}
+
+QString MyChartView::describeTreeShape() const
+{
+    if (comboTreeShape->currentData().toInt() == SHAPE_PATTERN) {
+        if (!patternTree) {
+            return "树形状: 尚未导出手绘形状，使用完全二叉树";
+        }
+        return QString("树形状: 手绘形状平铺 (模板 %1 个节点)").arg(patternTree->countNodes());
+    }
+    if (comboTreeShape->currentData().toInt() == SHAPE_RANDOM) {
+        return QString("树形状: 随机形状 (种子 %1，左子树大小均匀随机)").arg(kRandomShapeSeed);
+    }
+    return "树形状: 完全二叉树";
+}
+
+// 节点交给后台回收线程释放，界面不必等大树逐个 delete
 void MyChartView::deleteTree(BinaryTree<int>* tree)
 {
     if (tree) {
+        tree->clearInBackground();
         delete tree;
     }
 }
 
+// 用于统计的访问函数（下标链接视图）
+void MyChartView::visitValueForStats(const int& value)
+{
+    visitCount++;
+    volatile int temp = value;
+    (void)temp;
+}
+
+// 用于统计的访问函数（带父指针的节点）
+void MyChartView::visitLinkedNodeForStats(TreeNode<int, ParentLink>* node)
+{
+    visitCount++;
+    volatile int temp = node->data;
+    (void)temp;
+}
+
 // 用于统计的访问函数
 void MyChartView::visitNodeForStats(TreeNode<int>* node)
 {
@@ -9,10 +9,23 @@
 #include <QPushButton>
 #include <QLabel>
 #include <QTextEdit>
+#include <QCheckBox>
 #include <QMessageBox>
 #include <QtCharts>
 #include <vector>
 #include "BinaryTree.cpp"
+#include "benchharness.h"
+#include "benchstore.h"
+#include "benchsuite.h"
+#include "treefile.h"
+#include "treestream.h"
+#include "succinct.h"
+#include "threadedtree.h"
+#include "treeaggregate.h"
+#include "persistenttree.h"
+#include "concurrenttree.h"
+#include "fixedtree.h"
+#include "completeindex.h"
 
 
 // // 遍历类型枚举
@@ -30,12 +43,19 @@
 //     size_t max_queue_length;
 // };
 
-// 前向声明
-template<typename T>
-class BinaryTree;
+// 性能测试所用的树形状
+enum TreeShape {
+    SHAPE_COMPLETE,    // 完全二叉树
+    SHAPE_PATTERN,     // 手绘形状平铺
+    SHAPE_RANDOM,      // 随机形状（并行建树）
+};
 
-template<typename T>
-class TreeNode;
+// 图表纵轴的计时指标
+enum TimeMetric {
+    METRIC_TOTAL_MS,     // 总时间 (ms)
+    METRIC_NS_PER_NODE,  // 每节点时间 (ns)
+    METRIC_THROUGHPUT,   // 吞吐量 (百万节点/秒)
+};
 
 class MyChartView : public QWidget
 {
@@ -51,27 +71,46 @@ public:
     // 算法线型配置
     static const std::vector<bool> lineStyleConfig; // true=实线, false=虚线
 
+    // 设置手绘形状模板（接管所有权），之后可按该形状平铺生成测试树
+    void setPatternTree(BinaryTree<int>* pattern);
+
 private slots:
     void onCompareClicked();
     void onTrendClicked();
     void onQuickTrendClicked();
+    void onCompareBaselineClicked();
+    void onBinaryFileClicked();
+    void onLoadCsvClicked();
+    void onStreamClicked();
+    void onSuccinctClicked();
+    void onBatchClicked();
+    void onAggregateClicked();
+    void onPersistentClicked();
+    void onConcurrentClicked();
+    void onConcurrentInsertClicked();
+    void onHybridClicked();
+    void onFixedShapeClicked();
+    void onRankRangeClicked();
 
 private:
     void setupUI();
     void runPerformanceTest(int n, TraversalClass traversalType);
-    void runDetailedTrendTest(int minNodes, int maxNodes, int stepSize, int repeatTimes);
+    void runDetailedTrendTest(int minNodes, int maxNodes, int stepSize, const HarnessConfig& config);
+    HarnessConfig harnessConfigFromUI(int repeatTimes) const;
     TraversalStats performSingleAlgorithm(BinaryTree<int>* tree, TraversalClass traversalType, bool isRecursive);
 
     QString getTraversalTypeName(TraversalClass type) const;
     void clearChart();
     void updateBarChart(const QString& title, const QVector<QString>& algorithmNames,
-                        const QVector<double>& times, int n);
+                        const QVector<double>& times, int n, const QString& yTitle = QString());
     void updateDetailedTrendChart(const QString& title,
                                   const QVector<QLineSeries*>& allSeries,
-                                  const QVector<QLineSeries*>& errorSeries,
+                                  const QVector<QLineSeries*>& ciUpperSeries,
+                                  const QVector<QLineSeries*>& ciLowerSeries,
                                   const QVector<int>& testSizes,
-                                  const QStringList& algorithmNames,
-                                  const QVector<QVector<double>>& allTimes);
+                                  const QStringList& algorithmNames);
+    void updateSweepChart(const QString& title, const QString& xTitle, const QVector<int>& xs,
+                          const QStringList& seriesNames, const QVector<QVector<double>>& values);
     void displayStatisticsSummary(const QVector<int>& testSizes,
                                   const QStringList& algorithmNames,
                                   const QVector<QVector<double>>& allTimes,
@@ -80,8 +119,18 @@ private:
 
     // 二叉树操作
     BinaryTree<int>* createBigTree(int n);
+    QString describeTreeShape() const;
+    static const uint64_t kRandomShapeSeed = 20240601;
+
+    // 把一次遍历的纳秒耗时换算为当前选择的纵轴指标
+    double metricValue(double ns, int n) const;
+    static double metricValue(double ns, int n, int metric);
+    QString metricTitle() const;
+    static QString formatTiming(double ns, int n);
     void deleteTree(BinaryTree<int>* tree);
     static void visitNodeForStats(TreeNode<int>* node);
+    static void visitLinkedNodeForStats(TreeNode<int, ParentLink>* node);
+    static void visitValueForStats(const int& value);
 
 private:
     // UI 控件
@@ -90,13 +139,40 @@ private:
     QLineEdit *editMaxNodes;
     QLineEdit *editStepSize;
     QLineEdit *editRepeatTimes;
+    QLineEdit *editWarmup;
+    QLineEdit *editBatchSize;
+    QCheckBox *checkAutoRepeat;
+    QCheckBox *checkPinCpu;
+    QCheckBox *checkSaveResults;
+    QPushButton *btnCompareBaseline;
     QComboBox *comboTraversalType;
+    QComboBox *comboTreeShape;
+    QComboBox *comboTimeMetric;
     QPushButton *btnCompare;
+    QPushButton *btnBinaryFile;
+    QPushButton *btnLoadCsv;
+    QPushButton *btnStream;
+    QPushButton *btnSuccinct;
+    QPushButton *btnBatch;
+    QPushButton *btnAggregate;
+    QPushButton *btnPersistent;
+    QPushButton *btnConcurrent;
+    QPushButton *btnConcurrentInsert;
+    QPushButton *btnHybrid;
+    QPushButton *btnFixedShape;
+    QPushButton *btnRankRange;
     QPushButton *btnTrend;
     QPushButton *btnQuickTrend;
     QLabel *lblStatsInfo;
     QTextEdit *textLog;
 
+    // 手绘形状模板
+    BinaryTree<int>* patternTree;
+
+    // 最近一次趋势测试的结果（用于保存与基线对比）
+    BenchRun lastRun;
+    int lastRunMetric;   // 绘制趋势图时使用的纵轴指标
+
     // 图表相关
     QChart *chart;
     QChartView *chartView;
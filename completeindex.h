@@ -0,0 +1,198 @@
+#ifndef COMPLETEINDEX_H
+#define COMPLETEINDEX_H
+
+#include <cstdint>
+#include <algorithm>
+#include "BinaryTree.cpp"
+
+/*
+* 完全二叉树的下标算术
+* n 个节点的完全二叉树形状只由 n 决定：层序下标 i（从 0 开始）的孩子是 2i+1、2i+2，
+* 任一子树的节点数可用位运算 O(1) 算出。于是层序下标与先序/中序/后序名次可以互相换算（沿根到节点的路径，
+* O(log n)，每步 O(1)），按名次取下一个节点均摊 O(1)，从任意名次开始的区间遍历不必从根走起，
+* 可以把一次遍历按名次切成若干段交给并行的工作线程
+* 内部用从 1 开始的堆编号 heap = 下标 + 1：heap 的二进制去掉最高位即为从根出发的左右路径
+*/
+class CompleteTreeIndex {
+public:
+    explicit CompleteTreeIndex(uint64_t nodes = 0)
+        : n(nodes), levels(nodes ? 64 - __builtin_clzll(nodes) : 0) {}
+
+    uint64_t size() const { return n; }
+    int height() const { return levels; }
+
+    // 以层序下标 index 为根的子树节点数
+    uint64_t subtreeSize(uint64_t index) const {
+        return sizeAt(index + 1);
+    }
+
+    // 层序下标 index 的节点在 kind 顺序中的名次（从 0 开始）
+    uint64_t rank(TraversalClass kind, uint64_t index) const {
+        uint64_t heap = index + 1;
+        if (kind == LEVEL) return index;
+        uint64_t r = 0;
+        // 自上而下走路径：向右走时，左兄弟子树（先序、中序还有父节点）排在前面
+        for (int shift = depthOf(heap) - 1; shift >= 0; shift--) {
+            uint64_t child = heap >> shift;
+            bool right = child & 1;
+            if (kind == PRE) {
+                r += 1 + (right ? sizeAt(child - 1) : 0);
+            } else if (right) {
+                r += sizeAt(child - 1) + (kind == IN ? 1 : 0);
+            }
+        }
+        if (kind == IN) r += sizeAt(heap * 2);
+        if (kind == POST) r += sizeAt(heap) - 1;
+        return r;
+    }
+
+    // kind 顺序中名次为 r 的节点的层序下标；r 越界时返回 size()
+    uint64_t select(TraversalClass kind, uint64_t r) const {
+        if (r >= n) return n;
+        if (kind == LEVEL) return r;
+        uint64_t heap = 1;
+        for (;;) {
+            uint64_t leftSize = sizeAt(heap * 2);
+            if (kind == PRE) {
+                if (r == 0) break;
+                r--;
+                if (r < leftSize) {
+                    heap = heap * 2;
+                } else {
+                    r -= leftSize;
+                    heap = heap * 2 + 1;
+                }
+            } else if (kind == IN) {
+                if (r < leftSize) {
+                    heap = heap * 2;
+                } else if (r == leftSize) {
+                    break;
+                } else {
+                    r -= leftSize + 1;
+                    heap = heap * 2 + 1;
+                }
+            } else {
+                uint64_t rightSize = sizeAt(heap * 2 + 1);
+                if (r < leftSize) {
+                    heap = heap * 2;
+                } else if (r < leftSize + rightSize) {
+                    r -= leftSize;
+                    heap = heap * 2 + 1;
+                } else {
+                    break;
+                }
+            }
+        }
+        return heap - 1;
+    }
+
+    // kind 顺序中 index 的下一个节点的层序下标，没有时返回 size()；连续取下一个时均摊 O(1)
+    uint64_t next(TraversalClass kind, uint64_t index) const {
+        uint64_t heap = index + 1;
+        uint64_t result = 0;
+        switch (kind) {
+        case PRE:
+            if (heap * 2 <= n) {
+                result = heap * 2;
+                break;
+            }
+            // 向上找第一个有右兄弟的左孩子：先去掉末尾的 1（右孩子），剩下的是左孩子
+            for (uint64_t v = heap; v > 1; v >>= 1) {
+                v >>= __builtin_ctzll(~v);
+                if (v > 1 && v + 1 <= n) {
+                    result = v + 1;
+                    break;
+                }
+            }
+            break;
+        case IN:
+            if (heap * 2 + 1 <= n) {
+                result = leftmost(heap * 2 + 1);
+            } else {
+                // 沿右孩子一路向上，第一个作为左孩子的祖先的父节点
+                result = heap >> (__builtin_ctzll(~heap) + 1);
+            }
+            break;
+        case POST:
+            if (heap == 1) break;
+            // 左孩子的下一个是右兄弟子树最左的叶子，否则是父节点
+            result = (heap & 1) == 0 && heap + 1 <= n ? leftmost(heap + 1) : heap >> 1;
+            break;
+        case LEVEL:
+            result = heap + 1 <= n ? heap + 1 : 0;
+            break;
+        }
+        return result ? result - 1 : n;
+    }
+
+    // 按 kind 顺序访问名次在 [first, last) 内的节点，visit 接收层序下标
+    template<typename Visit>
+    void forEachInRange(TraversalClass kind, uint64_t first, uint64_t last, Visit&& visit) const {
+        last = std::min(last, n);
+        if (first >= last) return;
+        uint64_t index = select(kind, first);
+        for (uint64_t r = first;;) {
+            visit(index);
+            if (++r == last) break;
+            index = next(kind, index);
+        }
+    }
+
+    // 把 [0, n) 的名次平均切成 parts 段，返回第 part 段 [first, last)
+    void partition(unsigned part, unsigned parts, uint64_t& first, uint64_t& last) const {
+        first = n * part / parts;
+        last = n * (part + 1) / parts;
+    }
+
+private:
+    uint64_t n;
+    int levels;     // 树高
+
+    static int depthOf(uint64_t heap) {
+        return 63 - __builtin_clzll(heap);
+    }
+
+    // 堆编号 heap 的子树节点数：最后一层以上是满的，最后一层只数不超过 n 的部分
+    uint64_t sizeAt(uint64_t heap) const {
+        if (heap > n) return 0;
+        int below = levels - 1 - depthOf(heap);
+        uint64_t width = uint64_t(1) << below;
+        uint64_t bottomFirst = heap << below;
+        uint64_t bottom = n < bottomFirst ? 0 : std::min(n - bottomFirst + 1, width);
+        return width - 1 + bottom;
+    }
+
+    // heap 子树中最左（最深）的节点；完全二叉树中它在最后一层或倒数第二层
+    uint64_t leftmost(uint64_t heap) const {
+        uint64_t v = heap << (levels - 1 - depthOf(heap));
+        return v > n ? v >> 1 : v;
+    }
+};
+
+// 完全二叉树中层序下标 index 的节点：按节点区层序存放时直接定位，否则从根按堆编号的二进制位走下去
+template<typename T, typename LinkPolicy>
+const TreeNode<T, LinkPolicy>* completeNodeAt(const BinaryTree<T, LinkPolicy>& tree, uint64_t index) {
+    const TreeNode<T, LinkPolicy>* node = tree.getRoot();
+    if (tree.storageKind() == STORAGE_LEVEL_ARENA) return node + index;
+    uint64_t heap = index + 1;
+    for (int shift = 62 - __builtin_clzll(heap); shift >= 0 && node; shift--) {
+        node = (heap >> shift) & 1 ? node->right : node->left;
+    }
+    return node;
+}
+
+/*
+* 按 kind 顺序访问完全二叉树中名次在 [first, last) 内的节点，visit 接收 const Node*
+* 节点区按层序存放（buildCompleteParallel、并发插入）时每个节点 O(1) 定位，否则每个节点从根走 O(log n) 步
+*/
+template<typename T, typename LinkPolicy, typename Visit>
+void forEachCompleteRange(const BinaryTree<T, LinkPolicy>& tree, const CompleteTreeIndex& index,
+                          TraversalClass kind, uint64_t first, uint64_t last, Visit&& visit) {
+    const TreeNode<T, LinkPolicy>* base = tree.getRoot();
+    bool arena = tree.storageKind() == STORAGE_LEVEL_ARENA;
+    index.forEachInRange(kind, first, last, [&](uint64_t i) {
+        visit(arena ? base + i : completeNodeAt(tree, i));
+    });
+}
+
+#endif // COMPLETEINDEX_H
@@ -0,0 +1,390 @@
+#ifndef CONCURRENTTREE_H
+#define CONCURRENTTREE_H
+
+#include <cstdint>
+#include <vector>
+#include <queue>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <functional>
+#include <algorithm>
+#include "BinaryTree.cpp"
+#include "persistenttree.h"
+
+/*
+* 基于纪元（epoch）的延迟回收
+* 读者进入临界区时把当前全局纪元登记到一个槽位，离开时清零；写者摘下的节点记上摘下时的纪元，
+* 只有当所有在场读者登记的纪元都比它新时才真正释放——那之后进场的读者不可能再走到这些节点
+*/
+class EpochManager {
+public:
+    static const size_t kSlots = 64;   // 同时在场的读者上限，满了新读者让出 CPU 等待
+
+    // 读者临界区：构造时登记，析构时离场
+    class Guard {
+    public:
+        explicit Guard(EpochManager& manager) : slot(manager.enter()) {
+            // 登记必须先于之后对树链接的读取被写者看到
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+        ~Guard() { slot->store(0, std::memory_order_release); }
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+
+    private:
+        std::atomic<uint64_t>* slot;
+    };
+
+    uint64_t current() const { return epoch.load(std::memory_order_seq_cst); }
+
+    // 推进全局纪元，返回新纪元
+    uint64_t advance() { return epoch.fetch_add(1, std::memory_order_seq_cst) + 1; }
+
+    // 在场读者中最旧的纪元；没有读者时为当前纪元
+    uint64_t oldestActive() const {
+        uint64_t oldest = current();
+        for (const Slot& slot : slots) {
+            uint64_t e = slot.epoch.load(std::memory_order_seq_cst);
+            if (e != 0) oldest = std::min(oldest, e);
+        }
+        return oldest;
+    }
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> epoch{0};   // 0 表示空闲
+    };
+
+    std::atomic<uint64_t> epoch{1};
+    Slot slots[kSlots];
+
+    std::atomic<uint64_t>* enter() {
+        // 从线程各自的位置开始找空槽，减少读者之间争抢同一个槽位
+        size_t start = std::hash<std::thread::id>()(std::this_thread::get_id()) % kSlots;
+        while (true) {
+            uint64_t e = current();
+            for (size_t i = 0; i < kSlots; i++) {
+                Slot& slot = slots[(start + i) % kSlots];
+                uint64_t expected = 0;
+                if (slot.epoch.compare_exchange_strong(expected, e, std::memory_order_seq_cst)) return &slot.epoch;
+            }
+            std::this_thread::yield();
+        }
+    }
+};
+
+// 孩子指针为原子变量的节点：写者用 release 发布，读者用 acquire 读取
+template<typename T>
+struct ConcurrentNode {
+    T data;
+    std::atomic<ConcurrentNode*> left;
+    std::atomic<ConcurrentNode*> right;
+
+    explicit ConcurrentNode(const T& val) : data(val), left(nullptr), right(nullptr) {}
+};
+
+// 写者与回收的累计统计
+struct ConcurrentTreeStats {
+    size_t writes = 0;       // 写操作次数
+    size_t retired = 0;      // 摘下等待回收的节点数
+    size_t freed = 0;        // 已释放的节点数
+    size_t peakPending = 0;  // 等待回收的节点数峰值
+};
+
+/*
+* 读写并发的二叉树：读者无锁遍历，同时可以有写者挂上或摘下子树、改值或整棵替换
+* 写者之间用互斥锁串行；节点的值不会原地修改（改值是换一个新节点），所以读者看到的每个节点都是完整的
+* 读者一次遍历看到的是各条链接在读取那一刻的状态，不是整棵树的快照；需要快照请用 PersistentTree
+*/
+template<typename T>
+class ConcurrentTree {
+public:
+    typedef ConcurrentNode<T> Node;
+
+    ConcurrentTree() : root(nullptr), count(0) {}
+
+    explicit ConcurrentTree(const BinaryTree<T>& source) : root(nullptr), count(0) {
+        size_t n = 0;
+        root.store(copyOf(source.getRoot(), n), std::memory_order_release);
+        count.store(n, std::memory_order_relaxed);
+    }
+
+    // 析构时不能再有读者
+    ~ConcurrentTree() {
+        freeSubtree(root.load(std::memory_order_relaxed));
+        for (const Retired& r : retired) delete r.node;
+    }
+
+    ConcurrentTree(const ConcurrentTree&) = delete;
+    ConcurrentTree& operator=(const ConcurrentTree&) = delete;
+
+    size_t size() const { return count.load(std::memory_order_relaxed); }
+
+    // ---- 写者接口 ----
+
+    // 用 source 的副本整棵替换当前的树，旧树交给纪元回收
+    void publishTree(const BinaryTree<T>& source) {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        size_t n = 0;
+        Node* fresh = copyOf(source.getRoot(), n);
+        Node* old = root.exchange(fresh, std::memory_order_acq_rel);
+        count.store(n, std::memory_order_relaxed);
+        retireSubtree(old);
+        finishWrite();
+    }
+
+    // 把 source 的副本挂到路径所指节点的左（isRight 为 false）或右空位；副本先在私有内存中建好，再一次性发布
+    bool attachSubtree(const TreePath& path, bool isRight, const BinaryTree<T>& source) {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        std::atomic<Node*>* link = childLink(path, isRight);
+        if (!link || link->load(std::memory_order_relaxed)) return false;
+        size_t n = 0;
+        Node* fresh = copyOf(source.getRoot(), n);
+        link->store(fresh, std::memory_order_release);
+        count.fetch_add(n, std::memory_order_relaxed);
+        finishWrite();
+        return true;
+    }
+
+    bool insertChild(const TreePath& path, bool isRight, const T& value) {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        std::atomic<Node*>* link = childLink(path, isRight);
+        if (!link || link->load(std::memory_order_relaxed)) return false;
+        link->store(new Node(value), std::memory_order_release);
+        count.fetch_add(1, std::memory_order_relaxed);
+        finishWrite();
+        return true;
+    }
+
+    // 摘下路径所指的整棵子树（空路径摘根），返回摘下的节点数
+    size_t detachSubtree(const TreePath& path) {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        std::atomic<Node*>* link = nodeLink(path);
+        Node* target = link ? link->load(std::memory_order_relaxed) : nullptr;
+        if (!target) return 0;
+        link->store(nullptr, std::memory_order_release);
+        size_t n = retireSubtree(target);
+        count.fetch_sub(n, std::memory_order_relaxed);
+        finishWrite();
+        return n;
+    }
+
+    // 改值：换上一个带新值、共用原来孩子的节点，旧节点单独回收
+    bool replaceValue(const TreePath& path, const T& value) {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        std::atomic<Node*>* link = nodeLink(path);
+        Node* old = link ? link->load(std::memory_order_relaxed) : nullptr;
+        if (!old) return false;
+        Node* fresh = new Node(value);
+        fresh->left.store(old->left.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        fresh->right.store(old->right.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        link->store(fresh, std::memory_order_release);
+        retire(old);
+        finishWrite();
+        return true;
+    }
+
+    // 供写者挑选修改位置：从根往下走最多 depth 步，到叶子为止
+    // 两侧孩子都在时由 choose() 决定（true 向右），只有一侧时走那一侧
+    template<typename Choose>
+    TreePath walk(size_t depth, Choose&& choose) {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        TreePath path;
+        Node* node = root.load(std::memory_order_relaxed);
+        while (node && path.size() < depth) {
+            Node* l = node->left.load(std::memory_order_relaxed);
+            Node* r = node->right.load(std::memory_order_relaxed);
+            if (!l && !r) break;
+            bool right = r && (!l || choose());
+            path.push_back(right);
+            node = right ? r : l;
+        }
+        return path;
+    }
+
+    ConcurrentTreeStats statistics() const {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        return stats;
+    }
+
+    // ---- 读者接口（可与写者并发） ----
+
+    // 按给定顺序访问节点数据，返回访问的节点数；整个遍历处于同一个读者临界区内
+    template<typename Visitor>
+    size_t forEach(TraversalClass traversal_class, Visitor&& visit, size_t* maxDepth = nullptr) const {
+        EpochManager::Guard guard(epochs);
+        Node* start = root.load(std::memory_order_acquire);
+        if (!start) return 0;
+        size_t visited = 0;
+        size_t deepest = 0;
+
+        if (traversal_class == LEVEL) {
+            std::queue<Node*> q;
+            q.push(start);
+            while (!q.empty()) {
+                deepest = std::max(deepest, q.size());
+                Node* current = q.front();
+                q.pop();
+                visit(current->data);
+                visited++;
+                if (Node* l = current->left.load(std::memory_order_acquire)) q.push(l);
+                if (Node* r = current->right.load(std::memory_order_acquire)) q.push(r);
+            }
+        } else {
+            // 每个孩子指针只读取一次：遍历途中链接被改动也不会重复或跳过同一个节点
+            struct Frame {
+                Node* node;
+                int stage;   // 0 未进入左子树，1 左子树已完成，2 右子树已完成
+            };
+            std::vector<Frame> stack{{start, 0}};
+            while (!stack.empty()) {
+                deepest = std::max(deepest, stack.size());
+                Frame& top = stack.back();
+                Node* node = top.node;
+                if (top.stage == 0) {
+                    if (traversal_class == PRE) { visit(node->data); visited++; }
+                    top.stage = 1;
+                    if (Node* l = node->left.load(std::memory_order_acquire)) stack.push_back({l, 0});
+                } else if (top.stage == 1) {
+                    if (traversal_class == IN) { visit(node->data); visited++; }
+                    top.stage = 2;
+                    if (Node* r = node->right.load(std::memory_order_acquire)) stack.push_back({r, 0});
+                } else {
+                    if (traversal_class == POST) { visit(node->data); visited++; }
+                    stack.pop_back();
+                }
+            }
+        }
+        if (maxDepth) *maxDepth = deepest;
+        return visited;
+    }
+
+    // 与其它树相同的遍历入口；并发模式下只有非递归实现（递归版本无法保证每个链接只读一次）
+    TraversalStats Traversal(TraversalClass traversal_class, void (*visit)(const T&)) const {
+        TraversalStats stats;
+        const BenchClock& clock = BenchClock::instance();
+        size_t maxDepth = 0;
+        uint64_t start = clock.now();
+        size_t visited = forEach(traversal_class, visit, &maxDepth);
+        uint64_t end = clock.now();
+        stats.setTiming(clock.elapsedNs(start, end), visited);
+        if (traversal_class == LEVEL) {
+            stats.max_queue_length = maxDepth;
+            stats.memory_usage = maxDepth * sizeof(Node*);
+        } else {
+            stats.max_stack_depth = maxDepth;
+            stats.memory_usage = maxDepth * (sizeof(Node*) + sizeof(int));
+        }
+        return stats;
+    }
+
+private:
+    struct Retired {
+        Node* node;
+        uint64_t epoch;   // 摘下时的纪元
+    };
+
+    std::atomic<Node*> root;
+    std::atomic<size_t> count;
+    mutable EpochManager epochs;
+    mutable std::mutex writeMutex;
+    std::vector<Retired> retired;   // 按纪元递增排列，只有写者访问
+    ConcurrentTreeStats stats;
+
+    // 复制普通二叉树，新节点此时还未发布，可以随意写
+    static Node* copyOf(const TreeNode<T>* source, size_t& n) {
+        if (!source) return nullptr;
+        Node* top = new Node(source->data);
+        n++;
+        std::vector<std::pair<const TreeNode<T>*, Node*>> stack{{source, top}};
+        while (!stack.empty()) {
+            const TreeNode<T>* src = stack.back().first;
+            Node* dst = stack.back().second;
+            stack.pop_back();
+            if (src->left) {
+                Node* child = new Node(src->left->data);
+                dst->left.store(child, std::memory_order_relaxed);
+                stack.push_back({src->left, child});
+                n++;
+            }
+            if (src->right) {
+                Node* child = new Node(src->right->data);
+                dst->right.store(child, std::memory_order_relaxed);
+                stack.push_back({src->right, child});
+                n++;
+            }
+        }
+        return top;
+    }
+
+    static void freeSubtree(Node* node) {
+        std::vector<Node*> stack;
+        if (node) stack.push_back(node);
+        while (!stack.empty()) {
+            Node* current = stack.back();
+            stack.pop_back();
+            if (Node* l = current->left.load(std::memory_order_relaxed)) stack.push_back(l);
+            if (Node* r = current->right.load(std::memory_order_relaxed)) stack.push_back(r);
+            delete current;
+        }
+    }
+
+    // 指向路径所指节点的那个链接（根或父节点的孩子指针）
+    std::atomic<Node*>* nodeLink(const TreePath& path) {
+        std::atomic<Node*>* link = &root;
+        for (uint8_t step : path) {
+            Node* node = link->load(std::memory_order_relaxed);
+            if (!node) return nullptr;
+            link = step ? &node->right : &node->left;
+        }
+        return link;
+    }
+
+    // 路径所指节点的左/右孩子链接；空树时挂在根上
+    std::atomic<Node*>* childLink(const TreePath& path, bool isRight) {
+        if (!root.load(std::memory_order_relaxed)) return &root;
+        std::atomic<Node*>* link = nodeLink(path);
+        Node* node = link ? link->load(std::memory_order_relaxed) : nullptr;
+        if (!node) return nullptr;
+        return isRight ? &node->right : &node->left;
+    }
+
+    void retire(Node* node) {
+        retired.push_back({node, epochs.current()});
+        stats.retired++;
+    }
+
+    // 子树已经摘下，只有写者还能看到它的内部链接
+    size_t retireSubtree(Node* node) {
+        size_t n = 0;
+        std::vector<Node*> stack;
+        if (node) stack.push_back(node);
+        while (!stack.empty()) {
+            Node* current = stack.back();
+            stack.pop_back();
+            if (Node* l = current->left.load(std::memory_order_relaxed)) stack.push_back(l);
+            if (Node* r = current->right.load(std::memory_order_relaxed)) stack.push_back(r);
+            retire(current);
+            n++;
+        }
+        return n;
+    }
+
+    // 每次写完推进纪元，并释放所有在场读者都已看不到的节点
+    void finishWrite() {
+        stats.writes++;
+        stats.peakPending = std::max(stats.peakPending, retired.size());
+        if (retired.empty()) return;
+        // 摘链的写入必须先于对读者槽位的扫描
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        epochs.advance();
+        uint64_t oldest = epochs.oldestActive();
+        size_t done = 0;
+        while (done < retired.size() && retired[done].epoch < oldest) delete retired[done++].node;
+        retired.erase(retired.begin(), retired.begin() + done);
+        stats.freed += done;
+    }
+};
+
+#endif // CONCURRENTTREE_H
@@ -0,0 +1,77 @@
+#include "containerview.h"
+
+// ================================================================
+// MyContainerView 类实现 (容器状态面板)
+// ================================================================
+
+MyContainerView::MyContainerView(QWidget *parent)
+    : QWidget(parent)
+{
+    QVBoxLayout *mainLayout = new QVBoxLayout(this);
+    mainLayout->setContentsMargins(0, 0, 0, 0);
+
+    lblTitle = new QLabel("等待运行...");
+    lblTitle->setWordWrap(true);
+    mainLayout->addWidget(lblTitle);
+
+    laneLayout = new QVBoxLayout();
+    mainLayout->addLayout(laneLayout);
+}
+
+//新的遍历开始：删除旧通道，按名称重建
+void MyContainerView::resetTrace(QString title, QStringList laneNames)
+{
+    for (Lane &lane : lanes) {
+        laneLayout->removeWidget(lane.header);
+        laneLayout->removeWidget(lane.list);
+        delete lane.header;
+        delete lane.list;
+    }
+    lanes.clear();
+
+    lblTitle->setText(title);
+
+    for (const QString &name : laneNames) {
+        Lane lane;
+        lane.name = name;
+        lane.header = new QLabel();
+        lane.list = new QListWidget();
+        lane.list->setMaximumHeight(160);
+        laneLayout->addWidget(lane.header);
+        laneLayout->addWidget(lane.list);
+        updateHeader(lane);
+        lanes.push_back(lane);
+    }
+}
+
+//增量更新：栈顶 / 队首始终显示在列表第一行
+void MyContainerView::applyStep(int lane, int op, QString label)
+{
+    if (lane < 0 || lane >= lanes.size()) return;
+    Lane &cur = lanes[lane];
+
+    switch (op) {
+    case TRACE_PUSH:
+        cur.list->insertItem(0, label);
+        break;
+    case TRACE_ENQUEUE:
+        cur.list->addItem(label);
+        break;
+    case TRACE_POP:
+    case TRACE_DEQUEUE:
+        if (cur.list->count() > 0) {
+            delete cur.list->takeItem(0);
+        }
+        break;
+    }
+
+    if (cur.list->count() > cur.peak) cur.peak = cur.list->count();
+    updateHeader(cur);
+}
+
+void MyContainerView::updateHeader(Lane &lane)
+{
+    int size = lane.list ? lane.list->count() : 0;
+    lane.header->setText(QString("%1 | 当前: %2 | 峰值: %3")
+                             .arg(lane.name).arg(size).arg(lane.peak));
+}
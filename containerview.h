@@ -0,0 +1,55 @@
+#ifndef CONTAINERVIEW_H
+#define CONTAINERVIEW_H
+
+#include <QWidget>
+#include <QLabel>
+#include <QListWidget>
+#include <QVBoxLayout>
+#include <QVector>
+#include <QStringList>
+
+/*
+* 容器操作类型（遍历轨迹中的一步）：
+* 压栈 PUSH      =0
+* 弹栈 POP       =1
+* 入队 ENQUEUE   =2
+* 出队 DEQUEUE   =3
+*/
+enum TraceOp {
+    TRACE_PUSH,
+    TRACE_POP,
+    TRACE_ENQUEUE,
+    TRACE_DEQUEUE,
+};
+
+// 容器状态面板：按遍历轨迹增量显示显式栈 / 队列 / 递归调用栈的当前内容
+// 每一步只插入或移除一个条目，不整体重绘
+class MyContainerView : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit MyContainerView(QWidget *parent = nullptr);
+
+public slots:
+    // 开始新的遍历：设置标题和容器通道（如 "栈 s"、"辅助栈 col"）
+    void resetTrace(QString title, QStringList laneNames);
+    // 应用一步轨迹
+    void applyStep(int lane, int op, QString label);
+
+private:
+    struct Lane {
+        QLabel *header = nullptr;
+        QListWidget *list = nullptr;
+        QString name;
+        int peak = 0;
+    };
+
+    QLabel *lblTitle;
+    QVBoxLayout *laneLayout;
+    QVector<Lane> lanes;
+
+    void updateHeader(Lane &lane);
+};
+
+#endif // CONTAINERVIEW_H
@@ -0,0 +1,435 @@
+#ifndef CSVTREELOADER_H
+#define CSVTREELOADER_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "mappedfile.h"
+
+/*
+* 并行 CSV 树加载器
+* 输入为边表，每行 id,left,right,value；left/right 为空或 -1 表示没有该孩子，
+* 首行若不以数字开头视为表头跳过
+* 流程：mmap 整个文件 -> 按行边界切块多线程解析 -> 第二遍把 id 解析为下标 -> 校验是否为单根二叉树
+*/
+
+// 解析结果：按文件中的行序存放，-1 表示空孩子
+struct CsvTreeData {
+    std::vector<int32_t> left;
+    std::vector<int32_t> right;
+    std::vector<int64_t> values;
+    int32_t root = -1;
+
+    size_t nodeCount = 0;       // 节点数
+    size_t bytes = 0;           // 文件大小
+    unsigned threads = 0;       // 实际使用的解析线程数
+    double parseMs = 0.0;       // 并行解析耗时
+    double resolveMs = 0.0;     // id 解析耗时
+    double validateMs = 0.0;    // 结构校验耗时
+
+    double totalMs() const { return parseMs + resolveMs + validateMs; }
+    double mbPerSec() const {
+        double ms = totalMs();
+        return ms > 0.0 ? bytes / (1024.0 * 1024.0) / (ms / 1000.0) : 0.0;
+    }
+};
+
+// 进度回调：已解析字节数、总字节数；在调用 loadCsvTree 的线程上触发
+using CsvProgressCallback = std::function<void(size_t done, size_t total)>;
+
+namespace csvtree {
+
+const int64_t kNoChild = -1;
+
+// 一行解析出的原始记录，孩子仍为 id
+struct CsvRecord {
+    int64_t id;
+    int64_t left;
+    int64_t right;
+    int64_t value;
+};
+
+// 单个块的解析结果
+struct CsvChunk {
+    const char* begin = nullptr;
+    const char* end = nullptr;
+    std::vector<CsvRecord> records;
+    bool failed = false;
+    size_t errorLine = 0;       // 出错行相对块起始的行数
+};
+
+inline double msSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+inline bool isBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+// 快速整数解析：空字段返回 kNoChild（allowEmpty 为 true 时）；p 停在分隔符上
+inline bool parseField(const char*& p, const char* end, int64_t& out, bool allowEmpty) {
+    while (p < end && isBlank(*p)) p++;
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        p++;
+    }
+    const char* digits = p;
+    uint64_t value = 0;
+    while (p < end && static_cast<unsigned>(*p - '0') < 10u) {
+        value = value * 10 + static_cast<unsigned>(*p - '0');
+        p++;
+    }
+    size_t length = p - digits;
+    while (p < end && isBlank(*p)) p++;
+    if (p < end && *p != ',' && *p != '\n') return false;
+    if (length == 0) {
+        if (negative || !allowEmpty) return false;
+        out = kNoChild;
+        return true;
+    }
+    if (length > 18) return false;
+    out = negative ? -static_cast<int64_t>(value) : static_cast<int64_t>(value);
+    return true;
+}
+
+inline bool expectComma(const char*& p, const char* end) {
+    if (p >= end || *p != ',') return false;
+    p++;
+    return true;
+}
+
+// 解析 [begin, end) 内的所有完整行；每解析约 1MB 更新一次进度
+inline void parseChunk(CsvChunk& chunk, std::atomic<size_t>& parsedBytes) {
+    const char* p = chunk.begin;
+    const char* reported = p;
+    size_t line = 0;
+    chunk.records.reserve((chunk.end - chunk.begin) / 16);
+
+    while (p < chunk.end) {
+        const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', chunk.end - p));
+        if (!lineEnd) lineEnd = chunk.end;
+
+        const char* q = p;
+        while (q < lineEnd && isBlank(*q)) q++;
+        if (q < lineEnd) {
+            CsvRecord r;
+            bool ok = parseField(q, lineEnd, r.id, false) && expectComma(q, lineEnd)
+                   && parseField(q, lineEnd, r.left, true) && expectComma(q, lineEnd)
+                   && parseField(q, lineEnd, r.right, true) && expectComma(q, lineEnd)
+                   && parseField(q, lineEnd, r.value, false) && q == lineEnd;
+            if (!ok || r.id < 0 || r.left < kNoChild || r.right < kNoChild) {
+                chunk.failed = true;
+                chunk.errorLine = line;
+                return;
+            }
+            chunk.records.push_back(r);
+        }
+
+        p = lineEnd < chunk.end ? lineEnd + 1 : chunk.end;
+        line++;
+        if (p - reported >= (1 << 20)) {
+            parsedBytes.fetch_add(p - reported, std::memory_order_relaxed);
+            reported = p;
+        }
+    }
+    parsedBytes.fetch_add(p - reported, std::memory_order_relaxed);
+}
+
+// id -> 下标映射：id 较稠密时用数组直接索引，否则用开放寻址哈希表
+class IdIndex {
+public:
+    // 返回 false 表示存在重复 id，dup 为该 id
+    bool build(const std::vector<CsvRecord>& records, int64_t& dup) {
+        int64_t maxId = -1;
+        for (const CsvRecord& r : records) maxId = std::max(maxId, r.id);
+
+        dense = maxId < int64_t(records.size()) * 4 + 1024;
+        if (dense) {
+            table.assign(maxId + 1, -1);
+            for (size_t i = 0; i < records.size(); i++) {
+                int32_t& slot = table[records[i].id];
+                if (slot >= 0) {
+                    dup = records[i].id;
+                    return false;
+                }
+                slot = static_cast<int32_t>(i);
+            }
+            return true;
+        }
+
+        // 装载因子不超过 0.5
+        size_t capacity = 16;
+        while (capacity < records.size() * 2) capacity <<= 1;
+        mask = capacity - 1;
+        keys.assign(capacity, -1);
+        table.assign(capacity, -1);
+        for (size_t i = 0; i < records.size(); i++) {
+            int64_t id = records[i].id;
+            size_t h = hash(id);
+            while (keys[h] >= 0) {
+                if (keys[h] == id) {
+                    dup = id;
+                    return false;
+                }
+                h = (h + 1) & mask;
+            }
+            keys[h] = id;
+            table[h] = static_cast<int32_t>(i);
+        }
+        return true;
+    }
+
+    // 找不到返回 -1
+    int32_t find(int64_t id) const {
+        if (dense) return id >= 0 && id < int64_t(table.size()) ? table[id] : -1;
+        for (size_t h = hash(id); keys[h] >= 0; h = (h + 1) & mask) {
+            if (keys[h] == id) return table[h];
+        }
+        return -1;
+    }
+
+private:
+    bool dense = true;
+    size_t mask = 0;
+    std::vector<int64_t> keys;      // 哈希表的键，-1 为空槽
+    std::vector<int32_t> table;     // 稠密时按 id 索引，否则与 keys 对应
+
+    size_t hash(int64_t id) const {
+        return static_cast<size_t>((static_cast<uint64_t>(id) * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+    }
+};
+
+// 对 [0, count) 按线程数均分并行执行 fn(begin, end, worker)
+template<typename Fn>
+void parallelFor(size_t count, unsigned threads, Fn fn) {
+    if (threads <= 1 || count < 4096) {
+        fn(size_t(0), count, 0u);
+        return;
+    }
+    std::vector<std::thread> workers;
+    size_t step = (count + threads - 1) / threads;
+    for (unsigned t = 0; t < threads; t++) {
+        size_t b = std::min(count, t * step);
+        size_t e = std::min(count, b + step);
+        if (b < e) workers.emplace_back(fn, b, e, t);
+    }
+    for (std::thread& w : workers) w.join();
+}
+
+// 检查是否为单根二叉树：每个节点至多一个父节点、恰好一个根、从根可达所有节点（排除环）
+inline bool validate(CsvTreeData& data, const std::vector<CsvRecord>& records, std::string* error) {
+    size_t n = data.nodeCount;
+    std::vector<uint8_t> hasParent(n, 0);
+    for (size_t i = 0; i < n; i++) {
+        for (int32_t child : {data.left[i], data.right[i]}) {
+            if (child < 0) continue;
+            if (hasParent[child]) {
+                if (error) *error = "节点 " + std::to_string(records[child].id) + " 有多个父节点";
+                return false;
+            }
+            hasParent[child] = 1;
+        }
+    }
+
+    data.root = -1;
+    for (size_t i = 0; i < n; i++) {
+        if (hasParent[i]) continue;
+        if (data.root >= 0) {
+            if (error) *error = "存在多个根节点: " + std::to_string(records[data.root].id)
+                              + ", " + std::to_string(records[i].id);
+            return false;
+        }
+        data.root = static_cast<int32_t>(i);
+    }
+    if (data.root < 0) {
+        if (error) *error = "没有根节点（存在环）";
+        return false;
+    }
+
+    // 入度至多为 1 且只有一个根时，根不可达的节点必然成环
+    size_t reached = 0;
+    std::vector<int32_t> stack{data.root};
+    while (!stack.empty()) {
+        int32_t current = stack.back();
+        stack.pop_back();
+        reached++;
+        if (data.right[current] >= 0) stack.push_back(data.right[current]);
+        if (data.left[current] >= 0) stack.push_back(data.left[current]);
+    }
+    if (reached != n) {
+        if (error) *error = "有 " + std::to_string(n - reached) + " 个节点不可从根到达（存在环）";
+        return false;
+    }
+    return true;
+}
+
+} // namespace csvtree
+
+// 加载 CSV 边表；threads 为 0 时使用硬件线程数。失败时返回 false 并给出原因
+// 节点值须在 [minValue, maxValue] 内（调用方按节点数据类型的范围给出），超出时报告是哪个节点
+inline bool loadCsvTree(const std::string& filename, CsvTreeData& data, std::string* error = nullptr,
+                        unsigned threads = 0, const CsvProgressCallback& progress = CsvProgressCallback(),
+                        int64_t minValue = INT64_MIN, int64_t maxValue = INT64_MAX) {
+    using namespace csvtree;
+    data = CsvTreeData();
+
+    MappedFile file;
+    if (!file.open(filename, true, error)) return false;
+    const char* begin = file.data();
+    const char* end = begin + file.size();
+    data.bytes = file.size();
+
+    // 跳过表头
+    size_t firstLine = 1;
+    const char* body = begin;
+    while (body < end && isBlank(*body)) body++;
+    if (body < end && static_cast<unsigned>(*body - '0') >= 10u) {
+        const char* nl = static_cast<const char*>(std::memchr(body, '\n', end - body));
+        body = nl ? nl + 1 : end;
+        firstLine = 2;
+    } else {
+        body = begin;
+    }
+
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    // 每块至少 1MB，小文件不值得开线程
+    size_t maxChunks = std::max<size_t>(1, (end - body) >> 20);
+    threads = static_cast<unsigned>(std::min<size_t>(threads, maxChunks));
+    data.threads = threads;
+
+    // 按行边界切块；块起始行号要数换行符才能得到，只在出错时补算
+    std::vector<CsvChunk> chunks(threads);
+    const char* cursor = body;
+    for (unsigned t = 0; t < threads; t++) {
+        chunks[t].begin = cursor;
+        const char* cut = t + 1 == threads ? end : body + (end - body) * (t + 1) / threads;
+        if (cut < cursor) cut = cursor;
+        if (cut < end) {
+            const char* nl = static_cast<const char*>(std::memchr(cut, '\n', end - cut));
+            cut = nl ? nl + 1 : end;
+        }
+        chunks[t].end = cut;
+        cursor = cut;
+    }
+
+    // 第一遍：并行解析；调用线程只负责汇报进度，保证回调在调用方线程上执行
+    auto timer = std::chrono::steady_clock::now();
+    std::atomic<size_t> parsedBytes(body - begin);
+    if (threads == 1) {
+        parseChunk(chunks[0], parsedBytes);
+    } else {
+        std::atomic<unsigned> running(threads);
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < threads; t++) {
+            workers.emplace_back([&chunks, &parsedBytes, &running, t]() {
+                parseChunk(chunks[t], parsedBytes);
+                running.fetch_sub(1);
+            });
+        }
+        while (progress && running.load() > 0) {
+            progress(parsedBytes.load(std::memory_order_relaxed), data.bytes);
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+        for (std::thread& w : workers) w.join();
+    }
+    data.parseMs = msSince(timer);
+    if (progress) progress(data.bytes, data.bytes);
+
+    for (const CsvChunk& chunk : chunks) {
+        if (chunk.failed) {
+            size_t line = firstLine + std::count(body, chunk.begin, '\n') + chunk.errorLine;
+            if (error) *error = "第 " + std::to_string(line) + " 行格式错误";
+            return false;
+        }
+    }
+
+    // 合并各块记录（保持文件行序）
+    timer = std::chrono::steady_clock::now();
+    std::vector<size_t> offsets(threads + 1, 0);
+    for (unsigned t = 0; t < threads; t++) offsets[t + 1] = offsets[t] + chunks[t].records.size();
+    size_t n = offsets[threads];
+    if (n == 0) {
+        if (error) *error = "文件中没有节点";
+        return false;
+    }
+    if (n > size_t(INT32_MAX)) {
+        if (error) *error = "节点数超过上限";
+        return false;
+    }
+    std::vector<CsvRecord> records(n);
+    parallelFor(threads, threads, [&](size_t b, size_t e, unsigned) {
+        for (size_t t = b; t < e; t++) {
+            std::copy(chunks[t].records.begin(), chunks[t].records.end(), records.begin() + offsets[t]);
+            std::vector<CsvRecord>().swap(chunks[t].records);
+        }
+    });
+
+    // 第二遍：把孩子 id 解析为下标
+    IdIndex index;
+    int64_t dup = 0;
+    if (!index.build(records, dup)) {
+        if (error) *error = "重复的节点 id: " + std::to_string(dup);
+        return false;
+    }
+    data.nodeCount = n;
+    data.left.resize(n);
+    data.right.resize(n);
+    data.values.resize(n);
+    std::vector<int64_t> missing(threads, kNoChild);
+    std::vector<int64_t> outOfRange(threads, -1);   // 值超出范围的记录下标
+    parallelFor(n, threads, [&](size_t b, size_t e, unsigned worker) {
+        for (size_t i = b; i < e; i++) {
+            const CsvRecord& r = records[i];
+            int32_t l = r.left == kNoChild ? -1 : index.find(r.left);
+            int32_t rr = r.right == kNoChild ? -1 : index.find(r.right);
+            if ((r.left != kNoChild && l < 0) || (r.right != kNoChild && rr < 0)) {
+                missing[worker] = l < 0 && r.left != kNoChild ? r.left : r.right;
+                return;
+            }
+            if (l == int32_t(i) || rr == int32_t(i) || (l >= 0 && l == rr)) {
+                missing[worker] = -2 - static_cast<int64_t>(i);
+                return;
+            }
+            if (r.value < minValue || r.value > maxValue) {
+                outOfRange[worker] = static_cast<int64_t>(i);
+                return;
+            }
+            data.left[i] = l;
+            data.right[i] = rr;
+            data.values[i] = r.value;
+        }
+    });
+    for (int64_t m : missing) {
+        if (m == kNoChild) continue;
+        if (error) {
+            *error = m >= 0 ? "引用了不存在的节点 id: " + std::to_string(m)
+                            : "节点 " + std::to_string(records[-2 - m].id) + " 的孩子指向自身或左右孩子相同";
+        }
+        return false;
+    }
+    for (int64_t i : outOfRange) {
+        if (i < 0) continue;
+        if (error) {
+            *error = "节点 " + std::to_string(records[i].id) + " 的值 " + std::to_string(records[i].value)
+                     + " 超出节点数据类型的范围 [" + std::to_string(minValue) + ", " + std::to_string(maxValue) + "]";
+        }
+        return false;
+    }
+    data.resolveMs = msSince(timer);
+
+    timer = std::chrono::steady_clock::now();
+    bool ok = validate(data, records, error);
+    data.validateMs = msSince(timer);
+    return ok;
+}
+
+#endif // CSVTREELOADER_H
@@ -0,0 +1,186 @@
+#ifndef ENGINECALIBRATION_H
+#define ENGINECALIBRATION_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <map>
+#include <mutex>
+#include <algorithm>
+
+/*
+* 遍历引擎：
+* 递归 RECURSIVE   每层一个调用帧，树太高会栈溢出
+* 显式栈 STACK     std::stack 保存路径
+* 游标 CURSOR      只有带父指针的树可用，不用栈
+* Morris MORRIS    临时改写空的右指针作线索，先序/中序可用，不用栈
+* 下标 IMPLICIT    节点区的存放顺序就是遍历顺序时顺序扫描节点区（层序存放的层序、先序存放的先序）
+* 混合 HYBRID      靠近根的上层用显式栈，剩余高度不超过阈值的子树用展开的递归，先序/中序/后序可用
+* AUTO 表示按校准表自动选择
+*/
+enum TraversalEngine {
+    ENGINE_AUTO,
+    ENGINE_RECURSIVE,
+    ENGINE_STACK,
+    ENGINE_CURSOR,
+    ENGINE_MORRIS,
+    ENGINE_IMPLICIT,
+    ENGINE_HYBRID,
+    ENGINE_COUNT,
+};
+
+inline const char* engineName(TraversalEngine engine) {
+    static const char* names[] = {"自动", "递归", "显式栈", "父指针游标", "Morris", "下标扫描", "混合"};
+    return engine >= 0 && engine < ENGINE_COUNT ? names[engine] : "?";
+}
+
+// 节点的存放方式
+enum TreeStorage {
+    STORAGE_HEAP,           // 逐个 new 的节点，或存放顺序与遍历顺序无关的节点区
+    STORAGE_LEVEL_ARENA,    // 节点区按层序存放（完全二叉树建树、并发插入）
+    STORAGE_PREORDER_ARENA, // 节点区按先序存放（随机形状并行建树）
+    STORAGE_COUNT,
+};
+
+// 递归引擎允许的最大树高，超过时不会被选中
+static const int kMaxRecursiveHeight = 10000;
+
+// 混合引擎默认的切换阈值：剩余高度不超过 12（不超过 4095 个节点）的子树改用递归
+static const int kDefaultHybridThreshold = 12;
+
+// 校准表的键：遍历顺序、存放方式、有无父指针、规模档（log10 n）、深度档
+struct EngineKey {
+    int kind = 0;           // TraversalClass
+    int storage = STORAGE_HEAP;
+    bool linked = false;
+    int sizeBucket = 0;
+    int depthClass = 0;
+
+    // 深度档：0 平衡（高度不超过 2 log2 n），1 较深，2 递归不安全
+    static int classifyDepth(int height, size_t count) {
+        if (height > kMaxRecursiveHeight) return 2;
+        int log2n = 1;
+        while ((size_t(1) << log2n) <= count && log2n < 63) log2n++;
+        return height <= 2 * log2n ? 0 : 1;
+    }
+
+    static int bucketOf(size_t count) {
+        int bucket = 0;
+        for (size_t c = count; c >= 10 && bucket < 9; c /= 10) bucket++;
+        return bucket;
+    }
+
+    bool operator<(const EngineKey& other) const {
+        if (kind != other.kind) return kind < other.kind;
+        if (storage != other.storage) return storage < other.storage;
+        if (linked != other.linked) return linked < other.linked;
+        if (depthClass != other.depthClass) return depthClass < other.depthClass;
+        return sizeBucket < other.sizeBucket;
+    }
+};
+
+struct EngineChoice {
+    TraversalEngine engine = ENGINE_STACK;
+    double nsPerNode = 0.0;    // 校准时测得的每节点耗时
+};
+
+/*
+* 引擎校准表：由基准测试（tree --bench --calibrate）在本机测出每种 (顺序, 存放, 父指针, 规模, 深度) 下最快的引擎，
+* 写成结果库目录（--store，默认 BenchStore::defaultDir()）下的 kFileName；使用方从同一目录显式 load，表不会自动加载
+* 每行：kind storage linked sizeBucket depthClass engine nsPerNode
+* 查表时规模档取同一组合中最接近的一档；表中没有该组合时由调用方按经验规则选择
+*/
+class EngineCalibration {
+public:
+    static EngineCalibration& instance() {
+        static EngineCalibration table;
+        return table;
+    }
+
+    // 校准表在结果库目录中的文件名
+    static constexpr const char* kFileName = "engine_calibration.txt";
+
+    bool load(const std::string& path) {
+        FILE* file = std::fopen(path.c_str(), "r");
+        if (!file) return false;
+        std::map<EngineKey, EngineChoice> loaded;
+        char line[256];
+        while (std::fgets(line, sizeof(line), file)) {
+            if (line[0] == '#') continue;
+            EngineKey key;
+            int linked, engine;
+            double ns;
+            if (std::sscanf(line, "%d %d %d %d %d %d %lf", &key.kind, &key.storage, &linked,
+                            &key.sizeBucket, &key.depthClass, &engine, &ns) != 7) continue;
+            if (engine <= ENGINE_AUTO || engine >= ENGINE_COUNT) continue;
+            key.linked = linked != 0;
+            loaded[key] = EngineChoice{static_cast<TraversalEngine>(engine), ns};
+        }
+        std::fclose(file);
+        std::lock_guard<std::mutex> lock(mutex);
+        entries.swap(loaded);
+        sourcePath = path;
+        return true;
+    }
+
+    bool save(const std::string& path) const {
+        FILE* file = std::fopen(path.c_str(), "w");
+        if (!file) return false;
+        std::lock_guard<std::mutex> lock(mutex);
+        std::fprintf(file, "# kind storage linked sizeBucket depthClass engine nsPerNode\n");
+        for (const auto& entry : entries) {
+            const EngineKey& k = entry.first;
+            std::fprintf(file, "%d %d %d %d %d %d %.3f\n", k.kind, k.storage, k.linked ? 1 : 0,
+                         k.sizeBucket, k.depthClass, static_cast<int>(entry.second.engine), entry.second.nsPerNode);
+        }
+        return std::fclose(file) == 0;
+    }
+
+    void set(const EngineKey& key, TraversalEngine engine, double nsPerNode) {
+        std::lock_guard<std::mutex> lock(mutex);
+        entries[key] = EngineChoice{engine, nsPerNode};
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex);
+        entries.clear();
+        sourcePath.clear();
+    }
+
+    // 查表：同一组合中规模档最接近的一项；找不到时返回 false
+    bool lookup(const EngineKey& key, EngineChoice& choice) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        int bestDistance = -1;
+        for (const auto& entry : entries) {
+            const EngineKey& k = entry.first;
+            if (k.kind != key.kind || k.storage != key.storage || k.linked != key.linked || k.depthClass != key.depthClass) continue;
+            int distance = std::abs(k.sizeBucket - key.sizeBucket);
+            if (bestDistance < 0 || distance < bestDistance) {
+                bestDistance = distance;
+                choice = entry.second;
+            }
+        }
+        return bestDistance >= 0;
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return entries.size();
+    }
+
+    // 表的来源文件，未加载时为空
+    std::string source() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return sourcePath;
+    }
+
+private:
+    mutable std::mutex mutex;
+    std::map<EngineKey, EngineChoice> entries;
+    std::string sourcePath;
+
+    EngineCalibration() = default;
+};
+
+#endif // ENGINECALIBRATION_H
@@ -0,0 +1,286 @@
+#ifndef FIXEDTREE_H
+#define FIXEDTREE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <vector>
+#include "BinaryTree.cpp"
+
+/*
+* 定形树的编译期特化
+* 完全二叉树的形状只由节点数 N 决定（层序下标 i 的孩子是 2i+1、2i+2），各遍历顺序访问的层序下标序列
+* 可以在编译期算成排列表；满二叉子树可以按高度展开成没有空孩子判断、也没有递归调用的内核
+*/
+namespace fixedtree {
+
+// 节点数为 N 的完全二叉树按 kind 顺序访问时的层序下标序列（编译期可求值）
+template<size_t N>
+constexpr std::array<uint32_t, N> makeOrder(TraversalClass kind) {
+    static_assert(N < (size_t(1) << 32), "下标超出 32 位");
+    std::array<uint32_t, N> order{};
+    size_t out = 0;
+    if (kind == LEVEL) {
+        for (size_t i = 0; i < N; i++) order[i] = static_cast<uint32_t>(i);
+        return order;
+    }
+    // 显式栈，每帧记录下标和阶段：0 刚到达，1 左子树已走完，2 右子树已走完
+    uint32_t stackIndex[64] = {};
+    uint8_t stackState[64] = {};
+    int top = 0;
+    if (N > 0) top = 1;
+    while (top > 0) {
+        uint32_t i = stackIndex[top - 1];
+        uint8_t state = stackState[top - 1]++;
+        size_t child = 2 * size_t(i) + 1 + state;
+        if (state == 0 && kind == PRE) order[out++] = i;
+        if (state == 1 && kind == IN) order[out++] = i;
+        if (state < 2) {
+            if (child < N) {
+                stackIndex[top] = static_cast<uint32_t>(child);
+                stackState[top] = 0;
+                top++;
+            }
+            continue;
+        }
+        if (kind == POST) order[out++] = i;
+        top--;
+    }
+    return order;
+}
+
+// 节点数为 N 的完全二叉树的四种访问排列表，编译期生成
+template<size_t N>
+struct CompleteOrder {
+    static constexpr std::array<uint32_t, N> pre = makeOrder<N>(PRE);
+    static constexpr std::array<uint32_t, N> in = makeOrder<N>(IN);
+    static constexpr std::array<uint32_t, N> post = makeOrder<N>(POST);
+    static constexpr std::array<uint32_t, N> level = makeOrder<N>(LEVEL);
+
+    static constexpr const std::array<uint32_t, N>& of(TraversalClass kind) {
+        return kind == PRE ? pre : kind == IN ? in : kind == POST ? post : level;
+    }
+};
+
+static_assert(CompleteOrder<7>::in[0] == 3 && CompleteOrder<7>::in[3] == 0 && CompleteOrder<7>::post[6] == 0,
+              "完全二叉树排列表有误");
+
+// 高为 H 的满子树中按某顺序第 k 个节点相对子树根的位置：层序编号（从 1 开始）为 (根 << level) + offset
+struct SubtreeStep {
+    uint8_t level;
+    uint16_t offset;
+};
+
+template<int H>
+struct PerfectOrder {
+    static_assert(H >= 1 && H <= 16, "满子树高度须在 1..16");
+    static constexpr size_t kSize = (size_t(1) << H) - 1;
+
+    static constexpr std::array<SubtreeStep, kSize> build(TraversalClass kind) {
+        std::array<uint32_t, kSize> order = makeOrder<kSize>(kind);
+        std::array<SubtreeStep, kSize> steps{};
+        for (size_t k = 0; k < kSize; k++) {
+            uint32_t heap = order[k] + 1;
+            uint8_t level = 0;
+            while ((heap >> (level + 1)) != 0) level++;
+            steps[k].level = level;
+            steps[k].offset = static_cast<uint16_t>(heap - (uint32_t(1) << level));
+        }
+        return steps;
+    }
+
+    static constexpr std::array<SubtreeStep, kSize> pre = build(PRE);
+    static constexpr std::array<SubtreeStep, kSize> in = build(IN);
+    static constexpr std::array<SubtreeStep, kSize> post = build(POST);
+
+    static constexpr const std::array<SubtreeStep, kSize>& of(TraversalClass kind) {
+        return kind == PRE ? pre : kind == IN ? in : post;
+    }
+};
+
+// 高为 H 的满子树的展开内核：形状固定，不判断空孩子，编译器可把整棵子树内联展开
+template<int H>
+struct PerfectKernel {
+    template<typename Node, typename Visit>
+    static void pre(Node* node, Visit& visit) {
+        visit(node);
+        PerfectKernel<H - 1>::pre(node->left, visit);
+        PerfectKernel<H - 1>::pre(node->right, visit);
+    }
+
+    template<typename Node, typename Visit>
+    static void in(Node* node, Visit& visit) {
+        PerfectKernel<H - 1>::in(node->left, visit);
+        visit(node);
+        PerfectKernel<H - 1>::in(node->right, visit);
+    }
+
+    template<typename Node, typename Visit>
+    static void post(Node* node, Visit& visit) {
+        PerfectKernel<H - 1>::post(node->left, visit);
+        PerfectKernel<H - 1>::post(node->right, visit);
+        visit(node);
+    }
+};
+
+template<>
+struct PerfectKernel<0> {
+    template<typename Node, typename Visit>
+    static void pre(Node*, Visit&) {}
+    template<typename Node, typename Visit>
+    static void in(Node*, Visit&) {}
+    template<typename Node, typename Visit>
+    static void post(Node*, Visit&) {}
+};
+
+/*
+* 把运行时的满子树高度 h（1..H）分派到对应的编译期实例
+* Table 为 true 时按 PerfectOrder 排列表直接计算节点区下标，不读孩子指针；否则用 PerfectKernel 沿指针展开
+*/
+template<int H, bool Table>
+struct PerfectDispatch {
+    template<typename Node, typename Visit>
+    static void run(int h, Node* base, Node* node, uint64_t heap, TraversalClass kind, Visit& visit) {
+        if (h != H) {
+            PerfectDispatch<H - 1, Table>::run(h, base, node, heap, kind, visit);
+            return;
+        }
+        if constexpr (Table) {
+            for (const SubtreeStep& step : PerfectOrder<H>::of(kind)) {
+                visit(base + ((heap << step.level) + step.offset - 1));
+            }
+        } else if (kind == PRE) {
+            PerfectKernel<H>::pre(node, visit);
+        } else if (kind == IN) {
+            PerfectKernel<H>::in(node, visit);
+        } else {
+            PerfectKernel<H>::post(node, visit);
+        }
+    }
+};
+
+template<bool Table>
+struct PerfectDispatch<0, Table> {
+    template<typename Node, typename Visit>
+    static void run(int, Node*, Node*, uint64_t, TraversalClass, Visit&) {}
+};
+
+/*
+* 完全二叉树的深度优先遍历：上层带着层序编号 heap（从 1 开始）递归，h 是该子树最左路径的高度；
+* 子树是高度不超过 Bottom 的满二叉树时（最后一层从 (heap+1) << (h-1) 往前全满）整棵交给展开的内核
+*/
+template<int Bottom, bool Table, typename Node, typename Visit>
+void walkComplete(Node* base, Node* node, uint64_t heap, int h, size_t n, TraversalClass kind, Visit& visit) {
+    if (h <= Bottom && ((heap + 1) << (h - 1)) - 1 <= n) {
+        PerfectDispatch<Bottom, Table>::run(h, base, node, heap, kind, visit);
+        return;
+    }
+    // 不是满子树时 h >= 2，左孩子一定存在
+    uint64_t left = heap * 2;
+    if (kind == PRE) visit(node);
+    walkComplete<Bottom, Table>(base, Table ? base + (left - 1) : node->left, left, h - 1, n, kind, visit);
+    if (kind == IN) visit(node);
+    if (left + 1 <= n) {
+        int rightHeight = ((left + 1) << (h - 2)) > n ? h - 2 : h - 1;
+        walkComplete<Bottom, Table>(base, Table ? base + left : node->right, left + 1, rightHeight, n, kind, visit);
+    }
+    if (kind == POST) visit(node);
+}
+
+// 树是否为完全二叉树（层序中第 i 个节点的编号恰为 i），是则返回节点数
+template<typename Node>
+bool isComplete(const Node* root, size_t* count = nullptr) {
+    std::vector<std::pair<const Node*, size_t>> queue;
+    if (root) queue.push_back({root, 0});
+    for (size_t i = 0; i < queue.size(); i++) {
+        const Node* node = queue[i].first;
+        if (queue[i].second != i) return false;
+        if (node->left) queue.push_back({node->left, 2 * i + 1});
+        if (node->right) queue.push_back({node->right, 2 * i + 2});
+    }
+    if (count) *count = queue.size();
+    return true;
+}
+
+/*
+* 完全二叉树（autoCreateTree、buildCompleteParallel、并发插入的结果）的先序/中序/后序遍历，
+* 底部高度不超过 Bottom 的满子树用展开的内核。useTable 为真且节点区按层序存放时，
+* 满子树按编译期排列表直接定位节点，不读孩子指针；否则沿指针展开
+* 调用方须保证树是完全二叉树（可用 isComplete 检查）；层序没有特化版本，改用普通遍历
+*/
+template<int Bottom = 4, typename T, typename LinkPolicy>
+TraversalStats traverseComplete(BinaryTree<T, LinkPolicy>& tree, TraversalClass kind, bool useTable,
+                                void (*visit)(TreeNode<T, LinkPolicy>*)) {
+    static_assert(Bottom >= 1 && Bottom <= 16, "Bottom 须在 1..16");
+    typedef TreeNode<T, LinkPolicy> Node;
+    if (kind == LEVEL) return tree.Traversal(LEVEL, false, visit);
+
+    int height;
+    size_t n;
+    tree.shape(height, n);
+    Node* root = const_cast<Node*>(tree.getRoot());
+    bool table = useTable && tree.storageKind() == STORAGE_LEVEL_ARENA;
+
+    TraversalStats stats;
+    const BenchClock& clock = BenchClock::instance();
+    uint64_t start = clock.now();
+    if (root) {
+        if (table) {
+            walkComplete<Bottom, true>(root, root, 1, height, n, kind, visit);
+        } else {
+            walkComplete<Bottom, false>(root, root, 1, height, n, kind, visit);
+        }
+    }
+    uint64_t end = clock.now();
+
+    stats.setTiming(clock.elapsedNs(start, end), n);
+    // 上层递归最多 height - Bottom 层，底部内核内联后不占额外调用帧
+    stats.max_stack_depth = std::max(height - Bottom, 0);
+    stats.memory_usage = stats.max_stack_depth * sizeof(Node*) * 2;
+    return stats;
+}
+
+} // namespace fixedtree
+
+/*
+* 编译期固定节点数的完全二叉树：数据按层序放在 std::array 中，不存指针，
+* 遍历按 CompleteOrder<N> 的排列表顺序读取，没有分支也没有栈。适合图形界面里的小树和固定形状的工作片段
+*/
+template<typename T, size_t N>
+class FixedCompleteTree {
+public:
+    FixedCompleteTree() : values{} {}
+
+    // 从完全二叉树按层序复制；树不是完全二叉树或节点数不等于 N 时返回 false
+    bool assign(const BinaryTree<T>& tree) {
+        size_t count;
+        if (!fixedtree::isComplete(tree.getRoot(), &count) || count != N) return false;
+        size_t i = 0;
+        tree.forEach(LEVEL, [&](const TreeNode<T>* node) { values[i++] = node->data; });
+        return true;
+    }
+
+    T& operator[](size_t index) { return values[index]; }
+    const T& operator[](size_t index) const { return values[index]; }
+    static constexpr size_t size() { return N; }
+
+    template<typename Visit>
+    void forEach(TraversalClass kind, Visit&& visit) const {
+        for (uint32_t index : fixedtree::CompleteOrder<N>::of(kind)) visit(values[index]);
+    }
+
+    TraversalStats Traversal(TraversalClass kind, void (*visit)(const T&)) const {
+        TraversalStats stats;
+        const BenchClock& clock = BenchClock::instance();
+        uint64_t start = clock.now();
+        forEach(kind, visit);
+        uint64_t end = clock.now();
+        stats.setTiming(clock.elapsedNs(start, end), N);
+        return stats;
+    }
+
+private:
+    std::array<T, N> values;
+};
+
+#endif // FIXEDTREE_H
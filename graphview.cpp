@@ -35,7 +35,8 @@ MyGraphicsView::MyGraphicsView()
 //清除所有动画->恢复所有外观->清除场景和变量->创建初始节点
 void MyGraphicsView::init()
 {
-    // 停止并清空动画队列animation queue
+    // 停止并清空动画队列animation queue，排队中的动画尚未启动，需要手动释放
+    qDeleteAll(aniQueue);
     aniQueue.clear();
     onAni = false;
     if(curAni) {
@@ -72,7 +73,8 @@ void MyGraphicsView::init()
 //仅重置
 void MyGraphicsView::resetAllNodeStates()
 {
-    // 停止当前动画
+    // 停止当前动画，释放排队中的动画
+    qDeleteAll(aniQueue);
     aniQueue.clear();
     onAni = false;
     if (curAni) {
@@ -587,32 +589,61 @@ void MyGraphicsView::nextAni(){
     }
 }
 
+// 遍历轨迹：一步容器操作作为一个短动画排队，开始播放时通知容器面板
+void MyGraphicsView::addTraceStep(int lane, int op, const QString &label){
+    QTimeLine *step = new QTimeLine(120, this);
+    connect(step, &QTimeLine::stateChanged, this, [=](QTimeLine::State state){
+        if(state == QTimeLine::Running)
+            emit traceStep(lane, op, label);
+    });
+    addAnimation(step);
+}
+
+//递归进入：调用栈压入一帧
+void MyGraphicsView::enterFrame(const QString &label){
+    recDepth++;
+    if(recDepth > maxRecDepth) maxRecDepth = recDepth;
+    addTraceStep(0, TRACE_PUSH, label);
+}
+
+//递归返回：调用栈弹出一帧
+void MyGraphicsView::leaveFrame(){
+    recDepth--;
+    addTraceStep(0, TRACE_POP, QString());
+}
+
 /*————三种递归的辅助函数————*/
 /*————————————————*/
 //先序递归辅助函数
 void MyGraphicsView::preRecHelper(MyGraphicsVexItem* node) {
     if(!node)
         return;
+    enterFrame("pre(" + node->nameText + ")");
     addAnimation(node->visit());
     preRecHelper(node->left);
     preRecHelper(node->right);
+    leaveFrame();
 }
 
 //中序递归辅助函数
 void MyGraphicsView::inRecHelper(MyGraphicsVexItem* node) {
     if(!node)
         return;
+    enterFrame("in(" + node->nameText + ")");
     inRecHelper(node->left);
     addAnimation(node->visit());
     inRecHelper(node->right);
+    leaveFrame();
 }
 
 //后序递归辅助函数
 void MyGraphicsView::posRecHelper(MyGraphicsVexItem* node) {
     if(!node) return;
+    enterFrame("pos(" + node->nameText + ")");
     posRecHelper(node->left);
     posRecHelper(node->right);
     addAnimation(node->visit());
+    leaveFrame();
 }
 
 /*————————————————*/
@@ -621,103 +652,196 @@ void MyGraphicsView::posRecHelper(MyGraphicsVexItem* node) {
 
 //先序递归
 void MyGraphicsView::preRecursive(MyGraphicsVexItem* head) {
+    emit traceReset("先序递归：调用栈深度不超过树高 h", {"调用栈"});
+    recDepth = maxRecDepth = 0;
     preRecHelper(head);
-    emit reportStats("先序递归模式 (动画演示中)");
+    emit reportStats(QString("先序递归 | 最大调用深度: %1").arg(maxRecDepth));
 }
 
 //先序非递归
 void MyGraphicsView::pre(MyGraphicsVexItem * head)
 {
+    emit traceReset("先序非递归：显式栈", {"栈 s"});
     if(head == nullptr) return;
     QStack<MyGraphicsVexItem*> s;
     s.push(head);
+    addTraceStep(0, TRACE_PUSH, head->nameText);
     int maxStack = 0;
 
     while(!s.empty()) {
         if(s.size() > maxStack) maxStack = s.size();
         head = s.top();
         s.pop();
+        addTraceStep(0, TRACE_POP, head->nameText);
         addAnimation(head->visit());
-        if(head->right) s.push(head->right);
-        if(head->left) s.push(head->left);
+        if(head->right) {
+            s.push(head->right);
+            addTraceStep(0, TRACE_PUSH, head->right->nameText);
+        }
+        if(head->left) {
+            s.push(head->left);
+            addTraceStep(0, TRACE_PUSH, head->left->nameText);
+        }
     }
     emit reportStats(QString("先序非递归 | 最大栈深: %1").arg(maxStack));
 }
 
 //中序递归
 void MyGraphicsView::inRecursive(MyGraphicsVexItem* head) {
+    emit traceReset("中序递归：调用栈深度不超过树高 h", {"调用栈"});
+    recDepth = maxRecDepth = 0;
     inRecHelper(head);
-    emit reportStats("中序递归模式 (动画演示中)");
+    emit reportStats(QString("中序递归 | 最大调用深度: %1").arg(maxRecDepth));
 }
 
 
 //中序非递归
 void MyGraphicsView::in(MyGraphicsVexItem * head)
 {
+    emit traceReset("中序非递归：显式栈", {"栈 s"});
     if(head == nullptr) return;
     QStack<MyGraphicsVexItem*> s;
     int maxStack = 0;
     while(!s.empty() || head!=nullptr) {
-        if(s.size() > maxStack) maxStack = s.size();
         if(head!=nullptr) {
             s.push(head);
+            addTraceStep(0, TRACE_PUSH, head->nameText);
             head = head->left;
         } else {
             head = s.top();
             s.pop();
+            addTraceStep(0, TRACE_POP, head->nameText);
             addAnimation(head->visit());
             head = head->right;
         }
+        if(s.size() > maxStack) maxStack = s.size();
     }
     emit reportStats(QString("中序非递归 | 最大栈深: %1").arg(maxStack));
 }
 
 //后序递归
 void MyGraphicsView::posRecursive(MyGraphicsVexItem* head) {
+    emit traceReset("后序递归：调用栈深度不超过树高 h", {"调用栈"});
+    recDepth = maxRecDepth = 0;
     posRecHelper(head);
-    emit reportStats("后序递归模式 (动画演示中)");
+    emit reportStats(QString("后序递归 | 最大调用深度: %1").arg(maxRecDepth));
 }
 
-//后序非递归
+//后序非递归（双栈法）
+//收集栈 col 在输出前会装下全部 n 个节点，因此空间为 O(n)
 void MyGraphicsView::pos(MyGraphicsVexItem * head)
 {
+    emit traceReset("后序非递归（双栈法）：col 收集全部节点，O(n)", {"栈 s", "收集栈 col"});
     if(head == nullptr)
         return;
     QStack<MyGraphicsVexItem*> s;
     QStack<MyGraphicsVexItem*> col;
     s.push(head);
+    addTraceStep(0, TRACE_PUSH, head->nameText);
     int maxStack = 0;
     while(!s.empty()) {
         if(s.size() > maxStack) maxStack = s.size();
         head = s.top();
         s.pop();
+        addTraceStep(0, TRACE_POP, head->nameText);
         col.push(head);
-        if(head->left) s.push(head->left);
-        if(head->right) s.push(head->right);
+        addTraceStep(1, TRACE_PUSH, head->nameText);
+        if(head->left) {
+            s.push(head->left);
+            addTraceStep(0, TRACE_PUSH, head->left->nameText);
+        }
+        if(head->right) {
+            s.push(head->right);
+            addTraceStep(0, TRACE_PUSH, head->right->nameText);
+        }
     }
+    int maxCol = col.size();
     while(!col.empty()) {
+        addTraceStep(1, TRACE_POP, col.top()->nameText);
         addAnimation(col.top()->visit());
         col.pop();
     }
-    emit reportStats(QString("后序非递归 | 最大栈深: %1 (双栈法)").arg(maxStack));
+    emit reportStats(QString("后序非递归 | 最大栈深: %1 | col: %2 (双栈法)").arg(maxStack).arg(maxCol));
+}
+
+//后序非递归（单栈法）
+//与 BinaryTree::postorderNonRecursive 相同：栈中只保存当前路径，空间为 O(h)
+void MyGraphicsView::posSingleStack(MyGraphicsVexItem* head)
+{
+    emit traceReset("后序非递归（单栈法）：栈中只有根到当前节点的路径，O(h)", {"栈 s"});
+    if(head == nullptr)
+        return;
+    QStack<MyGraphicsVexItem*> s;
+    MyGraphicsVexItem* lastVisited = nullptr;
+    int maxStack = 0;
+    while(head != nullptr || !s.empty()) {
+        while(head != nullptr) {
+            s.push(head);
+            addTraceStep(0, TRACE_PUSH, head->nameText);
+            head = head->left;
+        }
+        if(s.size() > maxStack) maxStack = s.size();
+
+        MyGraphicsVexItem* peek = s.top();
+        if(peek->right && lastVisited != peek->right) {
+            head = peek->right;
+        } else {
+            s.pop();
+            addTraceStep(0, TRACE_POP, peek->nameText);
+            addAnimation(peek->visit());
+            lastVisited = peek;
+        }
+    }
+    emit reportStats(QString("后序非递归 | 最大栈深: %1 (单栈法)").arg(maxStack));
 }
 
 
 //层序遍历
 void MyGraphicsView::levelOrder(MyGraphicsVexItem* head)
 {
+    emit traceReset("层序遍历：队列最长为最宽一层", {"队列 q"});
     if(head == nullptr) return;
     QQueue<MyGraphicsVexItem*> q;
     q.enqueue(head);
+    addTraceStep(0, TRACE_ENQUEUE, head->nameText);
     int maxQ = 0;
     while(!q.empty()) {
         if(q.size() > maxQ) maxQ = q.size();
         MyGraphicsVexItem* cur = q.dequeue();
+        addTraceStep(0, TRACE_DEQUEUE, cur->nameText);
         addAnimation(cur->visit());
-        if(cur->left) q.enqueue(cur->left);
-        if(cur->right) q.enqueue(cur->right);
+        if(cur->left) {
+            q.enqueue(cur->left);
+            addTraceStep(0, TRACE_ENQUEUE, cur->left->nameText);
+        }
+        if(cur->right) {
+            q.enqueue(cur->right);
+            addTraceStep(0, TRACE_ENQUEUE, cur->right->nameText);
+        }
     }
     emit reportStats(QString("层序遍历 | 最大队列长度: %1").arg(maxQ));
 }
 
 /*———————递归算法完毕———————*/
+
+// 导出手绘树：沿 left/right 关系逐个复制为 TreeNode<int>
+BinaryTree<int>* MyGraphicsView::exportBinaryTree() const
+{
+    BinaryTree<int>* tree = new BinaryTree<int>();
+    if(root == nullptr) return tree;
+
+    TreeNode<int>* newRoot = nullptr;
+    QStack<QPair<MyGraphicsVexItem*, TreeNode<int>**>> s;
+    s.push(qMakePair(root, &newRoot));
+    while(!s.empty()) {
+        QPair<MyGraphicsVexItem*, TreeNode<int>**> item = s.pop();
+        MyGraphicsVexItem* vex = item.first;
+        // 名称形如 "V12"，取编号作为节点值
+        TreeNode<int>* node = new TreeNode<int>(vex->nameText.mid(1).toInt());
+        *item.second = node;
+        if(vex->right) s.push(qMakePair(vex->right, &node->right));
+        if(vex->left) s.push(qMakePair(vex->left, &node->left));
+    }
+    tree->setRoot(newRoot);
+    return tree;
+}
@@ -14,6 +14,8 @@
 #include <QQueue>
 #include <QDebug>
 #include <graphicsVexItem.h>
+#include "containerview.h"
+#include "BinaryTree.cpp"
 
 class MyGraphicsView;
 class MyGraphicsLineItem;
@@ -67,6 +69,8 @@ private:
     qreal speedRate = 2.0; // 动画速度
     void nextAni();
     void addAnimation(QTimeLine *ani);
+    // 把一步容器操作排入动画队列，轮到它时发出 traceStep，与节点访问保持同步
+    void addTraceStep(int lane, int op, const QString &label);
 
     QVector<MyGraphicsVexItem*> vexes;
     // QVector<MyGraphicsVexItem*> preVexes;
@@ -75,6 +79,12 @@ private:
     // QVector<MyGraphicsVexItem*> nullVexes;
     QVector<MyGraphicsLineItem*> leafLines;
 
+    // 递归调用深度（用于统计调用栈峰值）
+    int recDepth = 0;
+    int maxRecDepth = 0;
+    void enterFrame(const QString &label);
+    void leaveFrame();
+
     // 递归辅助函数
     void preRecHelper(MyGraphicsVexItem* node);
     void inRecHelper(MyGraphicsVexItem* node);
@@ -98,14 +108,21 @@ public:
     void in(MyGraphicsVexItem * head);         // 非递归
     void inRecursive(MyGraphicsVexItem* head); // 递归
 
-    void pos(MyGraphicsVexItem * head);        // 非递归
+    void pos(MyGraphicsVexItem * head);        // 非递归（双栈法）
+    void posSingleStack(MyGraphicsVexItem* head); // 非递归（单栈法）
     void posRecursive(MyGraphicsVexItem* head);// 递归
 
     void levelOrder(MyGraphicsVexItem* head);  // 层序遍历 (非递归)
 
+    // 把手绘的树导出为 BinaryTree<int>（调用者负责释放），节点值为顶点编号
+    BinaryTree<int>* exportBinaryTree() const;
+
 signals:
     // 发送统计数据给 MainWindow 显示
     void reportStats(QString desc);
+    // 遍历轨迹：开始新的遍历 / 容器的一步增量操作
+    void traceReset(QString title, QStringList laneNames);
+    void traceStep(int lane, int op, QString label);
 };
 
 
@@ -1,9 +1,15 @@
 #include "mainwindow.h"
+#include "benchcli.h"
 
 #include <QApplication>
 
 int main(int argc, char *argv[])
 {
+    // 命令行基准测试模式，不创建窗口
+    if (isBenchCliRequested(argc, argv)) {
+        return runBenchCli(argc, argv);
+    }
+
     QApplication a(argc, argv);
     MainWindow w;
     w.show();
@@ -54,11 +54,13 @@ void MainWindow::setupUiCustom()
     QPushButton *btnAuto = new QPushButton("自动生成 (完全二叉树)");
     QPushButton *btnClear = new QPushButton("清空画布");
     QPushButton *btnManual = new QPushButton("手动模式");
+    QPushButton *btnExport = new QPushButton("导出形状到性能分析");
 
     formGen->addRow("节点数:", editNodeNum);
     formGen->addRow(btnAuto);
     formGen->addRow(btnClear);
     formGen->addRow(btnManual);
+    formGen->addRow(btnExport);
 
     ctrlLayout->addWidget(boxGen);
 
@@ -66,7 +68,7 @@ void MainWindow::setupUiCustom()
     QGroupBox *boxRun = new QGroupBox("2. 遍历演示");
     QVBoxLayout *layoutRun = new QVBoxLayout(boxRun);
     comboTraversal = new QComboBox();
-    comboTraversal->addItems({"先序遍历", "中序遍历", "后序遍历", "层序遍历"});
+    comboTraversal->addItems({"先序遍历", "中序遍历", "后序遍历", "层序遍历", "后序遍历 (单栈)"});
     checkRecursive = new QCheckBox("递归模式");
     checkRecursive->setChecked(true);
     QPushButton *btnRunVis = new QPushButton("运行动画");
@@ -81,6 +83,15 @@ void MainWindow::setupUiCustom()
     labelStats = new QLabel("等待运行...");
     layoutStats->addWidget(labelStats);
     ctrlLayout->addWidget(boxStats);
+
+    //第四块：栈 / 队列 / 调用栈的实时内容
+    QGroupBox *boxTrace = new QGroupBox("4. 容器状态");
+    QVBoxLayout *layoutTrace = new QVBoxLayout(boxTrace);
+    containerView = new MyContainerView();
+    layoutTrace->addWidget(containerView);
+    ctrlLayout->addWidget(boxTrace);
+    connect(gv, &MyGraphicsView::traceReset, containerView, &MyContainerView::resetTrace);
+    connect(gv, &MyGraphicsView::traceStep, containerView, &MyContainerView::applyStep);
     ctrlLayout->addStretch();
 
     //将控制面板添加到水平布局，拉伸因子为3（占据3/10的空间）
@@ -131,6 +142,7 @@ void MainWindow::setupUiCustom()
     connect(btnAuto, &QPushButton::clicked, this, &MainWindow::onAutoGenerate);
     connect(btnClear, &QPushButton::clicked, this, [=](){ gv->init(); });
     connect(btnRunVis, &QPushButton::clicked, this, &MainWindow::onRunVisual);
+    connect(btnExport, &QPushButton::clicked, this, &MainWindow::onExportShape);
 
     connect(btnAuto, &QPushButton::clicked, this, &MainWindow::onAutoGenerate);
     connect(btnClear, &QPushButton::clicked, this, [=](){ gv->init(); });
@@ -154,6 +166,15 @@ void MainWindow::onAutoGenerate() {
     labelStats->setText("生成完毕");
 }
 
+//把手绘的树形状交给性能分析页，作为平铺模板
+void MainWindow::onExportShape() {
+    BinaryTree<int>* shape = gv->exportBinaryTree();
+    size_t n = shape->countNodes();
+    int h = shape->height();
+    chartView->setPatternTree(shape);
+    labelStats->setText(QString("已导出形状：%1 个节点，高度 %2").arg(n).arg(h));
+}
+
 //开始运行
 void MainWindow::onRunVisual() {
 
@@ -172,6 +193,8 @@ void MainWindow::onRunVisual() {
         isRec ? gv->posRecursive(gv->root) : gv->pos(gv->root);
     else if(type==3)    //TODO:递归？
         gv->levelOrder(gv->root);
+    else if(type==4)    //单栈后序，与双栈法对比空间占用
+        gv->posSingleStack(gv->root);
 }
 
 //改变统计标签显示
@@ -47,6 +47,7 @@ private:
     QComboBox *comboTraversal;
     QCheckBox *checkRecursive;
     QLabel *labelStats;
+    MyContainerView *containerView;
 
     // Tab 2 控件
     QLineEdit *editDataSize;
@@ -64,6 +65,7 @@ private:
 
 private slots:
     void onAutoGenerate();
+    void onExportShape();
     void onRunVisual();
     void onRunPerformance();
     void onRunTrend();
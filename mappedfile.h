@@ -0,0 +1,94 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define MAPPEDFILE_HAS_MMAP 1
+#endif
+
+// 只读映射的整个文件；POSIX 上使用 mmap，其它平台整体读入内存
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // sequential 为 true 时提示内核按顺序预读
+    bool open(const std::string& filename, bool sequential = false, std::string* error = nullptr) {
+        close();
+#ifdef MAPPEDFILE_HAS_MMAP
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+            if (error) *error = "无法打开文件 " + filename;
+            return false;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0) {
+            ::close(fd);
+            if (error) *error = "文件为空或无法读取大小 " + filename;
+            return false;
+        }
+        void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) {
+            if (error) *error = "mmap 失败 " + filename;
+            return false;
+        }
+        if (sequential) madvise(p, st.st_size, MADV_SEQUENTIAL);
+        base = static_cast<const char*>(p);
+        length = st.st_size;
+        return true;
+#else
+        (void)sequential;
+        FILE* file = std::fopen(filename.c_str(), "rb");
+        if (!file) {
+            if (error) *error = "无法打开文件 " + filename;
+            return false;
+        }
+        std::fseek(file, 0, SEEK_END);
+        long size = std::ftell(file);
+        std::fseek(file, 0, SEEK_SET);
+        buffer.resize(size > 0 ? size : 0);
+        bool ok = size > 0 && std::fread(buffer.data(), buffer.size(), 1, file) == 1;
+        std::fclose(file);
+        if (!ok) {
+            if (error) *error = "文件为空或读取失败 " + filename;
+            buffer.clear();
+            return false;
+        }
+        base = buffer.data();
+        length = buffer.size();
+        return true;
+#endif
+    }
+
+    void close() {
+#ifdef MAPPEDFILE_HAS_MMAP
+        if (base) munmap(const_cast<char*>(base), length);
+#endif
+        buffer.clear();
+        buffer.shrink_to_fit();
+        base = nullptr;
+        length = 0;
+    }
+
+    bool isOpen() const { return base != nullptr; }
+    const char* data() const { return base; }
+    size_t size() const { return length; }
+
+private:
+    const char* base = nullptr;
+    size_t length = 0;
+    std::vector<char> buffer;    // 无 mmap 时的后备存储
+};
+
+#endif // MAPPEDFILE_H
@@ -0,0 +1,649 @@
+#ifndef PAGEDTREE_H
+#define PAGEDTREE_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+#include "BinaryTree.cpp"
+#include "treefile.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define PAGEDTREE_HAS_PREAD 1
+#endif
+
+/*
+* 分页存储的二叉树（树比内存大时使用）
+* 文件由定长页组成，按子树聚簇：从片段根开始按层次收节点直到子树装完或页满，
+* 装不下的孩子成为后续片段的根；片段按先序依次装页，小子树与前一个片段共用一页，
+* 因此深度优先遍历基本顺序访问文件
+* 遍历只通过容量固定的 LRU 页缓存读取节点，常驻内存 = 缓存 + O(h) 栈（层序为 O(宽度) 队列）
+*
+* 文件格式（小端，版本 1）：
+* [PagedTreeHeader]  占第 0 页
+* [页 x pageCount]   每页 nodesPerPage 个 PagedRecord；节点编号 = 页号 * nodesPerPage + 页内位置，根为 0
+*/
+
+struct PagedTreeHeader {
+    char magic[8];           // "BTPAGE1\0"
+    uint32_t version;
+    uint32_t payloadSize;    // sizeof(T)
+    uint32_t pageSize;
+    uint32_t nodesPerPage;
+    uint64_t nodeCount;
+    uint64_t pageCount;
+    uint8_t reserved[24];
+};
+static_assert(sizeof(PagedTreeHeader) == 64, "PagedTreeHeader 必须为 64 字节");
+
+template<typename T>
+struct PagedRecord {
+    TreeLink link;
+    T data;
+};
+
+// 页缓存统计
+struct PageCacheStats {
+    uint64_t accesses = 0;        // 节点访问次数
+    uint64_t hits = 0;            // 命中缓存
+    uint64_t faults = 0;          // 缺页（需要读盘）
+    uint64_t readaheadPages = 0;  // 预读进来的页
+    uint64_t readaheadUsed = 0;   // 预读的页在被淘汰前用到了
+    uint64_t evictions = 0;
+    uint64_t readCalls = 0;       // 读盘系统调用次数
+    uint64_t bytesRead = 0;
+
+    double hitRatio() const { return accesses ? double(hits) / accesses : 0.0; }
+};
+
+namespace pagedtree {
+
+static const char kMagic[8] = {'B', 'T', 'P', 'A', 'G', 'E', '1', '\0'};
+static const uint32_t kVersion = 1;
+static const uint32_t kDefaultPageSize = 4096;
+
+// 把 BinaryTree 按子树聚簇分页写出；构建时整棵树在内存中，遍历时不需要
+template<typename T>
+bool save(const BinaryTree<T>& tree, const std::string& filename, uint32_t pageSize = kDefaultPageSize,
+          std::string* error = nullptr) {
+    static_assert(std::is_trivially_copyable<T>::value, "分页文件只支持可平凡复制的节点数据");
+    const uint32_t perPage = pageSize / sizeof(PagedRecord<T>);
+    if (perPage < 2) {
+        if (error) *error = "页太小";
+        return false;
+    }
+
+    // 待分页的片段根，以及它在父节点中的链接位置（用于回填编号）
+    struct Pending {
+        const TreeNode<T>* node;
+        int64_t parent;      // 父节点记录下标，-1 表示整棵树的根
+        bool isRight;
+    };
+    std::vector<PagedRecord<T>> records;
+    std::vector<Pending> stack;
+    std::vector<Pending> spill;
+    std::vector<const TreeNode<T>*> fragment;
+
+    if (tree.getRoot()) stack.push_back({tree.getRoot(), -1, false});
+    size_t base = 0;
+    size_t fill = perPage;    // 当前页已用的位置数，初始视为已满
+    while (!stack.empty()) {
+        Pending top = stack.back();
+        stack.pop_back();
+
+        // 当前页还有空位时，下一个片段接着装在同一页里，小子树不会各占一页
+        if (fill == perPage) {
+            base = records.size();
+            if (base + perPage > size_t(INT32_MAX)) {
+                if (error) *error = "节点数超过上限";
+                return false;
+            }
+            records.resize(base + perPage);
+            for (size_t i = base; i < records.size(); i++) {
+                records[i].link = {-1, -1};
+                records[i].data = T();
+            }
+            fill = 0;
+        }
+        if (top.parent >= 0) {
+            TreeLink& link = records[top.parent].link;
+            (top.isRight ? link.right : link.left) = static_cast<int32_t>(base + fill);
+        }
+
+        // 从片段根按层次装，直到子树装完或页满
+        fragment.assign(1, top.node);
+        size_t first = base + fill;
+        fill++;
+        spill.clear();
+        for (size_t i = 0; i < fragment.size(); i++) {
+            const TreeNode<T>* node = fragment[i];
+            PagedRecord<T>& record = records[first + i];
+            record.data = node->data;
+            const TreeNode<T>* children[2] = {node->left, node->right};
+            int32_t* slots[2] = {&record.link.left, &record.link.right};
+            for (int c = 0; c < 2; c++) {
+                if (!children[c]) continue;
+                if (fill < perPage) {
+                    *slots[c] = static_cast<int32_t>(base + fill);
+                    fill++;
+                    fragment.push_back(children[c]);
+                } else {
+                    spill.push_back({children[c], static_cast<int64_t>(first + i), c == 1});
+                }
+            }
+        }
+        // 溢出的孩子按从左到右的顺序成为后续片段，逆序入栈
+        for (auto it = spill.rbegin(); it != spill.rend(); ++it) stack.push_back(*it);
+    }
+
+    PagedTreeHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.payloadSize = sizeof(T);
+    header.pageSize = pageSize;
+    header.nodesPerPage = perPage;
+    header.nodeCount = tree.countNodes();
+    header.pageCount = records.size() / perPage;
+
+    FILE* file = std::fopen(filename.c_str(), "wb");
+    if (!file) {
+        if (error) *error = "无法创建文件 " + filename;
+        return false;
+    }
+    std::vector<char> page(pageSize, 0);
+    std::memcpy(page.data(), &header, sizeof(header));
+    bool ok = std::fwrite(page.data(), pageSize, 1, file) == 1;
+    for (uint64_t p = 0; ok && p < header.pageCount; p++) {
+        std::memset(page.data(), 0, pageSize);
+        std::memcpy(page.data(), &records[p * perPage], perPage * sizeof(PagedRecord<T>));
+        ok = std::fwrite(page.data(), pageSize, 1, file) == 1;
+    }
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok && error) *error = "写入失败 " + filename;
+    return ok;
+}
+
+} // namespace pagedtree
+
+// 容量固定的 LRU 页缓存；读盘时按预读策略一次读入连续的多页
+class PageCache {
+public:
+    PageCache() = default;
+    ~PageCache() { close(); }
+
+    PageCache(const PageCache&) = delete;
+    PageCache& operator=(const PageCache&) = delete;
+
+    // dataOffset 为第 0 页在文件中的偏移；dropOsCache 为 true 时让内核丢弃该文件的页缓存（冷启动）
+    bool open(const std::string& filename, uint64_t dataOffset, uint32_t pageSize, uint64_t pageCount,
+              size_t capacityPages, bool dropOsCache, std::string* error) {
+        close();
+#ifdef PAGEDTREE_HAS_PREAD
+        fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+#else
+        file = std::fopen(filename.c_str(), "rb");
+        if (!file) {
+#endif
+            if (error) *error = "无法打开文件 " + filename;
+            return false;
+        }
+        // 头部声明的页必须都在文件里，否则读到文件尾之后
+        uint64_t fileSize = 0;
+#ifdef PAGEDTREE_HAS_PREAD
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0) fileSize = uint64_t(st.st_size);
+#else
+        if (std::fseek(file, 0, SEEK_END) == 0) {
+            long end = std::ftell(file);
+            fileSize = end > 0 ? uint64_t(end) : 0;
+        }
+#endif
+        if (pageSize == 0 || fileSize < dataOffset || pageCount > (fileSize - dataOffset) / pageSize) {
+            close();
+            if (error) *error = "文件长度与页数不符: " + filename;
+            return false;
+        }
+#if defined(PAGEDTREE_HAS_PREAD) && defined(POSIX_FADV_DONTNEED)
+        if (dropOsCache) posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+#else
+        (void)dropOsCache;
+#endif
+        offset = dataOffset;
+        size = pageSize;
+        count = pageCount;
+        capacity = std::max<size_t>(capacityPages, 2);
+        frames.assign(capacity * size, 0);
+        framePage.assign(capacity, -1);
+        prev.assign(capacity, -1);
+        next.assign(capacity, -1);
+        prefetched.assign(capacity, 0);
+        pageFrame.assign(count, -1);
+        head = tail = -1;
+        used = 0;
+        lastPage = -1;
+        lastFrame = nullptr;
+        stats = PageCacheStats();
+        failure.clear();
+        return true;
+    }
+
+    void close() {
+#ifdef PAGEDTREE_HAS_PREAD
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+#else
+        if (file) std::fclose(file);
+        file = nullptr;
+#endif
+        std::vector<char>().swap(frames);
+        std::vector<int32_t>().swap(pageFrame);
+    }
+
+    void setReadahead(size_t pages) { readahead = pages; }
+    size_t capacityPages() const { return capacity; }
+    size_t memoryBytes() const { return frames.size() + pageFrame.size() * sizeof(int32_t); }
+    const PageCacheStats& statistics() const { return stats; }
+    const std::string& lastError() const { return failure; }
+
+    bool resident(int64_t p) const { return p == lastPage || pageFrame[p] >= 0; }
+
+    // 取页内容；返回的指针在下一次 page() 之前有效，读盘失败时返回 nullptr，原因见 lastError()
+    // upcoming 为层序遍历接下来要访问的页，缺页时按它预读，否则按文件顺序预读
+    const char* page(int64_t p, const std::vector<int64_t>* upcoming = nullptr) {
+        stats.accesses++;
+        if (p == lastPage) {
+            stats.hits++;
+            return lastFrame;
+        }
+        int32_t f = pageFrame[p];
+        if (f >= 0) {
+            stats.hits++;
+            if (prefetched[f]) {
+                prefetched[f] = 0;
+                stats.readaheadUsed++;
+            }
+            touch(f);
+        } else {
+            stats.faults++;
+            f = load(p, upcoming);
+            if (f < 0) return nullptr;
+        }
+        lastPage = p;
+        lastFrame = frames.data() + size_t(f) * size;
+        return lastFrame;
+    }
+
+    size_t readaheadPages() const { return std::min(readahead, capacity / 2); }
+
+private:
+#ifdef PAGEDTREE_HAS_PREAD
+    int fd = -1;
+#else
+    FILE* file = nullptr;
+#endif
+    uint64_t offset = 0;
+    uint32_t size = 0;
+    uint64_t count = 0;
+    size_t capacity = 0;
+    size_t used = 0;
+    size_t readahead = 0;
+
+    std::vector<char> frames;
+    std::vector<int64_t> framePage;    // 帧中存放的页号，-1 为空
+    std::vector<int32_t> prev, next;   // LRU 双向链表，head 为最近使用
+    std::vector<uint8_t> prefetched;   // 预读进来且尚未用到
+    std::vector<int32_t> pageFrame;    // 页号 -> 帧号，-1 表示不在缓存中
+    int32_t head = -1, tail = -1;
+    std::vector<char> runBuffer;
+    std::vector<int64_t> pages;
+
+    int64_t lastPage = -1;
+    const char* lastFrame = nullptr;
+    PageCacheStats stats;
+    std::string failure;
+
+    void unlink(int32_t f) {
+        if (prev[f] >= 0) next[prev[f]] = next[f]; else head = next[f];
+        if (next[f] >= 0) prev[next[f]] = prev[f]; else tail = prev[f];
+        prev[f] = next[f] = -1;
+    }
+
+    void pushFront(int32_t f) {
+        prev[f] = -1;
+        next[f] = head;
+        if (head >= 0) prev[head] = f;
+        head = f;
+        if (tail < 0) tail = f;
+    }
+
+    void touch(int32_t f) {
+        if (f == head) return;
+        unlink(f);
+        pushFront(f);
+    }
+
+    // 取一个空帧，缓存满时淘汰最久未用的页（不淘汰 keep）
+    int32_t allocFrame(int32_t keep) {
+        int32_t f;
+        if (used < capacity) {
+            f = static_cast<int32_t>(used++);
+        } else {
+            f = tail;
+            if (f == keep) f = prev[f];
+            unlink(f);
+            pageFrame[framePage[f]] = -1;
+            if (framePage[f] == lastPage) lastPage = -1;
+            stats.evictions++;
+        }
+        pushFront(f);
+        return f;
+    }
+
+    // 读入 [first, first + n) 这一段连续页，一次系统调用
+    bool readRun(int64_t first, size_t n, char* dst) {
+        stats.readCalls++;
+        stats.bytesRead += n * size;
+        uint64_t pos = offset + uint64_t(first) * size;
+#ifdef PAGEDTREE_HAS_PREAD
+        size_t done = 0;
+        while (done < n * size) {
+            ssize_t r = pread(fd, dst + done, n * size - done, pos + done);
+            if (r <= 0) return false;
+            done += r;
+        }
+        return true;
+#else
+        return std::fseek(file, static_cast<long>(pos), SEEK_SET) == 0
+               && std::fread(dst, n * size, 1, file) == 1;
+#endif
+    }
+
+    // 把连续页放入缓存；预读的页标记为 prefetched，首次命中时计入 readaheadUsed
+    void install(int64_t first, size_t n, const char* src, int64_t demand, int32_t& demandFrame) {
+        for (size_t i = 0; i < n; i++) {
+            int64_t p = first + i;
+            if (pageFrame[p] >= 0) continue;
+            int32_t f = allocFrame(demandFrame);
+            std::memcpy(frames.data() + size_t(f) * size, src + i * size, size);
+            framePage[f] = p;
+            pageFrame[p] = f;
+            prefetched[f] = p != demand;
+            if (p == demand) {
+                demandFrame = f;
+            } else {
+                stats.readaheadPages++;
+            }
+        }
+    }
+
+    // 读入并装入 [first, first + n)；整段读失败时预读的页直接放弃，只单独重读 demand 所在的页
+    // 读失败的页不放入缓存，demand 读不到时记下原因，返回 false
+    bool loadRun(int64_t first, size_t n, int64_t demand, int32_t& demandFrame) {
+        runBuffer.resize(n * size);
+        if (readRun(first, n, runBuffer.data())) {
+            install(first, n, runBuffer.data(), demand, demandFrame);
+            return true;
+        }
+        if (demand < first || demand >= first + int64_t(n)) return true;
+        if (n > 1 && readRun(demand, 1, runBuffer.data())) {
+            install(demand, 1, runBuffer.data(), demand, demandFrame);
+            return true;
+        }
+        failure = "读取第 " + std::to_string(demand) + " 页失败";
+        return false;
+    }
+
+    // 预读不超过缓存的一半，避免把工作集挤出去；返回 demand 页所在的帧，读盘失败时返回 -1
+    int32_t load(int64_t p, const std::vector<int64_t>* upcoming) {
+        size_t limit = readaheadPages();
+        int32_t demandFrame = -1;
+
+        if (!upcoming) {
+            // 深度优先：页按先序排列，顺带读入文件中紧随其后的页
+            size_t n = 1;
+            while (n <= limit && uint64_t(p + n) < count && pageFrame[p + n] < 0) n++;
+            if (!loadRun(p, n, p, demandFrame)) return -1;
+            touch(demandFrame);
+            return demandFrame;
+        }
+
+        // 层序：缺页本身加上接下来要访问的页，相邻页合并为一次读
+        pages.assign(1, p);
+        for (int64_t u : *upcoming) {
+            if (pages.size() > limit) break;
+            if (pageFrame[u] < 0 && std::find(pages.begin(), pages.end(), u) == pages.end()) pages.push_back(u);
+        }
+        std::sort(pages.begin(), pages.end());
+        for (size_t i = 0; i < pages.size();) {
+            size_t j = i + 1;
+            while (j < pages.size() && pages[j] == pages[j - 1] + 1) j++;
+            if (!loadRun(pages[i], j - i, p, demandFrame)) return -1;
+            i = j;
+        }
+        touch(demandFrame);
+        return demandFrame;
+    }
+};
+
+// 分页树：所有节点访问都经过 PageCache，可在内存上限远小于树的情况下遍历
+template<typename T>
+class PagedTree {
+public:
+    PagedTree() = default;
+
+    // cacheBytes 为页缓存的内存上限；readaheadPages 为每次缺页最多额外读入的页数
+    bool open(const std::string& filename, size_t cacheBytes, size_t readaheadPages = 8,
+              bool dropOsCache = true, std::string* error = nullptr) {
+        FILE* file = std::fopen(filename.c_str(), "rb");
+        if (!file) {
+            if (error) *error = "无法打开文件 " + filename;
+            return false;
+        }
+        bool ok = std::fread(&header, sizeof(header), 1, file) == 1;
+        std::fclose(file);
+
+        const char* reason = nullptr;
+        if (!ok || std::memcmp(header.magic, pagedtree::kMagic, 8) != 0) {
+            reason = "不是分页树文件";
+        } else if (header.version != pagedtree::kVersion) {
+            reason = "不支持的文件版本";
+        } else if (header.payloadSize != sizeof(T)) {
+            reason = "节点数据类型不匹配";
+        } else if (header.pageSize < sizeof(PagedTreeHeader) || header.nodesPerPage == 0
+                   || header.nodesPerPage * sizeof(PagedRecord<T>) > header.pageSize) {
+            reason = "页参数无效";
+        }
+        if (reason) {
+            if (error) *error = std::string(reason) + ": " + filename;
+            return false;
+        }
+
+        perPage = header.nodesPerPage;
+        // 页数已由 PageCache 按文件长度核对过，这里的乘法不会溢出
+        if (!cache.open(filename, header.pageSize, header.pageSize, header.pageCount,
+                        cacheBytes / header.pageSize, dropOsCache, error)) {
+            return false;
+        }
+        recordCount = header.pageCount * perPage;
+        if (header.nodeCount > recordCount || recordCount > uint64_t(INT32_MAX) + 1) {
+            cache.close();
+            if (error) *error = "节点数与页数不符: " + filename;
+            return false;
+        }
+        cache.setReadahead(readaheadPages);
+        return true;
+    }
+
+    size_t size() const { return header.nodeCount; }
+    uint64_t fileBytes() const { return uint64_t(header.pageCount + 1) * header.pageSize; }
+    const PageCache& pageCache() const { return cache; }
+
+    // 只有非递归版本；stats 中的缺页数与命中率只统计本次遍历
+    // 读盘失败或文件中的链接损坏（越界、成环）时停止遍历并返回 false，stats 只反映已走过的部分
+    bool Traversal(TraversalClass traversal_class, void (*visit)(const T&), TraversalStats& stats,
+                   PageCacheStats* cacheStats = nullptr, std::string* error = nullptr) {
+        stats = TraversalStats();
+        const BenchClock& clock = BenchClock::instance();
+        PageCacheStats before = cache.statistics();
+        size_t maxDepth = 0;
+        failure.clear();
+        uint64_t start = clock.now();
+
+        int32_t root = header.nodeCount ? 0 : -1;
+        if (traversal_class == LEVEL) {
+            maxDepth = levelorder(root, visit);
+            stats.max_queue_length = maxDepth;
+        } else {
+            maxDepth = iterative(traversal_class, root, visit);
+            stats.max_stack_depth = maxDepth;
+        }
+
+        uint64_t end = clock.now();
+        stats.setTiming(clock.elapsedNs(start, end), header.nodeCount);
+        stats.memory_usage = cache.memoryBytes() + maxDepth * sizeof(int32_t);
+
+        PageCacheStats delta = cache.statistics();
+        delta.accesses -= before.accesses;
+        delta.hits -= before.hits;
+        delta.faults -= before.faults;
+        delta.readaheadPages -= before.readaheadPages;
+        delta.readaheadUsed -= before.readaheadUsed;
+        delta.evictions -= before.evictions;
+        delta.readCalls -= before.readCalls;
+        delta.bytesRead -= before.bytesRead;
+        stats.page_faults = delta.faults;
+        stats.cache_hit_ratio = delta.hitRatio();
+        if (cacheStats) *cacheStats = delta;
+        if (!failure.empty() && error) *error = failure;
+        return failure.empty();
+    }
+
+private:
+    PagedTreeHeader header = {};
+    uint32_t perPage = 1;
+    uint64_t recordCount = 0;    // 文件中的记录位置数，节点编号须小于它
+    PageCache cache;
+    std::string failure;         // 本次遍历的错误，空表示正常
+
+    // 取节点记录；编号越界或读盘失败时记下原因并返回 nullptr
+    const PagedRecord<T>* recordAt(int32_t id, const std::vector<int64_t>* upcoming) {
+        if (id < 0 || uint64_t(id) >= recordCount) {
+            failure = "节点编号 " + std::to_string(id) + " 越界，文件已损坏";
+            return nullptr;
+        }
+        const char* p = cache.page(id / perPage, upcoming);
+        if (!p) {
+            failure = cache.lastError();
+            return nullptr;
+        }
+        return reinterpret_cast<const PagedRecord<T>*>(p) + id % perPage;
+    }
+
+    const PagedRecord<T>* record(int32_t id) { return recordAt(id, nullptr); }
+
+    // 正常的树里栈深和访问数都不超过节点数，超过说明链接成环；访问数在调用 visit 之前检查，回调不会超过 nodeCount 次
+    bool withinNodeCount(size_t n) {
+        if (n <= header.nodeCount) return true;
+        failure = "节点链接成环，文件已损坏";
+        return false;
+    }
+
+    // 与 FlatTreeView 相同的单栈算法，每次取节点都经过页缓存
+    size_t iterative(TraversalClass order, int32_t current, void (*visit)(const T&)) {
+        std::vector<int32_t> stack;
+        int32_t lastVisited = -1;
+        size_t maxDepth = 0;
+        size_t visited = 0;
+
+        while (current >= 0 || !stack.empty()) {
+            while (current >= 0) {
+                const PagedRecord<T>* r = record(current);
+                if (!r || !withinNodeCount(stack.size() + 1)) return maxDepth;
+                if (order == PRE) {
+                    if (!withinNodeCount(++visited)) return maxDepth;
+                    visit(r->data);
+                }
+                stack.push_back(current);
+                current = r->link.left;
+            }
+            maxDepth = std::max(maxDepth, stack.size());
+
+            int32_t top = stack.back();
+            const PagedRecord<T>* r = record(top);
+            if (!r) return maxDepth;
+            if (order == POST) {
+                if (r->link.right >= 0 && lastVisited != r->link.right) {
+                    current = r->link.right;
+                    continue;
+                }
+                stack.pop_back();
+                lastVisited = top;
+            } else {
+                stack.pop_back();
+                current = r->link.right;
+            }
+            if (order != PRE) {
+                if (!withinNodeCount(++visited)) return maxDepth;
+                visit(r->data);
+            }
+        }
+        return maxDepth;
+    }
+
+    // 层序：缺页时向后扫描队列，把接下来要访问的页一并读入（按层推进的顺序预读）
+    size_t levelorder(int32_t root, void (*visit)(const T&)) {
+        if (root < 0) return 0;
+        std::deque<int32_t> q;
+        q.push_back(root);
+        std::vector<int64_t> upcoming;
+        size_t readahead = cache.readaheadPages();
+        size_t maxQueueLength = 0;
+        size_t visited = 0;
+        while (!q.empty()) {
+            maxQueueLength = std::max(maxQueueLength, q.size());
+            int32_t current = q.front();
+            q.pop_front();
+
+            // 入队的编号都已检查过范围，这里按页号查缓存不会越界
+            int64_t pageId = current / perPage;
+            const std::vector<int64_t>* lookahead = nullptr;
+            if (readahead && !cache.resident(pageId)) {
+                // 扫描长度有上限，避免队列很长时每次缺页都扫一遍
+                upcoming.clear();
+                int64_t lastPage = pageId;
+                size_t scanLimit = std::min(q.size(), readahead * perPage * 4);
+                for (size_t i = 0; i < scanLimit && upcoming.size() < readahead; i++) {
+                    int64_t p = q[i] / perPage;
+                    if (p == lastPage) continue;
+                    lastPage = p;
+                    if (!cache.resident(p)) upcoming.push_back(p);
+                }
+                lookahead = &upcoming;
+            }
+
+            const PagedRecord<T>* r = recordAt(current, lookahead);
+            if (!r || !withinNodeCount(++visited)) break;
+            visit(r->data);
+            for (int32_t child : {r->link.left, r->link.right}) {
+                if (child < 0) continue;
+                if (uint64_t(child) >= recordCount) {
+                    failure = "节点编号 " + std::to_string(child) + " 越界，文件已损坏";
+                    return maxQueueLength;
+                }
+                q.push_back(child);
+            }
+        }
+        return maxQueueLength;
+    }
+};
+
+#endif // PAGEDTREE_H
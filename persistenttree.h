@@ -0,0 +1,335 @@
+#ifndef PERSISTENTTREE_H
+#define PERSISTENTTREE_H
+
+#include <cstdint>
+#include <vector>
+#include <queue>
+#include <atomic>
+#include <mutex>
+#include <unordered_set>
+#include <algorithm>
+#include "BinaryTree.cpp"
+
+/*
+* 持久化（结构共享）二叉树
+* 节点一经创建就不再修改；每次更新只复制从根到被修改节点的路径，其余子树由新旧版本共享，
+* 所以每个旧版本都保持不变、可以继续遍历。节点带原子引用计数，最后一个引用它的版本释放时回收
+*/
+template<typename T>
+struct PersistentNode {
+    T data;
+    const PersistentNode* left;
+    const PersistentNode* right;
+    mutable std::atomic<uint32_t> refs;
+
+    PersistentNode(const T& val, const PersistentNode* l, const PersistentNode* r)
+        : data(val), left(l), right(r), refs(1) {}
+};
+
+// 从根出发的路径：0 向左，1 向右；空路径表示根
+typedef std::vector<uint8_t> TreePath;
+
+// 完全二叉树中层序下标 index（根为 0）对应的路径：index+1 的二进制去掉最高位后从高到低即为左右
+inline TreePath pathFromIndex(uint64_t index) {
+    TreePath path;
+    uint64_t heap = index + 1;
+    for (int bit = 62 - __builtin_clzll(heap); bit >= 0; bit--) path.push_back((heap >> bit) & 1);
+    return path;
+}
+
+template<typename T>
+class PersistentTree {
+public:
+    typedef PersistentNode<T> Node;
+
+    PersistentTree() : root(nullptr), count(0) {}
+
+    // 复制普通二叉树的形状与数据，得到第一个版本
+    explicit PersistentTree(const BinaryTree<T>& tree) : root(nullptr), count(0) {
+        const TreeNode<T>* source = tree.getRoot();
+        if (!source) return;
+        // 后序构造：孩子先建好，父节点创建时即可填入只读的孩子指针
+        std::vector<std::pair<const TreeNode<T>*, bool>> stack{{source, false}};
+        std::vector<const Node*> built;
+        while (!stack.empty()) {
+            const TreeNode<T>* src = stack.back().first;
+            bool expanded = stack.back().second;
+            stack.pop_back();
+            if (!expanded) {
+                stack.push_back({src, true});
+                if (src->right) stack.push_back({src->right, false});
+                if (src->left) stack.push_back({src->left, false});
+                continue;
+            }
+            const Node* right = src->right ? pop(built) : nullptr;
+            const Node* left = src->left ? pop(built) : nullptr;
+            built.push_back(new Node(src->data, left, right));
+            count++;
+        }
+        root = built.back();
+    }
+
+    // 复制一个版本只增加根的引用计数：O(1) 快照
+    PersistentTree(const PersistentTree& other) : root(other.root), count(other.count) {
+        retain(root);
+    }
+
+    PersistentTree(PersistentTree&& other) noexcept : root(other.root), count(other.count) {
+        other.root = nullptr;
+        other.count = 0;
+    }
+
+    PersistentTree& operator=(PersistentTree other) noexcept {
+        std::swap(root, other.root);
+        std::swap(count, other.count);
+        return *this;
+    }
+
+    ~PersistentTree() {
+        release(root);
+    }
+
+    const Node* getRoot() const { return root; }
+    size_t size() const { return count; }
+    bool empty() const { return root == nullptr; }
+
+    // 找到路径上的节点，不存在时返回空
+    const Node* find(const TreePath& path) const {
+        const Node* node = root;
+        for (uint8_t step : path) {
+            if (!node) return nullptr;
+            node = step ? node->right : node->left;
+        }
+        return node;
+    }
+
+    // 新版本：路径上的节点值改为 value；路径不存在时返回与当前相同的版本
+    PersistentTree withValue(const TreePath& path, const T& value) const {
+        if (!find(path)) return *this;
+        return PersistentTree(copyPath(path, path.size(), [&](const Node* old) {
+            retain(old->left);
+            retain(old->right);
+            return new Node(value, old->left, old->right);
+        }), count);
+    }
+
+    // 新版本：在路径所指节点的左（isRight 为 false）或右空位挂一个新叶子；空位已被占用时返回当前版本
+    // 空树时忽略路径，新叶子成为根
+    PersistentTree withChild(const TreePath& path, bool isRight, const T& value) const {
+        if (!root) return PersistentTree(new Node(value, nullptr, nullptr), 1);
+        const Node* parent = find(path);
+        if (!parent || (isRight ? parent->right : parent->left)) return *this;
+        return PersistentTree(copyPath(path, path.size(), [&](const Node* old) {
+            const Node* leaf = new Node(value, nullptr, nullptr);
+            retain(isRight ? old->left : old->right);
+            return isRight ? new Node(old->data, old->left, leaf) : new Node(old->data, leaf, old->right);
+        }), count + 1);
+    }
+
+    // 新版本：摘掉路径所指的整棵子树（摘根得到空树）
+    PersistentTree withoutSubtree(const TreePath& path) const {
+        const Node* target = find(path);
+        if (!target) return *this;
+        size_t removed = countNodes(target);
+        if (path.empty()) return PersistentTree(nullptr, 0);
+        // 复制到父节点为止，父节点的对应孩子置空
+        bool isRight = path.back() != 0;
+        return PersistentTree(copyPath(path, path.size() - 1, [&](const Node* old) {
+            retain(isRight ? old->left : old->right);
+            return isRight ? new Node(old->data, old->left, nullptr) : new Node(old->data, nullptr, old->right);
+        }), count - removed);
+    }
+
+    TraversalStats Traversal(TraversalClass traversal_class, bool is_recursive, void (*visit)(const T&)) const {
+        TraversalStats stats;
+        const BenchClock& clock = BenchClock::instance();
+        size_t maxDepth = 0;
+        uint64_t start = clock.now();
+
+        if (traversal_class == LEVEL) {
+            maxDepth = levelorder(visit);
+            stats.max_queue_length = maxDepth;
+        } else if (is_recursive) {
+            recursiveHelper(traversal_class, root, visit);
+        } else {
+            maxDepth = iterative(traversal_class, visit);
+            stats.max_stack_depth = maxDepth;
+        }
+
+        uint64_t end = clock.now();
+        stats.setTiming(clock.elapsedNs(start, end), count);
+        stats.memory_usage = maxDepth * sizeof(const Node*);
+        return stats;
+    }
+
+    // 若干版本合计占用的节点数（共享的节点只算一次），用于和整棵复制比较内存
+    static size_t distinctNodes(const std::vector<PersistentTree>& versions) {
+        std::unordered_set<const Node*> seen;
+        std::vector<const Node*> stack;
+        for (const PersistentTree& version : versions) {
+            if (version.root) stack.push_back(version.root);
+            while (!stack.empty()) {
+                const Node* node = stack.back();
+                stack.pop_back();
+                if (!seen.insert(node).second) continue;   // 共享子树已经数过
+                if (node->left) stack.push_back(node->left);
+                if (node->right) stack.push_back(node->right);
+            }
+        }
+        return seen.size();
+    }
+
+private:
+    const Node* root;
+    size_t count;
+
+    // 接管一个已持有引用的根
+    PersistentTree(const Node* newRoot, size_t n) : root(newRoot), count(n) {}
+
+    static const Node* pop(std::vector<const Node*>& nodes) {
+        const Node* node = nodes.back();
+        nodes.pop_back();
+        return node;
+    }
+
+    static void retain(const Node* node) {
+        if (node) node->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // 引用计数归零的节点被删除，并继续释放它对孩子的引用（用栈，不递归）
+    static void release(const Node* node) {
+        std::vector<const Node*> stack;
+        while (node) {
+            if (node->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                if (node->left) stack.push_back(node->left);
+                if (node->right) stack.push_back(node->right);
+                delete node;
+            }
+            if (stack.empty()) break;
+            node = pop(stack);
+        }
+    }
+
+    static size_t countNodes(const Node* node) {
+        size_t n = 0;
+        std::vector<const Node*> stack{node};
+        while (!stack.empty()) {
+            const Node* current = pop(stack);
+            n++;
+            if (current->left) stack.push_back(current->left);
+            if (current->right) stack.push_back(current->right);
+        }
+        return n;
+    }
+
+    /*
+    * 路径复制：沿 path 的前 depth 步找到目标节点，用 replace(目标) 生成新节点，
+    * 再自底向上为路径上的每个祖先建新节点，新节点共享未经过的那一侧孩子（引用计数加一）
+    * 返回新根（持有一个引用）
+    */
+    template<typename Replace>
+    const Node* copyPath(const TreePath& path, size_t depth, Replace replace) const {
+        std::vector<const Node*> ancestors;
+        ancestors.reserve(depth);
+        const Node* node = root;
+        for (size_t i = 0; i < depth; i++) {
+            ancestors.push_back(node);
+            node = path[i] ? node->right : node->left;
+        }
+        const Node* copy = replace(node);
+        for (size_t i = depth; i-- > 0;) {
+            const Node* old = ancestors[i];
+            if (path[i]) {
+                retain(old->left);
+                copy = new Node(old->data, old->left, copy);
+            } else {
+                retain(old->right);
+                copy = new Node(old->data, copy, old->right);
+            }
+        }
+        return copy;
+    }
+
+    void recursiveHelper(TraversalClass order, const Node* node, void (*visit)(const T&)) const {
+        if (!node) return;
+        if (order == PRE) visit(node->data);
+        recursiveHelper(order, node->left, visit);
+        if (order == IN) visit(node->data);
+        recursiveHelper(order, node->right, visit);
+        if (order == POST) visit(node->data);
+    }
+
+    // 与 BinaryTree 的非递归版本相同的单栈算法，返回最大栈深
+    size_t iterative(TraversalClass order, void (*visit)(const T&)) const {
+        std::vector<const Node*> stack;
+        const Node* current = root;
+        const Node* lastVisited = nullptr;
+        size_t maxDepth = 0;
+
+        while (current || !stack.empty()) {
+            while (current) {
+                if (order == PRE) visit(current->data);
+                stack.push_back(current);
+                current = current->left;
+            }
+            maxDepth = std::max(maxDepth, stack.size());
+
+            const Node* top = stack.back();
+            if (order == POST) {
+                if (top->right && lastVisited != top->right) {
+                    current = top->right;
+                } else {
+                    visit(top->data);
+                    lastVisited = top;
+                    stack.pop_back();
+                }
+            } else {
+                stack.pop_back();
+                if (order == IN) visit(top->data);
+                current = top->right;
+            }
+        }
+        return maxDepth;
+    }
+
+    size_t levelorder(void (*visit)(const T&)) const {
+        if (!root) return 0;
+        std::queue<const Node*> q;
+        q.push(root);
+        size_t maxQueueLength = 0;
+        while (!q.empty()) {
+            maxQueueLength = std::max(maxQueueLength, q.size());
+            const Node* current = q.front();
+            q.pop();
+            visit(current->data);
+            if (current->left) q.push(current->left);
+            if (current->right) q.push(current->right);
+        }
+        return maxQueueLength;
+    }
+};
+
+/*
+* 当前版本的发布点：写者 publish 新版本，读者 snapshot 取得一个稳定的版本后自行遍历
+* 只有交换根指针时持锁，遍历期间不持锁，写者也不会等读者
+*/
+template<typename T>
+class PersistentTreeHead {
+public:
+    PersistentTree<T> snapshot() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return current;
+    }
+
+    void publish(PersistentTree<T> version) {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::swap(current, version);
+        // 旧版本在锁外随 version 析构释放
+    }
+
+private:
+    mutable std::mutex mutex;
+    PersistentTree<T> current;
+};
+
+#endif // PERSISTENTTREE_H
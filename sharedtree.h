@@ -0,0 +1,467 @@
+#ifndef SHAREDTREE_H
+#define SHAREDTREE_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <new>
+#include <type_traits>
+#include "treefile.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sched.h>
+#include <signal.h>
+#define SHAREDTREE_HAS_POSIX 1
+#endif
+
+/*
+* POSIX 共享内存中的树与多进程遍历
+* 段内布局（各段 64 字节对齐）：
+* [SharedTreeHeader][TreeLink x n][T x n][任务：子树根下标 x taskCount][结果环 x workers]
+* 链接是节点下标（相对段内数组的偏移），不含任何指针，所以 fork 出的工作进程或其它进程映射到任意地址都能直接遍历
+* 节点按先序编号，每棵子树占一段连续下标
+*/
+
+// 一个任务（一棵子树）的遍历结果，经结果环交回主进程
+struct SharedTaskResult {
+    uint32_t task;          // 任务编号
+    uint32_t worker;        // 完成它的工作进程
+    uint64_t nodes;         // 访问的节点数
+    int64_t sum;            // 节点值之和
+    uint64_t fingerprint;   // 按访问顺序混合的指纹，用于核对顺序
+    uint64_t ns;            // 工作进程内的遍历耗时
+};
+
+// 单生产者（工作进程）单消费者（主进程）的结果环
+struct SharedResultRing {
+    static const uint32_t kCapacity = 256;
+
+    alignas(64) std::atomic<uint64_t> head;   // 主进程已取走的条数
+    alignas(64) std::atomic<uint64_t> tail;   // 工作进程已写入的条数
+    SharedTaskResult records[kCapacity];
+
+    void push(const SharedTaskResult& result) {
+        uint64_t t = tail.load(std::memory_order_relaxed);
+        while (t - head.load(std::memory_order_acquire) >= kCapacity) sched_yield();
+        records[t % kCapacity] = result;
+        tail.store(t + 1, std::memory_order_release);
+    }
+
+    bool pop(SharedTaskResult& result) {
+        uint64_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) return false;
+        result = records[h % kCapacity];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+};
+
+struct SharedTreeHeader {
+    char magic[8];                      // "BTSHM1\0\0"
+    uint32_t payloadSize;               // sizeof(T)
+    uint32_t workers;
+    uint64_t nodeCount;
+    uint64_t linksOffset;
+    uint64_t payloadOffset;
+    uint64_t tasksOffset;
+    uint64_t taskCount;
+    uint64_t ringsOffset;
+    uint64_t totalBytes;
+    std::atomic<uint32_t> kind;         // 本轮的遍历方式
+    std::atomic<uint64_t> nextTask;     // 工作进程领取任务的计数器
+    std::atomic<uint32_t> doneWorkers;  // 本轮已领不到任务、停止访问计数器的工作进程数
+};
+
+// 跨进程使用的原子变量必须是无锁的（与地址无关）
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "共享内存中的原子变量必须无锁");
+
+// 一轮多进程遍历的汇总
+struct SharedRunResult {
+    uint64_t nodes = 0;
+    int64_t sum = 0;
+    uint64_t fingerprint = 0;   // 上层节点的指纹在前，其后各任务指纹按任务编号顺序合并
+    double ns = 0.0;            // 主进程从派发到收齐的耗时
+    double busiestWorkerNs = 0.0;   // 最忙的工作进程的遍历时间，用于看负载是否均衡
+    size_t tasks = 0;
+
+    bool sameResult(const SharedRunResult& other) const {
+        return nodes == other.nodes && sum == other.sum && fingerprint == other.fingerprint;
+    }
+};
+
+namespace sharedtree {
+
+inline uint64_t mixFingerprint(uint64_t fingerprint, uint64_t value) {
+    return (fingerprint ^ value) * 0x100000001B3ull + 0x9E3779B97F4A7C15ull;
+}
+
+} // namespace sharedtree
+
+template<typename T>
+class SharedTreeArena {
+    static_assert(std::is_arithmetic<T>::value, "共享内存树的节点数据需为算术类型（用于求和与指纹）");
+
+public:
+    SharedTreeArena() = default;
+    ~SharedTreeArena() { close(); }
+
+    SharedTreeArena(const SharedTreeArena&) = delete;
+    SharedTreeArena& operator=(const SharedTreeArena&) = delete;
+
+    /*
+    * 建立共享内存段并写入 tree；树的上面几层被拆成至少 workers * tasksPerWorker 棵子树作为任务
+    * 拆出来的上层节点很少，每轮由主进程在工作进程遍历子树的同时自己遍历（见 runUpper）
+    */
+    bool create(const BinaryTree<T>& tree, unsigned workers, size_t tasksPerWorker = 8, std::string* error = nullptr) {
+        close();
+#ifdef SHAREDTREE_HAS_POSIX
+        std::vector<TreeLink> links;
+        std::vector<T> payload;
+        treefile::flatten(tree.getRoot(), links, payload);
+        workers = std::max(1u, workers);
+        std::vector<int32_t> tasks = splitTasks(links, workers * std::max<size_t>(1, tasksPerWorker));
+
+        uint64_t n = links.size();
+        uint64_t linksOffset = treefile::alignUp(sizeof(SharedTreeHeader), 64);
+        uint64_t payloadOffset = treefile::alignUp(linksOffset + n * sizeof(TreeLink), 64);
+        uint64_t tasksOffset = treefile::alignUp(payloadOffset + n * sizeof(T), 64);
+        uint64_t ringsOffset = treefile::alignUp(tasksOffset + tasks.size() * sizeof(int32_t), 64);
+        uint64_t totalBytes = ringsOffset + workers * sizeof(SharedResultRing);
+
+        static std::atomic<unsigned> serial{0};
+        segmentName = "/bintree_" + std::to_string(getpid()) + "_" + std::to_string(serial++);
+        int fd = shm_open(segmentName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0) {
+            if (error) *error = "shm_open 失败 " + segmentName;
+            segmentName.clear();
+            return false;
+        }
+        bool sized = ftruncate(fd, static_cast<off_t>(totalBytes)) == 0;
+        void* p = sized ? mmap(nullptr, totalBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+        ::close(fd);
+        if (p == MAP_FAILED) {
+            if (error) *error = sized ? "mmap 共享内存失败" : "无法设置共享内存大小";
+            shm_unlink(segmentName.c_str());
+            segmentName.clear();
+            return false;
+        }
+        base = static_cast<char*>(p);
+        length = totalBytes;
+
+        header = new (base) SharedTreeHeader();
+        std::memcpy(header->magic, "BTSHM1\0\0", 8);
+        header->payloadSize = sizeof(T);
+        header->workers = workers;
+        header->nodeCount = n;
+        header->linksOffset = linksOffset;
+        header->payloadOffset = payloadOffset;
+        header->tasksOffset = tasksOffset;
+        header->taskCount = tasks.size();
+        header->ringsOffset = ringsOffset;
+        header->totalBytes = totalBytes;
+        header->kind.store(PRE, std::memory_order_relaxed);
+        header->nextTask.store(0, std::memory_order_relaxed);
+        header->doneWorkers.store(0, std::memory_order_relaxed);
+
+        if (n) {
+            std::memcpy(base + linksOffset, links.data(), n * sizeof(TreeLink));
+            std::memcpy(base + payloadOffset, payload.data(), n * sizeof(T));
+        }
+        if (!tasks.empty()) std::memcpy(base + tasksOffset, tasks.data(), tasks.size() * sizeof(int32_t));
+        for (unsigned w = 0; w < workers; w++) {
+            SharedResultRing* ring = new (base + ringsOffset + w * sizeof(SharedResultRing)) SharedResultRing();
+            ring->head.store(0, std::memory_order_relaxed);
+            ring->tail.store(0, std::memory_order_relaxed);
+        }
+
+        // 记下任务子树的根，上层节点（不属于任何任务子树）每轮由主进程遍历到这些根为止
+        isTaskRoot.assign(n, false);
+        for (int32_t root : tasks) isTaskRoot[root] = true;
+        upperNodes = runUpper().nodes;
+        return true;
+#else
+        (void)tree;
+        (void)workers;
+        (void)tasksPerWorker;
+        if (error) *error = "当前平台不支持 POSIX 共享内存";
+        return false;
+#endif
+    }
+
+    // fork 出工作进程；工作进程阻塞在各自的命令管道上，收到命令后领取任务，结果写入自己的结果环
+    // 应在启动其它线程之前、且未绑定 CPU 时调用（子进程继承亲和性）
+    bool startWorkers(std::string* error = nullptr) {
+#ifdef SHAREDTREE_HAS_POSIX
+        if (!header || !pids.empty()) return header != nullptr;
+        // 工作进程异常退出后再写命令管道不应让主进程被 SIGPIPE 终止
+        signal(SIGPIPE, SIG_IGN);
+        for (unsigned w = 0; w < header->workers; w++) {
+            int fds[2];
+            if (pipe(fds) != 0) {
+                if (error) *error = "无法创建命令管道";
+                stopWorkers();
+                return false;
+            }
+            pid_t pid = fork();
+            if (pid < 0) {
+                ::close(fds[0]);
+                ::close(fds[1]);
+                if (error) *error = "fork 失败";
+                stopWorkers();
+                return false;
+            }
+            if (pid == 0) {
+                ::close(fds[1]);
+                for (int fd : commandFds) ::close(fd);
+                workerLoop(w, fds[0]);
+                _exit(0);
+            }
+            ::close(fds[0]);
+            pids.push_back(pid);
+            commandFds.push_back(fds[1]);
+        }
+        return true;
+#else
+        if (error) *error = "当前平台不支持 fork";
+        return false;
+#endif
+    }
+
+    void stopWorkers() {
+#ifdef SHAREDTREE_HAS_POSIX
+        for (int fd : commandFds) {
+            char quit = 'Q';
+            ssize_t written = write(fd, &quit, 1);
+            (void)written;
+            ::close(fd);
+        }
+        for (pid_t pid : pids) waitpid(pid, nullptr, 0);
+#endif
+        commandFds.clear();
+        pids.clear();
+    }
+
+    // 用进程池遍历所有任务子树，结果经结果环收齐后汇总；有工作进程异常退出时返回 false
+    bool run(TraversalClass kind, SharedRunResult& result, std::string* error = nullptr) {
+        result = SharedRunResult();
+#ifdef SHAREDTREE_HAS_POSIX
+        if (pids.empty()) {
+            if (error) *error = "工作进程未启动";
+            return false;
+        }
+        const BenchClock& clock = BenchClock::instance();
+        uint64_t start = clock.now();
+
+        size_t taskCount = header->taskCount;
+        header->kind.store(kind, std::memory_order_relaxed);
+        header->doneWorkers.store(0, std::memory_order_relaxed);
+        header->nextTask.store(0, std::memory_order_release);
+        for (int fd : commandFds) {
+            char command = 'R';
+            if (write(fd, &command, 1) != 1) {
+                if (error) *error = "无法向工作进程派发任务";
+                return false;
+            }
+        }
+
+        // 工作进程遍历任务子树的同时，主进程遍历上层节点
+        SharedTaskResult upper = runUpper();
+
+        std::vector<SharedTaskResult> byTask(taskCount);
+        std::vector<uint64_t> workerNs(pids.size(), 0);
+        size_t received = 0;
+        // 收齐结果，并等所有工作进程都不再访问任务计数器，下一轮才能安全地把它清零
+        while (received < taskCount || header->doneWorkers.load(std::memory_order_acquire) < pids.size()) {
+            bool progress = false;
+            for (unsigned w = 0; w < pids.size(); w++) {
+                SharedTaskResult r;
+                while (ring(w)->pop(r)) {
+                    byTask[r.task] = r;
+                    workerNs[r.worker] += r.ns;
+                    received++;
+                    progress = true;
+                }
+            }
+            if (progress) continue;
+            for (pid_t pid : pids) {
+                if (waitpid(pid, nullptr, WNOHANG) != 0) {
+                    if (error) *error = "工作进程异常退出";
+                    return false;
+                }
+            }
+            sched_yield();
+        }
+
+        // 先并入上层节点，再按任务编号顺序合并任务结果
+        merge(result, upper);
+        for (const SharedTaskResult& r : byTask) merge(result, r);
+        result.ns = clock.elapsedNs(start, clock.now());
+        result.busiestWorkerNs = workerNs.empty() ? 0.0 : *std::max_element(workerNs.begin(), workerNs.end());
+        result.tasks = taskCount;
+        return true;
+#else
+        (void)kind;
+        if (error) *error = "当前平台不支持多进程遍历";
+        return false;
+#endif
+    }
+
+    // 在本进程内按同样的任务划分依次遍历，作为单进程对照与结果核对
+    SharedRunResult runLocal(TraversalClass kind) const {
+        SharedRunResult result;
+        if (!header) return result;
+        const BenchClock& clock = BenchClock::instance();
+        uint64_t start = clock.now();
+        merge(result, runUpper());
+        for (size_t t = 0; t < header->taskCount; t++) merge(result, runTask(kind, t, 0));
+        result.ns = clock.elapsedNs(start, clock.now());
+        result.busiestWorkerNs = result.ns;
+        result.tasks = header->taskCount;
+        return result;
+    }
+
+    FlatTreeView<T> view() const {
+        if (!header) return FlatTreeView<T>();
+        return FlatTreeView<T>(reinterpret_cast<const TreeLink*>(base + header->linksOffset),
+                               reinterpret_cast<const T*>(base + header->payloadOffset), header->nodeCount);
+    }
+
+    bool isOpen() const { return header != nullptr; }
+    size_t segmentBytes() const { return length; }
+    size_t taskCount() const { return header ? header->taskCount : 0; }
+    size_t upperNodeCount() const { return upperNodes; }
+    unsigned workerCount() const { return header ? header->workers : 0; }
+    const std::string& name() const { return segmentName; }
+
+    void close() {
+        stopWorkers();
+#ifdef SHAREDTREE_HAS_POSIX
+        if (base) munmap(base, length);
+        if (!segmentName.empty()) shm_unlink(segmentName.c_str());
+#endif
+        base = nullptr;
+        header = nullptr;
+        length = 0;
+        segmentName.clear();
+    }
+
+private:
+    char* base = nullptr;
+    size_t length = 0;
+    SharedTreeHeader* header = nullptr;
+    std::string segmentName;
+    std::vector<pid_t> pids;
+    std::vector<int> commandFds;
+    std::vector<bool> isTaskRoot;   // 任务子树的根，上层遍历到此为止
+    uint64_t upperNodes = 0;
+
+    SharedResultRing* ring(unsigned worker) const {
+        return reinterpret_cast<SharedResultRing*>(base + header->ringsOffset + worker * sizeof(SharedResultRing));
+    }
+
+    const int32_t* tasks() const {
+        return reinterpret_cast<const int32_t*>(base + header->tasksOffset);
+    }
+
+    // 逐层展开，直到一层的子树数达到 target；叶子不再展开，原样作为任务
+    static std::vector<int32_t> splitTasks(const std::vector<TreeLink>& links, size_t target) {
+        std::vector<int32_t> frontier;
+        if (!links.empty()) frontier.push_back(0);
+        // 限制展开的层数，退化成长链的树不会把整条链都留给主进程
+        for (int depth = 0; depth < 64 && frontier.size() < target; depth++) {
+            std::vector<int32_t> next;
+            bool expanded = false;
+            for (int32_t index : frontier) {
+                const TreeLink& link = links[index];
+                if (link.left < 0 && link.right < 0) {
+                    next.push_back(index);
+                    continue;
+                }
+                expanded = true;
+                if (link.left >= 0) next.push_back(link.left);
+                if (link.right >= 0) next.push_back(link.right);
+            }
+            if (!expanded) break;
+            frontier.swap(next);
+        }
+        return frontier;
+    }
+
+    static void merge(SharedRunResult& result, const SharedTaskResult& r) {
+        result.nodes += r.nodes;
+        result.sum += r.sum;
+        result.fingerprint = sharedtree::mixFingerprint(result.fingerprint, r.fingerprint);
+    }
+
+    // 主进程负责的上层节点：从根先序遍历，遇到任务子树的根就停下（与遍历方式无关，指纹固定按先序）
+    SharedTaskResult runUpper() const {
+        const BenchClock& clock = BenchClock::instance();
+        SharedTaskResult r;
+        r.task = static_cast<uint32_t>(header->taskCount);
+        r.worker = 0;
+        r.nodes = 0;
+        r.sum = 0;
+        r.fingerprint = 0;
+        uint64_t start = clock.now();
+        FlatTreeView<T> flat = view();
+        std::vector<int32_t> stack;
+        if (header->nodeCount) stack.push_back(0);
+        while (!stack.empty()) {
+            int32_t index = stack.back();
+            stack.pop_back();
+            if (isTaskRoot[index]) continue;
+            T value = flat.value(index);
+            r.nodes++;
+            r.sum += static_cast<int64_t>(value);
+            r.fingerprint = sharedtree::mixFingerprint(r.fingerprint, static_cast<uint64_t>(value));
+            if (flat.link(index).right >= 0) stack.push_back(flat.link(index).right);
+            if (flat.link(index).left >= 0) stack.push_back(flat.link(index).left);
+        }
+        r.ns = clock.elapsedNs(start, clock.now());
+        return r;
+    }
+
+    SharedTaskResult runTask(TraversalClass kind, size_t task, unsigned worker) const {
+        const BenchClock& clock = BenchClock::instance();
+        SharedTaskResult r;
+        r.task = static_cast<uint32_t>(task);
+        r.worker = worker;
+        r.nodes = 0;
+        r.sum = 0;
+        r.fingerprint = 0;
+        uint64_t start = clock.now();
+        view().forEachFrom(tasks()[task], kind, [&r](const T& value) {
+            r.nodes++;
+            r.sum += static_cast<int64_t>(value);
+            r.fingerprint = sharedtree::mixFingerprint(r.fingerprint, static_cast<uint64_t>(value));
+        });
+        r.ns = clock.elapsedNs(start, clock.now());
+        return r;
+    }
+
+#ifdef SHAREDTREE_HAS_POSIX
+    // 工作进程：每收到一个 'R' 就领取任务直到领完；'Q' 或管道关闭时退出
+    void workerLoop(unsigned worker, int commandFd) {
+        char command;
+        while (read(commandFd, &command, 1) == 1 && command == 'R') {
+            TraversalClass kind = static_cast<TraversalClass>(header->kind.load(std::memory_order_relaxed));
+            while (true) {
+                uint64_t task = header->nextTask.fetch_add(1, std::memory_order_acq_rel);
+                if (task >= header->taskCount) break;
+                ring(worker)->push(runTask(kind, task, worker));
+            }
+            header->doneWorkers.fetch_add(1, std::memory_order_acq_rel);
+        }
+        ::close(commandFd);
+    }
+#endif
+};
+
+#endif // SHAREDTREE_H
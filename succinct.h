@@ -0,0 +1,301 @@
+#ifndef SUCCINCT_H
+#define SUCCINCT_H
+
+#include <cstdint>
+#include <vector>
+#include <queue>
+#include <algorithm>
+#include <type_traits>
+#include "BinaryTree.cpp"
+
+/*
+* 带 rank/select 的位向量
+* rank1(i) = [0, i) 中 1 的个数；select1(k) = 第 k 个 1 的位置（k 从 1 开始）
+* 每 512 位存一个 64 位累计计数（12.5% 额外空间），每 512 个 1 采样一次位置用于 select
+*/
+class RankSelectBits {
+public:
+    void push(bool bit) {
+        if ((length & 63) == 0) words.push_back(0);
+        if (bit) words.back() |= uint64_t(1) << (length & 63);
+        length++;
+    }
+
+    // 追加完所有位后调用
+    void build() {
+        size_t blocks = (words.size() + kWordsPerBlock - 1) / kWordsPerBlock;
+        blockRank.assign(blocks + 1, 0);
+        selectSample.clear();
+        uint64_t ones = 0;
+        uint64_t nextSample = 1;    // 下一个要采样的 1 的序号
+        for (size_t w = 0; w < words.size(); w++) {
+            if (w % kWordsPerBlock == 0) blockRank[w / kWordsPerBlock] = ones;
+            ones += popcount(words[w]);
+            while (nextSample <= ones) {
+                selectSample.push_back(static_cast<uint32_t>(w));
+                nextSample += kSelectStep;
+            }
+        }
+        blockRank[blocks] = ones;
+        totalOnes = ones;
+    }
+
+    bool get(uint64_t i) const { return (words[i >> 6] >> (i & 63)) & 1; }
+    uint64_t size() const { return length; }
+    uint64_t ones() const { return totalOnes; }
+
+    uint64_t rank1(uint64_t i) const {
+        uint64_t word = i >> 6;
+        uint64_t r = blockRank[word / kWordsPerBlock];
+        for (uint64_t w = word & ~uint64_t(kWordsPerBlock - 1); w < word; w++) r += popcount(words[w]);
+        if (i & 63) r += popcount(words[word] & ((uint64_t(1) << (i & 63)) - 1));
+        return r;
+    }
+
+    uint64_t select1(uint64_t k) const {
+        // 从采样点所在的字开始，先按块跳，再逐字找
+        uint64_t w = selectSample[(k - 1) / kSelectStep];
+        uint64_t block = w / kWordsPerBlock;
+        while (block + 1 < blockRank.size() && blockRank[block + 1] < k) block++;
+        w = std::max<uint64_t>(w, block * kWordsPerBlock);
+        uint64_t r = rank1(w * 64);
+        while (true) {
+            uint64_t count = popcount(words[w]);
+            if (r + count >= k) break;
+            r += count;
+            w++;
+        }
+        uint64_t word = words[w];
+        for (uint64_t skip = k - r - 1; skip > 0; skip--) word &= word - 1;
+        return w * 64 + ctz(word);
+    }
+
+    size_t memoryBytes() const {
+        return words.size() * sizeof(uint64_t) + blockRank.size() * sizeof(uint64_t)
+               + selectSample.size() * sizeof(uint32_t);
+    }
+
+private:
+    static const size_t kWordsPerBlock = 8;
+    static const uint64_t kSelectStep = 512;
+
+    std::vector<uint64_t> words;
+    std::vector<uint64_t> blockRank;       // 每块之前 1 的个数
+    std::vector<uint32_t> selectSample;    // 第 j*512+1 个 1 所在的字
+    uint64_t length = 0;
+    uint64_t totalOnes = 0;
+
+    static uint64_t popcount(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_popcountll(x);
+#else
+        x = x - ((x >> 1) & 0x5555555555555555ull);
+        x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+        x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+        return (x * 0x0101010101010101ull) >> 56;
+#endif
+    }
+
+    static uint64_t ctz(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctzll(x);
+#else
+        uint64_t n = 0;
+        while (!(x & 1)) {
+            x >>= 1;
+            n++;
+        }
+        return n;
+#endif
+    }
+};
+
+/*
+* 简洁（succinct）二叉树
+* 节点按层序编号 0..n-1，第 v 个节点占两位：bits[2v] = 有左孩子，bits[2v+1] = 有右孩子
+* 孩子的编号 = 它之前的 1 的个数 + 1（根占编号 0）：left(v) = rank1(2v) + 1
+* 父节点反过来用 select：parent(c) = select1(c) / 2
+* 结构部分每节点约 2.3 位，节点数据按层序另存
+*/
+template<typename T>
+class SuccinctTree {
+public:
+    SuccinctTree() = default;
+
+    explicit SuccinctTree(const BinaryTree<T>& tree) {
+        build(tree.getRoot());
+    }
+
+    void build(const TreeNode<T>* root) {
+        bits = RankSelectBits();
+        payload.clear();
+        if (!root) {
+            bits.build();
+            return;
+        }
+        std::queue<const TreeNode<T>*> q;
+        q.push(root);
+        while (!q.empty()) {
+            const TreeNode<T>* current = q.front();
+            q.pop();
+            payload.push_back(current->data);
+            bits.push(current->left != nullptr);
+            bits.push(current->right != nullptr);
+            if (current->left) q.push(current->left);
+            if (current->right) q.push(current->right);
+        }
+        bits.build();
+    }
+
+    size_t size() const { return payload.size(); }
+
+    // 导航：节点编号为 int32_t，-1 表示不存在
+    int32_t root() const { return payload.empty() ? -1 : 0; }
+    bool hasLeft(int32_t v) const { return bits.get(2 * uint64_t(v)); }
+    bool hasRight(int32_t v) const { return bits.get(2 * uint64_t(v) + 1); }
+    int32_t leftChild(int32_t v) const {
+        return hasLeft(v) ? static_cast<int32_t>(bits.rank1(2 * uint64_t(v)) + 1) : -1;
+    }
+    int32_t rightChild(int32_t v) const {
+        return hasRight(v) ? static_cast<int32_t>(bits.rank1(2 * uint64_t(v) + 1) + 1) : -1;
+    }
+    int32_t parent(int32_t v) const {
+        return v > 0 ? static_cast<int32_t>(bits.select1(v) / 2) : -1;
+    }
+    bool isRightChild(int32_t v) const { return v > 0 && (bits.select1(v) & 1); }
+    const T& value(int32_t v) const { return payload[v]; }
+    const T* values() const { return payload.data(); }   // 按层序连续存放
+
+    // 结构部分（位向量 + rank/select 目录）的字节数与每节点位数
+    size_t structureBytes() const { return bits.memoryBytes(); }
+    double bitsPerNode() const { return payload.empty() ? 0.0 : structureBytes() * 8.0 / payload.size(); }
+    size_t memoryBytes() const { return structureBytes() + payload.size() * sizeof(T); }
+
+    TraversalStats Traversal(TraversalClass traversal_class, bool is_recursive, void (*visit)(const T&)) const {
+        TraversalStats stats;
+        const BenchClock& clock = BenchClock::instance();
+        size_t maxDepth = 0;
+        uint64_t start = clock.now();
+
+        if (traversal_class == LEVEL) {
+            // 数据本来就按层序存放，层序遍历就是顺序扫描，不需要队列
+            for (const T& v : payload) visit(v);
+        } else if (is_recursive) {
+            recursiveHelper(traversal_class, root(), visit);
+        } else {
+            maxDepth = iterative(traversal_class, visit);
+            stats.max_stack_depth = maxDepth;
+        }
+
+        uint64_t end = clock.now();
+        stats.setTiming(clock.elapsedNs(start, end), payload.size());
+        stats.memory_usage = maxDepth * sizeof(int32_t);
+        return stats;
+    }
+
+    /*
+    * 批量遍历：visit 接收 VisitSpan<T>
+    * 层序直接交出 payload 中每一层的连续区间，不拷贝；下一层的节点数 = 本层的孩子位中 1 的个数
+    * 先序、中序、后序把数据拷成 batchSize 个一批
+    */
+    template<typename BatchVisitor>
+    TraversalStats BatchTraversal(TraversalClass traversal_class, size_t batchSize, BatchVisitor&& visit) const {
+        TraversalStats stats;
+        const BenchClock& clock = BenchClock::instance();
+        uint64_t start = clock.now();
+
+        if (traversal_class == LEVEL) {
+            uint64_t begin = 0;
+            uint64_t end = payload.empty() ? 0 : 1;
+            while (begin < end) {
+                stats.max_queue_length = std::max<size_t>(stats.max_queue_length, end - begin);
+                visit(VisitSpan<T>{payload.data() + begin, static_cast<size_t>(end - begin)});
+                uint64_t children = bits.rank1(2 * end) - bits.rank1(2 * begin);
+                begin = end;
+                end += children;
+            }
+        } else {
+            BatchCollector<T, BatchVisitor> collector(batchSize, visit);
+            auto push = [&collector](const T& value) { collector.push(value); };
+            stats.max_stack_depth = iterative(traversal_class, push);
+            collector.flush();
+            stats.memory_usage = collector.memoryBytes() + stats.max_stack_depth * 2 * sizeof(int32_t);
+        }
+
+        uint64_t end = clock.now();
+        stats.setTiming(clock.elapsedNs(start, end), payload.size());
+        return stats;
+    }
+
+private:
+    RankSelectBits bits;
+    std::vector<T> payload;
+
+    // 一次 rank 同时得到左右孩子
+    void children(int32_t v, int32_t& left, int32_t& right) const {
+        uint64_t pos = 2 * uint64_t(v);
+        bool l = bits.get(pos);
+        bool r = bits.get(pos + 1);
+        if (!l && !r) {
+            left = right = -1;
+            return;
+        }
+        int32_t first = static_cast<int32_t>(bits.rank1(pos) + 1);
+        left = l ? first : -1;
+        right = r ? first + (l ? 1 : 0) : -1;
+    }
+
+    template<typename Visitor>
+    void recursiveHelper(TraversalClass order, int32_t v, Visitor& visit) const {
+        if (v < 0) return;
+        int32_t left, right;
+        children(v, left, right);
+        if (order == PRE) visit(payload[v]);
+        recursiveHelper(order, left, visit);
+        if (order == IN) visit(payload[v]);
+        recursiveHelper(order, right, visit);
+        if (order == POST) visit(payload[v]);
+    }
+
+    // 栈中保存节点编号和已算出的右孩子，出栈时不必再做 rank
+    template<typename Visitor>
+    size_t iterative(TraversalClass order, Visitor& visit) const {
+        struct Frame {
+            int32_t node;
+            int32_t right;
+        };
+        std::vector<Frame> stack;
+        int32_t current = root();
+        int32_t lastVisited = -1;
+        size_t maxDepth = 0;
+
+        while (current >= 0 || !stack.empty()) {
+            while (current >= 0) {
+                if (order == PRE) visit(payload[current]);
+                int32_t left, right;
+                children(current, left, right);
+                stack.push_back({current, right});
+                current = left;
+            }
+            maxDepth = std::max(maxDepth, stack.size());
+
+            Frame top = stack.back();
+            if (order == POST) {
+                if (top.right >= 0 && lastVisited != top.right) {
+                    current = top.right;
+                } else {
+                    visit(payload[top.node]);
+                    lastVisited = top.node;
+                    stack.pop_back();
+                }
+            } else {
+                stack.pop_back();
+                if (order == IN) visit(payload[top.node]);
+                current = top.right;
+            }
+        }
+        return maxDepth;
+    }
+};
+
+#endif // SUCCINCT_H
@@ -0,0 +1,229 @@
+#ifndef THREADEDTREE_H
+#define THREADEDTREE_H
+
+#include <cstdint>
+#include <vector>
+#include <queue>
+#include "BinaryTree.cpp"
+
+/*
+* 线索二叉树
+* 空的孩子位置永久保存中序前驱（左）/后继（右）线索，线索标记放在指针最低位，
+* 不增加节点大小。中序、先序遍历只沿指针前进：不用栈、不写树，可多个线程同时只读遍历
+* 最左节点的左线索与最右节点的右线索为空
+*/
+template<typename T>
+struct ThreadedNode {
+    T data;
+    uintptr_t left;     // 最低位为 1 表示线索
+    uintptr_t right;
+
+    explicit ThreadedNode(const T& val) : data(val), left(kThread), right(kThread) {}
+
+    static const uintptr_t kThread = 1;
+
+    bool leftIsThread() const { return left & kThread; }
+    bool rightIsThread() const { return right & kThread; }
+    ThreadedNode* leftPtr() const { return reinterpret_cast<ThreadedNode*>(left & ~kThread); }
+    ThreadedNode* rightPtr() const { return reinterpret_cast<ThreadedNode*>(right & ~kThread); }
+
+    void setLeftChild(ThreadedNode* node) { left = reinterpret_cast<uintptr_t>(node); }
+    void setRightChild(ThreadedNode* node) { right = reinterpret_cast<uintptr_t>(node); }
+    void setLeftThread(ThreadedNode* node) { left = reinterpret_cast<uintptr_t>(node) | kThread; }
+    void setRightThread(ThreadedNode* node) { right = reinterpret_cast<uintptr_t>(node) | kThread; }
+};
+
+template<typename T>
+class ThreadedBinaryTree {
+public:
+    typedef ThreadedNode<T> Node;
+
+    ThreadedBinaryTree() : root(nullptr), count(0) {}
+
+    // 复制普通二叉树的形状并建立线索
+    explicit ThreadedBinaryTree(const BinaryTree<T>& tree) : root(nullptr), count(0) {
+        copyFrom(tree.getRoot());
+    }
+
+    ~ThreadedBinaryTree() {
+        clear();
+    }
+
+    ThreadedBinaryTree(const ThreadedBinaryTree&) = delete;
+    ThreadedBinaryTree& operator=(const ThreadedBinaryTree&) = delete;
+
+    Node* getRoot() const { return root; }
+    size_t size() const { return count; }
+    size_t memoryBytes() const { return count * sizeof(Node); }
+
+    // 空树时插入根节点
+    Node* insertRoot(const T& value) {
+        if (root) return nullptr;
+        root = new Node(value);
+        count = 1;
+        return root;
+    }
+
+    // 把新节点插为 parent 的左孩子；parent 原有左子树挂到新节点的左边
+    Node* insertLeft(Node* parent, const T& value) {
+        Node* node = new Node(value);
+        node->left = parent->left;            // 原左孩子或前驱线索
+        node->setRightThread(parent);         // 新节点的中序后继是 parent
+        parent->setLeftChild(node);
+        if (!node->leftIsThread()) {
+            // 原左子树中最右节点的后继由 parent 改为新节点
+            rightmost(node->leftPtr())->setRightThread(node);
+        }
+        count++;
+        return node;
+    }
+
+    // 把新节点插为 parent 的右孩子；parent 原有右子树挂到新节点的右边
+    Node* insertRight(Node* parent, const T& value) {
+        Node* node = new Node(value);
+        node->right = parent->right;          // 原右孩子或后继线索
+        node->setLeftThread(parent);          // 新节点的中序前驱是 parent
+        parent->setRightChild(node);
+        if (!node->rightIsThread()) {
+            // 原右子树中最左节点的前驱由 parent 改为新节点
+            leftmost(node->rightPtr())->setLeftThread(node);
+        }
+        count++;
+        return node;
+    }
+
+    // 按层次逐个插入，生成与 BinaryTree::autoCreateTree 相同的完全二叉树
+    void autoCreateTree(int n) {
+        clear();
+        if (n <= 0) return;
+        std::queue<Node*> q;
+        q.push(insertRoot(T(0)));
+        int created = 1;
+        while (created < n) {
+            Node* parent = q.front();
+            q.pop();
+            q.push(insertLeft(parent, T(created++)));
+            if (created < n) q.push(insertRight(parent, T(created++)));
+        }
+    }
+
+    // 中序后继：右边是线索直接跳，否则走到右子树的最左节点
+    static const Node* inorderNext(const Node* node) {
+        if (node->rightIsThread()) return node->rightPtr();
+        return leftmost(node->rightPtr());
+    }
+
+    // 先序后继：有左孩子走左孩子；否则沿右线索上溯到第一个有右孩子的祖先
+    static const Node* preorderNext(const Node* node) {
+        if (!node->leftIsThread()) return node->leftPtr();
+        while (node && node->rightIsThread()) node = node->rightPtr();
+        return node ? node->rightPtr() : nullptr;
+    }
+
+    template<typename Visitor>
+    void inorder(Visitor&& visit) const {
+        if (!root) return;
+        for (const Node* node = leftmost(root); node; node = inorderNext(node)) visit(node->data);
+    }
+
+    template<typename Visitor>
+    void preorder(Visitor&& visit) const {
+        for (const Node* node = root; node; node = preorderNext(node)) visit(node->data);
+    }
+
+    // 只支持先序和中序；额外内存为 0（不用栈）
+    TraversalStats Traversal(TraversalClass traversal_class, void (*visit)(const T&)) const {
+        TraversalStats stats;
+        const BenchClock& clock = BenchClock::instance();
+        uint64_t start = clock.now();
+
+        if (traversal_class == IN) {
+            inorder(visit);
+        } else if (traversal_class == PRE) {
+            preorder(visit);
+        }
+
+        uint64_t end = clock.now();
+        bool supported = traversal_class == IN || traversal_class == PRE;
+        stats.setTiming(clock.elapsedNs(start, end), supported ? count : 0);
+        stats.memory_usage = 0;
+        return stats;
+    }
+
+    void clear() {
+        // 先求后继再释放当前节点：后继只会是尚未访问的节点
+        const Node* node = root ? leftmost(root) : nullptr;
+        while (node) {
+            const Node* next = inorderNext(node);
+            delete node;
+            node = next;
+        }
+        root = nullptr;
+        count = 0;
+    }
+
+private:
+    Node* root;
+    size_t count;
+
+    static Node* leftmost(Node* node) {
+        while (!node->leftIsThread()) node = node->leftPtr();
+        return node;
+    }
+
+    static Node* rightmost(Node* node) {
+        while (!node->rightIsThread()) node = node->rightPtr();
+        return node;
+    }
+
+    static const Node* leftmost(const Node* node) {
+        while (!node->leftIsThread()) node = node->leftPtr();
+        return node;
+    }
+
+    // 先按先序复制形状（孩子先留空线索），再按中序一遍把空位补成前驱/后继线索
+    void copyFrom(const TreeNode<T>* source) {
+        clear();
+        if (!source) return;
+
+        root = new Node(source->data);
+        count = 1;
+        std::vector<std::pair<const TreeNode<T>*, Node*>> stack{{source, root}};
+        while (!stack.empty()) {
+            const TreeNode<T>* src = stack.back().first;
+            Node* dst = stack.back().second;
+            stack.pop_back();
+            if (src->right) {
+                Node* child = new Node(src->right->data);
+                dst->setRightChild(child);
+                stack.push_back({src->right, child});
+                count++;
+            }
+            if (src->left) {
+                Node* child = new Node(src->left->data);
+                dst->setLeftChild(child);
+                stack.push_back({src->left, child});
+                count++;
+            }
+        }
+
+        std::vector<Node*> path;
+        Node* current = root;
+        Node* prev = nullptr;
+        while (current || !path.empty()) {
+            while (current) {
+                path.push_back(current);
+                current = current->leftIsThread() ? nullptr : current->leftPtr();
+            }
+            current = path.back();
+            path.pop_back();
+            if (current->leftIsThread()) current->setLeftThread(prev);
+            if (prev && prev->rightIsThread()) prev->setRightThread(current);
+            prev = current;
+            current = current->rightIsThread() ? nullptr : current->rightPtr();
+        }
+        if (prev) prev->setRightThread(nullptr);
+    }
+};
+
+#endif // THREADEDTREE_H
@@ -4,13 +4,19 @@ greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
 CONFIG += c++17
 
+# 共享内存多进程遍历用到 shm_open（旧版 glibc 在 librt 中）
+linux: LIBS += -lrt
+
 # You can make your code fail to compile if it uses deprecated APIs.
 # In order to do so, uncomment the following line.
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
     BinaryTree.cpp \
+    benchcli.cpp \
+    benchstore.cpp \
     chartview.cpp \
+    containerview.cpp \
     graphicsLineItem.cpp \
     graphicsVexItem.cpp \
     graphview.cpp \
@@ -18,15 +24,41 @@ SOURCES += \
     mainwindow.cpp
 
 HEADERS += \
+    benchcli.h \
+    benchclock.h \
+    benchharness.h \
+    benchstore.h \
+    benchsuite.h \
     chartview.h \
+    completeindex.h \
+    concurrenttree.h \
+    containerview.h \
+    csvtreeloader.h \
+    enginecalibration.h \
+    fixedtree.h \
     graphicsLineItem.h \
     graphicsVexItem.h \
     graphview.h \
-    mainwindow.h
+    mainwindow.h \
+    mappedfile.h \
+    pagedtree.h \
+    persistenttree.h \
+    sharedtree.h \
+    succinct.h \
+    threadedtree.h \
+    treeaggregate.h \
+    treefile.h \
+    treereclaimer.h \
+    treestream.h
 
 FORMS += \
     mainwindow.ui
 
+# 写入基准测试结果的 git 版本
+BENCH_GIT_REV = $$system(git -C $$PWD rev-parse --short HEAD)
+isEmpty(BENCH_GIT_REV): BENCH_GIT_REV = unknown
+DEFINES += BENCH_GIT_REV=\\\"$$BENCH_GIT_REV\\\"
+
 # Default rules for deployment.
 qnx: target.path = /tmp/$${TARGET}/bin
 else: unix:!android: target.path = /opt/$${TARGET}/bin
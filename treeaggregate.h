@@ -0,0 +1,341 @@
+#ifndef TREEAGGREGATE_H
+#define TREEAGGREGATE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <climits>
+#include <vector>
+#include <algorithm>
+#include "BinaryTree.cpp"
+#include "treefile.h"
+#include "succinct.h"
+
+// gather 路径按 64 位指针装入寄存器，只在 x86-64 上启用
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define TREEAGG_HAS_X86 1
+#include <immintrin.h>
+#endif
+
+/*
+* 节点数据聚合：和、最小、最大、计数（value > threshold），只针对 int 数据
+* 连续数组（下标视图、简洁编码）直接在数据上做 SIMD 归约；指针树先按批收集节点，再用 gather 取数
+* SSE4.1 / AVX2 内核用 target 属性单独编译，运行时按 CPU 选择，不支持的平台只有标量版本
+*/
+struct ValueAggregate {
+    int64_t sum = 0;
+    int32_t min = INT32_MAX;
+    int32_t max = INT32_MIN;
+    uint64_t countAbove = 0;   // 大于阈值的个数
+    uint64_t count = 0;
+
+    void merge(const ValueAggregate& other) {
+        sum += other.sum;
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+        countAbove += other.countAbove;
+        count += other.count;
+    }
+
+    double mean() const { return count ? double(sum) / count : 0.0; }
+
+    bool operator==(const ValueAggregate& other) const {
+        return sum == other.sum && min == other.min && max == other.max
+               && countAbove == other.countAbove && count == other.count;
+    }
+};
+
+namespace treeagg {
+
+enum Kernel {
+    KERNEL_AUTO,
+    KERNEL_SCALAR,
+    KERNEL_SSE41,
+    KERNEL_AVX2,
+};
+
+inline const char* kernelName(Kernel kernel) {
+    switch (kernel) {
+    case KERNEL_SCALAR: return "标量";
+    case KERNEL_SSE41: return "SSE4.1";
+    case KERNEL_AVX2: return "AVX2";
+    default: return "自动";
+    }
+}
+
+// 当前 CPU 支持的最快内核（只检测一次）
+inline Kernel bestKernel() {
+#ifdef TREEAGG_HAS_X86
+    static const Kernel best = __builtin_cpu_supports("avx2") ? KERNEL_AVX2
+                               : __builtin_cpu_supports("sse4.1") ? KERNEL_SSE41
+                                                                  : KERNEL_SCALAR;
+    return best;
+#else
+    return KERNEL_SCALAR;
+#endif
+}
+
+inline bool kernelSupported(Kernel kernel) {
+    return kernel == KERNEL_AUTO || kernel <= bestKernel();
+}
+
+// 请求的内核本机不支持时退到最快的可用内核
+inline Kernel resolve(Kernel kernel) {
+    return kernelSupported(kernel) && kernel != KERNEL_AUTO ? kernel : bestKernel();
+}
+
+inline void scalarValues(const int32_t* values, size_t n, int32_t threshold, ValueAggregate& r) {
+    for (size_t i = 0; i < n; i++) {
+        int32_t v = values[i];
+        r.sum += v;
+        r.min = std::min(r.min, v);
+        r.max = std::max(r.max, v);
+        r.countAbove += v > threshold;
+    }
+    r.count += n;
+}
+
+template<typename LinkPolicy>
+inline void scalarNodes(const TreeNode<int, LinkPolicy>* const* nodes, size_t n, int32_t threshold,
+                        ValueAggregate& r) {
+    for (size_t i = 0; i < n; i++) {
+        int32_t v = nodes[i]->data;
+        r.sum += v;
+        r.min = std::min(r.min, v);
+        r.max = std::max(r.max, v);
+        r.countAbove += v > threshold;
+    }
+    r.count += n;
+}
+
+#ifdef TREEAGG_HAS_X86
+
+__attribute__((target("sse4.1")))
+inline void sse41Values(const int32_t* values, size_t n, int32_t threshold, ValueAggregate& r) {
+    __m128i sum = _mm_setzero_si128();
+    __m128i minv = _mm_set1_epi32(INT32_MAX);
+    __m128i maxv = _mm_set1_epi32(INT32_MIN);
+    __m128i limit = _mm_set1_epi32(threshold);
+    uint64_t above = 0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+        // 和按 64 位累加，避免溢出
+        sum = _mm_add_epi64(sum, _mm_cvtepi32_epi64(x));
+        sum = _mm_add_epi64(sum, _mm_cvtepi32_epi64(_mm_srli_si128(x, 8)));
+        minv = _mm_min_epi32(minv, x);
+        maxv = _mm_max_epi32(maxv, x);
+        above += __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(x, limit))));
+    }
+
+    alignas(16) int64_t sums[2];
+    alignas(16) int32_t mins[4];
+    alignas(16) int32_t maxs[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(sums), sum);
+    _mm_store_si128(reinterpret_cast<__m128i*>(mins), minv);
+    _mm_store_si128(reinterpret_cast<__m128i*>(maxs), maxv);
+    r.sum += sums[0] + sums[1];
+    r.min = std::min({r.min, mins[0], mins[1], mins[2], mins[3]});
+    r.max = std::max({r.max, maxs[0], maxs[1], maxs[2], maxs[3]});
+    r.countAbove += above;
+    r.count += i;
+    scalarValues(values + i, n - i, threshold, r);
+}
+
+__attribute__((target("avx2")))
+inline void avx2Values(const int32_t* values, size_t n, int32_t threshold, ValueAggregate& r) {
+    __m256i sum = _mm256_setzero_si256();
+    __m256i minv = _mm256_set1_epi32(INT32_MAX);
+    __m256i maxv = _mm256_set1_epi32(INT32_MIN);
+    __m256i limit = _mm256_set1_epi32(threshold);
+    uint64_t above = 0;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+        sum = _mm256_add_epi64(sum, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(x)));
+        sum = _mm256_add_epi64(sum, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(x, 1)));
+        minv = _mm256_min_epi32(minv, x);
+        maxv = _mm256_max_epi32(maxv, x);
+        above += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(x, limit))));
+    }
+
+    alignas(32) int64_t sums[4];
+    alignas(32) int32_t mins[8];
+    alignas(32) int32_t maxs[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(sums), sum);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(mins), minv);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(maxs), maxv);
+    r.sum += sums[0] + sums[1] + sums[2] + sums[3];
+    r.min = std::min(r.min, *std::min_element(mins, mins + 8));
+    r.max = std::max(r.max, *std::max_element(maxs, maxs + 8));
+    r.countAbove += above;
+    r.count += i;
+    scalarValues(values + i, n - i, threshold, r);
+}
+
+// 指针数组：每次装入 4 个节点指针，加上 data 的偏移后用 64 位下标 gather 取 4 个 int
+template<typename LinkPolicy>
+__attribute__((target("avx2")))
+inline void avx2Nodes(const TreeNode<int, LinkPolicy>* const* nodes, size_t n, int32_t threshold,
+                      ValueAggregate& r) {
+    if (n == 0) return;
+    const char* first = reinterpret_cast<const char*>(nodes[0]);
+    const long long dataOffset = reinterpret_cast<const char*>(&nodes[0]->data) - first;
+    const __m256i offset = _mm256_set1_epi64x(dataOffset);
+
+    __m256i sum = _mm256_setzero_si256();
+    __m256i minv = _mm256_set1_epi32(INT32_MAX);
+    __m256i maxv = _mm256_set1_epi32(INT32_MIN);
+    __m256i limit = _mm256_set1_epi32(threshold);
+    uint64_t above = 0;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i lo = _mm256_add_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(nodes + i)), offset);
+        __m256i hi = _mm256_add_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(nodes + i + 4)), offset);
+        __m128i xlo = _mm256_i64gather_epi32(static_cast<const int*>(nullptr), lo, 1);
+        __m128i xhi = _mm256_i64gather_epi32(static_cast<const int*>(nullptr), hi, 1);
+        __m256i x = _mm256_inserti128_si256(_mm256_castsi128_si256(xlo), xhi, 1);
+        sum = _mm256_add_epi64(sum, _mm256_cvtepi32_epi64(xlo));
+        sum = _mm256_add_epi64(sum, _mm256_cvtepi32_epi64(xhi));
+        minv = _mm256_min_epi32(minv, x);
+        maxv = _mm256_max_epi32(maxv, x);
+        above += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(x, limit))));
+    }
+
+    alignas(32) int64_t sums[4];
+    alignas(32) int32_t mins[8];
+    alignas(32) int32_t maxs[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(sums), sum);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(mins), minv);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(maxs), maxv);
+    r.sum += sums[0] + sums[1] + sums[2] + sums[3];
+    r.min = std::min(r.min, *std::min_element(mins, mins + 8));
+    r.max = std::max(r.max, *std::max_element(maxs, maxs + 8));
+    r.countAbove += above;
+    r.count += i;
+    scalarNodes(nodes + i, n - i, threshold, r);
+}
+
+#endif // TREEAGG_HAS_X86
+
+// 连续 int 数组的聚合，结果并入 r
+inline void accumulate(const int32_t* values, size_t n, int32_t threshold, ValueAggregate& r,
+                       Kernel kernel = KERNEL_AUTO) {
+#ifdef TREEAGG_HAS_X86
+    switch (resolve(kernel)) {
+    case KERNEL_AVX2:
+        avx2Values(values, n, threshold, r);
+        return;
+    case KERNEL_SSE41:
+        sse41Values(values, n, threshold, r);
+        return;
+    default:
+        break;
+    }
+#else
+    (void)kernel;
+#endif
+    scalarValues(values, n, threshold, r);
+}
+
+// 节点指针数组的聚合；没有 gather 指令时逐个取数
+template<typename LinkPolicy>
+inline void accumulate(const TreeNode<int, LinkPolicy>* const* nodes, size_t n, int32_t threshold,
+                       ValueAggregate& r, Kernel kernel = KERNEL_AUTO) {
+#ifdef TREEAGG_HAS_X86
+    if (resolve(kernel) == KERNEL_AVX2) {
+        avx2Nodes(nodes, n, threshold, r);
+        return;
+    }
+#else
+    (void)kernel;
+#endif
+    scalarNodes(nodes, n, threshold, r);
+}
+
+inline ValueAggregate aggregate(const int32_t* values, size_t n, int32_t threshold, Kernel kernel = KERNEL_AUTO) {
+    ValueAggregate r;
+    accumulate(values, n, threshold, r, kernel);
+    return r;
+}
+
+/*——————————————————— 指针树 ———————————————————*/
+
+// 整树：先序按批收集节点指针，每批 gather 一次（直接用 forEach，不做 BatchTraversal 的统计）
+template<typename LinkPolicy>
+ValueAggregate aggregateTree(const BinaryTree<int, LinkPolicy>& tree, int32_t threshold,
+                             Kernel kernel = KERNEL_AUTO, size_t batchSize = kDefaultBatchSize) {
+    typedef typename BinaryTree<int, LinkPolicy>::Node Node;
+    ValueAggregate r;
+    auto reduce = [&](VisitSpan<const Node*> batch) { accumulate(batch.data, batch.size, threshold, r, kernel); };
+    BatchCollector<const Node*, decltype(reduce)> collector(batchSize, reduce);
+    tree.forEach(PRE, [&collector](const Node* node) { collector.push(node); });
+    collector.flush();
+    return r;
+}
+
+// 每层一个结果，下标为层号（根为 0）
+template<typename LinkPolicy>
+std::vector<ValueAggregate> aggregateLevels(const BinaryTree<int, LinkPolicy>& tree, int32_t threshold,
+                                            Kernel kernel = KERNEL_AUTO) {
+    typedef typename BinaryTree<int, LinkPolicy>::Node Node;
+    std::vector<ValueAggregate> levels;
+    std::vector<const Node*> level;
+    std::vector<const Node*> next;
+    if (tree.getRoot()) level.push_back(tree.getRoot());
+    while (!level.empty()) {
+        levels.emplace_back();
+        accumulate(level.data(), level.size(), threshold, levels.back(), kernel);
+        next.clear();
+        for (const Node* node : level) {
+            if (node->left) next.push_back(node->left);
+            if (node->right) next.push_back(node->right);
+        }
+        level.swap(next);
+    }
+    return levels;
+}
+
+/*——————————————————— 连续数组 ———————————————————*/
+
+// 下标视图按先序编号，整树就是整个数据数组
+inline ValueAggregate aggregateTree(const FlatTreeView<int>& view, int32_t threshold, Kernel kernel = KERNEL_AUTO) {
+    return aggregate(view.values(), view.size(), threshold, kernel);
+}
+
+// 先序编号下子树 v 占据连续区间 [v, end)：end 为子树中先序最后一个节点之后
+// 从 v 出发有右孩子走右孩子、否则走左孩子，走到叶子即为最后一个节点，O(h)
+inline ValueAggregate aggregateSubtree(const FlatTreeView<int>& view, int32_t v, int32_t threshold,
+                                       Kernel kernel = KERNEL_AUTO) {
+    if (v < 0 || static_cast<size_t>(v) >= view.size()) return ValueAggregate();
+    int32_t last = v;
+    while (true) {
+        const TreeLink& link = view.link(last);
+        if (link.right >= 0) {
+            last = link.right;
+        } else if (link.left >= 0) {
+            last = link.left;
+        } else {
+            break;
+        }
+    }
+    return aggregate(view.values() + v, static_cast<size_t>(last - v + 1), threshold, kernel);
+}
+
+// 简洁编码的数据按层序存放，每层是一段连续区间
+inline ValueAggregate aggregateTree(const SuccinctTree<int>& tree, int32_t threshold, Kernel kernel = KERNEL_AUTO) {
+    return aggregate(tree.values(), tree.size(), threshold, kernel);
+}
+
+inline std::vector<ValueAggregate> aggregateLevels(const SuccinctTree<int>& tree, int32_t threshold,
+                                                   Kernel kernel = KERNEL_AUTO) {
+    std::vector<ValueAggregate> levels;
+    tree.BatchTraversal(LEVEL, 0, [&](VisitSpan<int> level) {
+        levels.emplace_back();
+        accumulate(level.data, level.size, threshold, levels.back(), kernel);
+    });
+    return levels;
+}
+
+} // namespace treeagg
+
+#endif // TREEAGGREGATE_H
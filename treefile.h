@@ -0,0 +1,420 @@
+#ifndef TREEFILE_H
+#define TREEFILE_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <stack>
+#include <queue>
+#include <algorithm>
+#include <type_traits>
+#include "BinaryTree.cpp"
+#include "mappedfile.h"
+
+
+/*
+* 二叉树二进制文件格式（小端，版本 1）：
+* [TreeFileHeader]             64 字节
+* [TreeLink  x nodeCount]      子节点下标，-1 表示空；节点按先序编号，根为 0
+* [T         x nodeCount]      节点数据，从 8 字节对齐处开始
+* checksum 覆盖 links 与 payload 两段
+*/
+struct TreeLink {
+    int32_t left;
+    int32_t right;
+};
+
+struct TreeFileHeader {
+    char magic[8];           // "BTREEF1\0"
+    uint32_t version;
+    uint32_t payloadSize;    // sizeof(T)
+    uint64_t nodeCount;
+    uint64_t linksOffset;
+    uint64_t payloadOffset;
+    uint64_t checksum;
+    uint8_t reserved[16];
+};
+static_assert(sizeof(TreeFileHeader) == 64, "TreeFileHeader 必须为 64 字节");
+
+namespace treefile {
+
+static const char kMagic[8] = {'B', 'T', 'R', 'E', 'E', 'F', '1', '\0'};
+static const uint32_t kVersion = 1;
+
+// 64 位校验和：4 路并行的乘法混合，每次处理 32 字节
+inline uint64_t checksum64(const void* data, size_t size, uint64_t seed = 0x9E3779B97F4A7C15ull) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    const uint64_t prime1 = 0x9E3779B185EBCA87ull;
+    const uint64_t prime2 = 0xC2B2AE3D27D4EB4Full;
+    uint64_t lanes[4] = {seed + prime1, seed ^ prime2, seed - prime1, seed * prime2};
+
+    auto mix = [&](uint64_t acc, uint64_t word) {
+        acc += word * prime2;
+        acc = (acc << 31) | (acc >> 33);
+        return acc * prime1;
+    };
+
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        uint64_t w[4];
+        std::memcpy(w, p + i, 32);
+        lanes[0] = mix(lanes[0], w[0]);
+        lanes[1] = mix(lanes[1], w[1]);
+        lanes[2] = mix(lanes[2], w[2]);
+        lanes[3] = mix(lanes[3], w[3]);
+    }
+
+    uint64_t h = lanes[0] ^ (lanes[1] << 1) ^ (lanes[2] << 2) ^ (lanes[3] << 3);
+    for (; i < size; i++) {
+        h = mix(h, p[i]);
+    }
+    h ^= size;
+    h ^= h >> 33;
+    h *= prime2;
+    h ^= h >> 29;
+    return h;
+}
+
+inline uint64_t alignUp(uint64_t offset, uint64_t alignment) {
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+// 文件头声明的两段是否都落在长度为 length 的文件里；只做减法和除法比较，损坏的文件头不会让运算回绕
+inline bool layoutFits(const TreeFileHeader& header, size_t payloadSize, size_t payloadAlign, uint64_t length) {
+    const uint64_t n = header.nodeCount;
+    if (n > uint64_t(INT32_MAX) || payloadSize == 0) return false;
+    if (header.linksOffset < sizeof(TreeFileHeader) || header.linksOffset % alignof(TreeLink) != 0) return false;
+    if (header.payloadOffset < header.linksOffset || header.payloadOffset > length
+        || header.payloadOffset % payloadAlign != 0) return false;
+    return n <= (header.payloadOffset - header.linksOffset) / sizeof(TreeLink)
+           && n <= (length - header.payloadOffset) / payloadSize;
+}
+
+/*
+* 链接是否构成以 0 为根的树：先序编号下孩子的编号大于父节点且小于 n，每个节点至多一个父节点
+* 满足时从根出发的遍历每个节点至多访问一次，不会越界也不会成环。O(n) 时间，n 位额外内存
+*/
+inline bool linksValid(const TreeLink* links, size_t n) {
+    std::vector<bool> hasParent(n, false);
+    for (size_t i = 0; i < n; i++) {
+        for (int32_t child : {links[i].left, links[i].right}) {
+            if (child == -1) continue;
+            if (child <= int64_t(i) || size_t(child) >= n || hasParent[child]) return false;
+            hasParent[child] = true;
+        }
+    }
+    return true;
+}
+
+// 把指针树按先序编号展开为 links + payload 两个数组
+template<typename T>
+void flatten(const TreeNode<T>* root, std::vector<TreeLink>& links, std::vector<T>& payload) {
+    links.clear();
+    payload.clear();
+    if (!root) return;
+
+    // 栈中保存待编号的节点以及父节点里需要回填的下标位置
+    std::stack<std::pair<const TreeNode<T>*, int64_t>> stack;
+    stack.push({root, -1});
+    while (!stack.empty()) {
+        const TreeNode<T>* node = stack.top().first;
+        int64_t slot = stack.top().second;   // 编码为 父下标*2 + 是否右孩子
+        stack.pop();
+
+        int32_t index = static_cast<int32_t>(links.size());
+        links.push_back({-1, -1});
+        payload.push_back(node->data);
+        if (slot >= 0) {
+            TreeLink& parent = links[slot / 2];
+            (slot % 2 ? parent.right : parent.left) = index;
+        }
+
+        if (node->right) stack.push({node->right, int64_t(index) * 2 + 1});
+        if (node->left) stack.push({node->left, int64_t(index) * 2});
+    }
+}
+
+// 写出树文件，成功返回 true
+template<typename T>
+bool write(const std::string& filename, const std::vector<TreeLink>& links, const std::vector<T>& payload,
+           std::string* error = nullptr) {
+    static_assert(std::is_trivially_copyable<T>::value, "树文件只支持可平凡复制的节点数据");
+
+    TreeFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.payloadSize = sizeof(T);
+    header.nodeCount = links.size();
+    header.linksOffset = sizeof(TreeFileHeader);
+    header.payloadOffset = alignUp(header.linksOffset + links.size() * sizeof(TreeLink), 8);
+
+    size_t linkBytes = links.size() * sizeof(TreeLink);
+    size_t payloadBytes = payload.size() * sizeof(T);
+    size_t padding = header.payloadOffset - header.linksOffset - linkBytes;
+    uint64_t sum = checksum64(links.data(), linkBytes);
+    header.checksum = checksum64(payload.data(), payloadBytes, sum);
+
+    FILE* file = std::fopen(filename.c_str(), "wb");
+    if (!file) {
+        if (error) *error = "无法创建文件 " + filename;
+        return false;
+    }
+
+    // 整段写入，避免逐节点的小写操作
+    static const char zeros[8] = {0};
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1
+              && (linkBytes == 0 || std::fwrite(links.data(), linkBytes, 1, file) == 1)
+              && (padding == 0 || std::fwrite(zeros, padding, 1, file) == 1)
+              && (payloadBytes == 0 || std::fwrite(payload.data(), payloadBytes, 1, file) == 1);
+    ok = (std::fclose(file) == 0) && ok;
+    if (!ok && error) *error = "写入失败 " + filename;
+    return ok;
+}
+
+} // namespace treefile
+
+// 下标链接树的只读视图：直接在 links / payload 上遍历，不创建任何节点
+template<typename T>
+class FlatTreeView {
+public:
+    FlatTreeView() = default;
+    FlatTreeView(const TreeLink* links, const T* payload, size_t n)
+        : links(links), payload(payload), n(n) {}
+
+    size_t size() const { return n; }
+    const T& value(int32_t index) const { return payload[index]; }
+    const T* values() const { return payload; }     // 按先序编号连续存放
+    const TreeLink& link(int32_t index) const { return links[index]; }
+
+    TraversalStats Traversal(TraversalClass traversal_class, bool is_recursive, void (*visit)(const T&)) const {
+        TraversalStats stats;
+        const BenchClock& clock = BenchClock::instance();
+        size_t maxDepth = 0;
+        uint64_t start = clock.now();
+
+        int32_t root = n ? 0 : -1;
+        if (traversal_class == LEVEL) {
+            maxDepth = levelorder(root, visit);
+            stats.max_queue_length = maxDepth;
+        } else if (is_recursive) {
+            recursiveHelper(traversal_class, root, visit);
+        } else {
+            maxDepth = iterative(traversal_class, root, visit);
+            stats.max_stack_depth = maxDepth;
+        }
+
+        uint64_t end = clock.now();
+        stats.setTiming(clock.elapsedNs(start, end), n);
+        stats.memory_usage = maxDepth * sizeof(int32_t);
+        return stats;
+    }
+
+    /*
+    * 批量遍历：按遍历顺序把节点数据拷成 batchSize 个一批，visit 接收 VisitSpan<T>
+    * 数据在批内连续存放，访问函数的循环可以被向量化；层序按整层交付
+    */
+    template<typename BatchVisitor>
+    TraversalStats BatchTraversal(TraversalClass traversal_class, size_t batchSize, BatchVisitor&& visit) const {
+        TraversalStats stats;
+        const BenchClock& clock = BenchClock::instance();
+        uint64_t start = clock.now();
+
+        if (traversal_class == LEVEL) {
+            std::vector<int32_t> level;
+            std::vector<int32_t> next;
+            std::vector<T> values;
+            if (n) level.push_back(0);
+            while (!level.empty()) {
+                stats.max_queue_length = std::max(stats.max_queue_length, level.size());
+                values.clear();
+                next.clear();
+                for (int32_t index : level) {
+                    values.push_back(payload[index]);
+                    if (links[index].left >= 0) next.push_back(links[index].left);
+                    if (links[index].right >= 0) next.push_back(links[index].right);
+                }
+                visit(VisitSpan<T>{values.data(), values.size()});
+                level.swap(next);
+            }
+            stats.memory_usage = stats.max_queue_length * (2 * sizeof(int32_t) + sizeof(T));
+        } else {
+            BatchCollector<T, BatchVisitor> collector(batchSize, visit);
+            auto push = [&collector](const T& value) { collector.push(value); };
+            stats.max_stack_depth = iterative(traversal_class, n ? 0 : -1, push);
+            collector.flush();
+            stats.memory_usage = collector.memoryBytes() + stats.max_stack_depth * sizeof(int32_t);
+        }
+
+        uint64_t end = clock.now();
+        stats.setTiming(clock.elapsedNs(start, end), n);
+        return stats;
+    }
+
+    // 只遍历以 root 为根的子树（不计时），visit 接收 const T&；返回最大栈深（层序为最长队列）
+    template<typename Visitor>
+    size_t forEachFrom(int32_t root, TraversalClass traversal_class, Visitor&& visit) const {
+        if (traversal_class == LEVEL) return levelorder(root, visit);
+        return iterative(traversal_class, root, visit);
+    }
+
+private:
+    const TreeLink* links = nullptr;
+    const T* payload = nullptr;
+    size_t n = 0;
+
+    template<typename Visitor>
+    void recursiveHelper(TraversalClass order, int32_t index, Visitor& visit) const {
+        if (index < 0) return;
+        if (order == PRE) visit(payload[index]);
+        recursiveHelper(order, links[index].left, visit);
+        if (order == IN) visit(payload[index]);
+        recursiveHelper(order, links[index].right, visit);
+        if (order == POST) visit(payload[index]);
+    }
+
+    // 与 BinaryTree 的非递归版本相同的单栈算法，返回最大栈深
+    template<typename Visitor>
+    size_t iterative(TraversalClass order, int32_t current, Visitor& visit) const {
+        std::vector<int32_t> stack;
+        int32_t lastVisited = -1;
+        size_t maxDepth = 0;
+
+        while (current >= 0 || !stack.empty()) {
+            while (current >= 0) {
+                if (order == PRE) visit(payload[current]);
+                stack.push_back(current);
+                current = links[current].left;
+            }
+            maxDepth = std::max(maxDepth, stack.size());
+
+            int32_t top = stack.back();
+            if (order == POST) {
+                if (links[top].right >= 0 && lastVisited != links[top].right) {
+                    current = links[top].right;
+                } else {
+                    visit(payload[top]);
+                    lastVisited = top;
+                    stack.pop_back();
+                }
+            } else {
+                stack.pop_back();
+                if (order == IN) visit(payload[top]);
+                current = links[top].right;
+            }
+        }
+        return maxDepth;
+    }
+
+    template<typename Visitor>
+    size_t levelorder(int32_t root, Visitor& visit) const {
+        if (root < 0) return 0;
+        std::queue<int32_t> q;
+        q.push(root);
+        size_t maxQueueLength = 0;
+        while (!q.empty()) {
+            maxQueueLength = std::max(maxQueueLength, q.size());
+            int32_t current = q.front();
+            q.pop();
+            visit(payload[current]);
+            if (links[current].left >= 0) q.push(links[current].left);
+            if (links[current].right >= 0) q.push(links[current].right);
+        }
+        return maxQueueLength;
+    }
+};
+
+// 以只读方式映射的树文件；POSIX 上使用 mmap 零拷贝，其它平台整体读入内存
+template<typename T>
+class MappedTreeFile {
+public:
+    MappedTreeFile() = default;
+    ~MappedTreeFile() { close(); }
+
+    MappedTreeFile(const MappedTreeFile&) = delete;
+    MappedTreeFile& operator=(const MappedTreeFile&) = delete;
+
+    // 打开并校验文件头和链接结构（O(n)，只读 links 段）；verifyChecksum 为 true 时还会校验整个文件内容
+    // 校验和只能发现意外损坏，链接检查保证来路不明的文件也不会让遍历越界或成环
+    bool open(const std::string& filename, bool verifyChecksum = true, std::string* error = nullptr) {
+        close();
+        if (!file.open(filename, false, error)) return false;
+        const char* base = file.data();
+        size_t length = file.size();
+
+        const char* reason = nullptr;
+        const TreeFileHeader* header = reinterpret_cast<const TreeFileHeader*>(base);
+        if (length < sizeof(TreeFileHeader) || std::memcmp(header->magic, treefile::kMagic, 8) != 0) {
+            reason = "不是树文件";
+        } else if (header->version != treefile::kVersion) {
+            reason = "不支持的文件版本";
+        } else if (header->payloadSize != sizeof(T)) {
+            reason = "节点数据类型不匹配";
+        } else if (!treefile::layoutFits(*header, sizeof(T), alignof(T), length)) {
+            reason = "文件长度与文件头不符";
+        } else if (!treefile::linksValid(reinterpret_cast<const TreeLink*>(base + header->linksOffset),
+                                         header->nodeCount)) {
+            reason = "节点链接无效";
+        } else if (verifyChecksum) {
+            uint64_t sum = treefile::checksum64(base + header->linksOffset, header->nodeCount * sizeof(TreeLink));
+            sum = treefile::checksum64(base + header->payloadOffset, header->nodeCount * sizeof(T), sum);
+            if (sum != header->checksum) reason = "校验和不匹配";
+        }
+
+        if (reason) {
+            if (error) *error = std::string(reason) + ": " + filename;
+            close();
+            return false;
+        }
+
+        treeView = FlatTreeView<T>(reinterpret_cast<const TreeLink*>(base + header->linksOffset),
+                                   reinterpret_cast<const T*>(base + header->payloadOffset),
+                                   header->nodeCount);
+        return true;
+    }
+
+    void close() {
+        file.close();
+        treeView = FlatTreeView<T>();
+    }
+
+    bool isOpen() const { return file.isOpen(); }
+    size_t fileSize() const { return file.size(); }
+    const FlatTreeView<T>& view() const { return treeView; }
+
+private:
+    MappedFile file;
+    FlatTreeView<T> treeView;
+};
+
+namespace treefile {
+
+// 把 BinaryTree 写成树文件
+template<typename T>
+bool save(const BinaryTree<T>& tree, const std::string& filename, std::string* error = nullptr) {
+    std::vector<TreeLink> links;
+    std::vector<T> payload;
+    flatten(tree.getRoot(), links, payload);
+    return write(filename, links, payload, error);
+}
+
+// 由下标链接视图重建指针树（用于和零拷贝加载对比）
+template<typename T>
+void rebuild(const FlatTreeView<T>& view, BinaryTree<T>& tree) {
+    std::vector<TreeNode<T>*> nodes(view.size());
+    for (size_t i = 0; i < view.size(); i++) {
+        nodes[i] = new TreeNode<T>(view.value(static_cast<int32_t>(i)));
+    }
+    for (size_t i = 0; i < view.size(); i++) {
+        const TreeLink& link = view.link(static_cast<int32_t>(i));
+        if (link.left >= 0) nodes[i]->left = nodes[link.left];
+        if (link.right >= 0) nodes[i]->right = nodes[link.right];
+    }
+    tree.setRoot(nodes.empty() ? nullptr : nodes[0]);
+}
+
+} // namespace treefile
+
+#endif // TREEFILE_H
@@ -0,0 +1,120 @@
+#ifndef TREERECLAIMER_H
+#define TREERECLAIMER_H
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include "benchclock.h"
+
+// 一次释放（回收）整棵树的统计
+struct TreeReclaimStats {
+    double ms = 0.0;          // 释放耗时(毫秒)；后台回收时为回收线程上的耗时
+    size_t nodes = 0;         // 释放的节点数
+    unsigned threads = 1;     // 使用的线程数
+    bool background = false;  // 是否交给了后台回收线程
+};
+
+/*
+* 后台回收线程：树把节点交出来后立即返回，节点在这里逐棵释放
+* 任务返回释放的节点数；累计的时间与节点数可用于报告
+* 进程退出时析构函数会先处理完队列中剩余的任务
+*/
+class TreeReclaimer {
+public:
+    typedef std::function<size_t()> Job;
+
+    static TreeReclaimer& instance() {
+        static TreeReclaimer reclaimer;
+        return reclaimer;
+    }
+
+    void submit(Job job) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            jobs.push_back(std::move(job));
+            pending++;
+        }
+        wake.notify_one();
+    }
+
+    // 等待已提交的任务全部完成（计时前调用，避免后台释放干扰测量）
+    void waitIdle() {
+        std::unique_lock<std::mutex> lock(mutex);
+        idle.wait(lock, [this]() { return pending == 0; });
+    }
+
+    // 累计统计：回收的树数、节点数、总耗时与最近一次
+    TreeReclaimStats total() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return totals;
+    }
+
+    TreeReclaimStats last() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return lastJob;
+    }
+
+    size_t completedJobs() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return completed;
+    }
+
+    ~TreeReclaimer() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        worker.join();
+    }
+
+    TreeReclaimer(const TreeReclaimer&) = delete;
+    TreeReclaimer& operator=(const TreeReclaimer&) = delete;
+
+private:
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable idle;
+    std::deque<Job> jobs;
+    size_t pending = 0;
+    size_t completed = 0;
+    bool stopping = false;
+    TreeReclaimStats totals;
+    TreeReclaimStats lastJob;
+    std::thread worker;
+
+    TreeReclaimer() {
+        totals.background = true;
+        worker = std::thread([this]() { run(); });
+    }
+
+    void run() {
+        const BenchClock& clock = BenchClock::instance();
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            wake.wait(lock, [this]() { return stopping || !jobs.empty(); });
+            if (jobs.empty()) return;    // stopping 且队列已空
+            Job job = std::move(jobs.front());
+            jobs.pop_front();
+            lock.unlock();
+
+            uint64_t start = clock.now();
+            size_t nodes = job();
+            double ms = clock.elapsedNs(start, clock.now()) / 1e6;
+
+            lock.lock();
+            lastJob.ms = ms;
+            lastJob.nodes = nodes;
+            lastJob.background = true;
+            totals.ms += ms;
+            totals.nodes += nodes;
+            completed++;
+            if (--pending == 0) idle.notify_all();
+        }
+    }
+};
+
+#endif // TREERECLAIMER_H
@@ -0,0 +1,564 @@
+#ifndef TREESTREAM_H
+#define TREESTREAM_H
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "BinaryTree.cpp"
+
+/*
+* 遍历序列的流式序列化
+* 写出：遍历产生的节点数据填入当前缓冲块，块满后交给后台线程整块顺序写盘，
+*       遍历继续填另一块，内存占用固定为两块
+* 读入：后台线程预读下一块，带空标记的先序编码一遍重建树，额外内存 O(h)
+*
+* 文件格式（小端，版本 1）：
+* [TreeStreamHeader]  32 字节
+* 序列：T x nodeCount，按 kind 指定的遍历顺序
+* 带空标记的先序：每个位置一个标记字节，1 后跟 T 表示节点，0 表示空
+*/
+
+// 流的内容类型，前四种与 TraversalClass 取值一致
+enum TreeStreamKind {
+    STREAM_PRE = PRE,
+    STREAM_IN = IN,
+    STREAM_POST = POST,
+    STREAM_LEVEL = LEVEL,
+    STREAM_PRE_NULL,     // 带空标记的先序，可重建树
+};
+
+struct TreeStreamHeader {
+    char magic[8];           // "BTSTRM1\0"
+    uint32_t version;
+    uint32_t kind;           // TreeStreamKind
+    uint32_t payloadSize;    // sizeof(T)
+    uint32_t reserved;
+    uint64_t nodeCount;
+};
+static_assert(sizeof(TreeStreamHeader) == 32, "TreeStreamHeader 必须为 32 字节");
+
+// 一次流式读写的统计
+struct StreamStats {
+    uint64_t nodes = 0;
+    uint64_t bytes = 0;
+    size_t blocks = 0;          // 写盘/读盘的块数
+    double totalNs = 0.0;
+    double stallNs = 0.0;       // 遍历等待后台线程的时间
+    size_t maxStackDepth = 0;   // 重建时的最大栈深
+
+    double mbPerSec() const {
+        return totalNs > 0.0 ? bytes / 1048576.0 * 1e9 / totalNs : 0.0;
+    }
+};
+
+namespace treestream {
+
+static const char kMagic[8] = {'B', 'T', 'S', 'T', 'R', 'M', '1', '\0'};
+static const uint32_t kVersion = 1;
+static const size_t kDefaultBlockSize = size_t(4) << 20;
+
+inline double nsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace treestream
+
+// 双缓冲写出：生产者填满一块后交给后台线程写盘，自己继续填另一块
+class StreamWriter {
+public:
+    explicit StreamWriter(size_t blockSize = treestream::kDefaultBlockSize) : blockSize(blockSize) {}
+    ~StreamWriter() { close(); }
+
+    StreamWriter(const StreamWriter&) = delete;
+    StreamWriter& operator=(const StreamWriter&) = delete;
+
+    bool open(const std::string& filename, std::string* error = nullptr) {
+        close();
+        file = std::fopen(filename.c_str(), "wb");
+        if (!file) {
+            if (error) *error = "无法创建文件 " + filename;
+            return false;
+        }
+        std::setvbuf(file, nullptr, _IONBF, 0);    // 已按块写出，不需要 stdio 再缓冲
+        buffers[0].resize(blockSize);
+        buffers[1].resize(blockSize);
+        active = 0;
+        fill = 0;
+        pending = false;
+        stopping = false;
+        failed = false;
+        totalBytes = 0;
+        blockCount = 0;
+        stallTime = 0.0;
+        worker = std::thread(&StreamWriter::writerLoop, this);
+        return true;
+    }
+
+    void write(const void* data, size_t size) {
+        if (fill + size <= blockSize) {
+            std::memcpy(buffers[active].data() + fill, data, size);
+            fill += size;
+            return;
+        }
+        const char* p = static_cast<const char*>(data);
+        while (size > 0) {
+            if (fill == blockSize) handOff();
+            size_t n = std::min(size, blockSize - fill);
+            std::memcpy(buffers[active].data() + fill, p, n);
+            fill += n;
+            p += n;
+            size -= n;
+        }
+    }
+
+    template<typename V>
+    void put(const V& value) {
+        static_assert(std::is_trivially_copyable<V>::value, "只能直接写出可平凡复制的类型");
+        write(&value, sizeof(V));
+    }
+
+    // 写完剩余数据并关闭；header 非空时最后回写到文件开头（用于补填计数）
+    bool close(const void* header = nullptr, size_t headerSize = 0, std::string* error = nullptr) {
+        if (!file) return true;
+        if (fill > 0) handOff();
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        cv.notify_all();
+        worker.join();
+
+        bool ok = !failed;
+        if (ok && header) {
+            ok = std::fseek(file, 0, SEEK_SET) == 0 && std::fwrite(header, headerSize, 1, file) == 1;
+        }
+        ok = std::fclose(file) == 0 && ok;
+        file = nullptr;
+        std::vector<char>().swap(buffers[0]);
+        std::vector<char>().swap(buffers[1]);
+        if (!ok && error) *error = "写盘失败";
+        return ok;
+    }
+
+    uint64_t bytesWritten() const { return totalBytes + fill; }
+    size_t blocksWritten() const { return blockCount; }
+    double stallNs() const { return stallTime; }
+
+private:
+    size_t blockSize;
+    FILE* file = nullptr;
+    std::vector<char> buffers[2];
+    int active = 0;           // 生产者正在填的块
+    size_t fill = 0;
+
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool pending = false;     // 有一块等待后台线程写出
+    int pendingIndex = 0;
+    size_t pendingSize = 0;
+    bool stopping = false;
+    bool failed = false;
+
+    uint64_t totalBytes = 0;
+    size_t blockCount = 0;
+    double stallTime = 0.0;
+
+    // 把当前块交给后台线程；若上一块还没写完则等待
+    void handOff() {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (pending) {
+            auto start = std::chrono::steady_clock::now();
+            cv.wait(lock, [this] { return !pending; });
+            stallTime += treestream::nsSince(start);
+        }
+        pending = true;
+        pendingIndex = active;
+        pendingSize = fill;
+        totalBytes += fill;
+        blockCount++;
+        lock.unlock();
+        cv.notify_all();
+
+        active ^= 1;
+        fill = 0;
+    }
+
+    void writerLoop() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            cv.wait(lock, [this] { return pending || stopping; });
+            if (!pending) break;
+            int index = pendingIndex;
+            size_t size = pendingSize;
+            lock.unlock();
+            bool ok = std::fwrite(buffers[index].data(), size, 1, file) == 1;
+            lock.lock();
+            if (!ok) failed = true;
+            pending = false;
+            cv.notify_all();
+        }
+    }
+};
+
+// 双缓冲读入：后台线程预读下一块，消费者读完当前块后直接切换
+class StreamReader {
+public:
+    explicit StreamReader(size_t blockSize = treestream::kDefaultBlockSize) : blockSize(blockSize) {}
+    ~StreamReader() { close(); }
+
+    StreamReader(const StreamReader&) = delete;
+    StreamReader& operator=(const StreamReader&) = delete;
+
+    bool open(const std::string& filename, std::string* error = nullptr) {
+        close();
+        file = std::fopen(filename.c_str(), "rb");
+        if (!file) {
+            if (error) *error = "无法打开文件 " + filename;
+            return false;
+        }
+        std::setvbuf(file, nullptr, _IONBF, 0);
+        for (int i = 0; i < 2; i++) {
+            buffers[i].resize(blockSize);
+            ready[i] = false;
+            sizes[i] = 0;
+        }
+        current = 0;
+        pos = 0;
+        avail = 0;
+        consumed = false;
+        eof = false;
+        stopping = false;
+        totalBytes = 0;
+        blockCount = 0;
+        stallTime = 0.0;
+        worker = std::thread(&StreamReader::readerLoop, this);
+        return true;
+    }
+
+    // 读满 size 字节；文件提前结束返回 false
+    bool read(void* out, size_t size) {
+        if (pos + size <= avail) {
+            std::memcpy(out, buffers[current].data() + pos, size);
+            pos += size;
+            return true;
+        }
+        char* p = static_cast<char*>(out);
+        while (size > 0) {
+            if (pos == avail && !nextBlock()) return false;
+            size_t n = std::min(size, avail - pos);
+            std::memcpy(p, buffers[current].data() + pos, n);
+            pos += n;
+            p += n;
+            size -= n;
+        }
+        return true;
+    }
+
+    template<typename V>
+    bool get(V& value) {
+        static_assert(std::is_trivially_copyable<V>::value, "只能直接读入可平凡复制的类型");
+        return read(&value, sizeof(V));
+    }
+
+    void close() {
+        if (!file) return;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        cv.notify_all();
+        worker.join();
+        std::fclose(file);
+        file = nullptr;
+        std::vector<char>().swap(buffers[0]);
+        std::vector<char>().swap(buffers[1]);
+    }
+
+    uint64_t bytesRead() const { return totalBytes; }
+    size_t blocksRead() const { return blockCount; }
+    double stallNs() const { return stallTime; }
+
+private:
+    size_t blockSize;
+    FILE* file = nullptr;
+    std::vector<char> buffers[2];
+    bool ready[2] = {false, false};   // 该块已由后台线程读好
+    size_t sizes[2] = {0, 0};
+    int current = 0;                  // 消费者正在读的块
+    size_t pos = 0;
+    size_t avail = 0;
+    bool consumed = false;            // current 块已交给消费者
+    bool eof = false;
+
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool stopping = false;
+
+    uint64_t totalBytes = 0;
+    size_t blockCount = 0;
+    double stallTime = 0.0;
+
+    // 归还当前块并切换到下一块；没有更多数据返回 false
+    bool nextBlock() {
+        if (eof) return false;
+        std::unique_lock<std::mutex> lock(mutex);
+        int next = current;
+        if (consumed) {
+            ready[current] = false;
+            next = current ^ 1;
+            cv.notify_all();
+        }
+        if (!ready[next]) {
+            auto start = std::chrono::steady_clock::now();
+            cv.wait(lock, [this, next] { return ready[next]; });
+            stallTime += treestream::nsSince(start);
+        }
+        current = next;
+        consumed = true;
+        pos = 0;
+        avail = sizes[next];
+        if (avail == 0) {
+            eof = true;    // 后台线程以空块表示文件结束
+            return false;
+        }
+        totalBytes += avail;
+        blockCount++;
+        return true;
+    }
+
+    void readerLoop() {
+        int index = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cv.wait(lock, [this, index] { return !ready[index] || stopping; });
+                if (stopping) return;
+            }
+            size_t n = std::fread(buffers[index].data(), 1, blockSize, file);
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                sizes[index] = n;
+                ready[index] = true;
+            }
+            cv.notify_all();
+            if (n == 0) return;
+            index ^= 1;
+        }
+    }
+};
+
+namespace treestream {
+
+inline TreeStreamHeader makeHeader(TreeStreamKind kind, uint32_t payloadSize, uint64_t nodeCount) {
+    TreeStreamHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.kind = kind;
+    header.payloadSize = payloadSize;
+    header.nodeCount = nodeCount;
+    return header;
+}
+
+// 读入并检查文件头
+inline bool readHeader(StreamReader& reader, TreeStreamHeader& header, uint32_t payloadSize, std::string* error) {
+    const char* reason = nullptr;
+    if (!reader.get(header) || std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+        reason = "不是遍历序列文件";
+    } else if (header.version != kVersion) {
+        reason = "不支持的文件版本";
+    } else if (header.payloadSize != payloadSize) {
+        reason = "节点数据类型不匹配";
+    }
+    if (reason && error) *error = reason;
+    return !reason;
+}
+
+// 按 kind 顺序把节点数据写成序列，不在内存中生成整个序列
+template<typename T>
+bool writeSequence(const BinaryTree<T>& tree, TraversalClass kind, const std::string& filename,
+                   StreamStats* stats = nullptr, std::string* error = nullptr,
+                   size_t blockSize = kDefaultBlockSize) {
+    auto start = std::chrono::steady_clock::now();
+    StreamWriter writer(blockSize);
+    if (!writer.open(filename, error)) return false;
+
+    TreeStreamHeader header = makeHeader(static_cast<TreeStreamKind>(kind), sizeof(T), 0);
+    writer.put(header);
+    uint64_t count = 0;
+    tree.forEach(kind, [&](const TreeNode<T>* node) {
+        writer.put(node->data);
+        count++;
+    });
+
+    header.nodeCount = count;
+    if (!writer.close(&header, sizeof(header), error)) return false;
+    if (stats) {
+        stats->nodes = count;
+        stats->bytes = writer.bytesWritten();
+        stats->blocks = writer.blocksWritten();
+        stats->stallNs = writer.stallNs();
+        stats->totalNs = nsSince(start);
+    }
+    return true;
+}
+
+// 带空标记的先序编码；显式栈只保存待写的右子树，深度 O(h)
+template<typename T>
+bool writePreorderWithNulls(const BinaryTree<T>& tree, const std::string& filename,
+                            StreamStats* stats = nullptr, std::string* error = nullptr,
+                            size_t blockSize = kDefaultBlockSize) {
+    auto start = std::chrono::steady_clock::now();
+    StreamWriter writer(blockSize);
+    if (!writer.open(filename, error)) return false;
+
+    TreeStreamHeader header = makeHeader(STREAM_PRE_NULL, sizeof(T), 0);
+    writer.put(header);
+
+    const uint8_t nullTag = 0;
+    const uint8_t nodeTag = 1;
+    uint64_t count = 0;
+    size_t maxStack = 0;
+    std::vector<const TreeNode<T>*> stack{tree.getRoot()};
+    while (!stack.empty()) {
+        maxStack = std::max(maxStack, stack.size());
+        const TreeNode<T>* node = stack.back();
+        stack.pop_back();
+        if (!node) {
+            writer.put(nullTag);
+            continue;
+        }
+        writer.put(nodeTag);
+        writer.put(node->data);
+        count++;
+        stack.push_back(node->right);
+        stack.push_back(node->left);
+    }
+
+    header.nodeCount = count;
+    if (!writer.close(&header, sizeof(header), error)) return false;
+    if (stats) {
+        stats->nodes = count;
+        stats->bytes = writer.bytesWritten();
+        stats->blocks = writer.blocksWritten();
+        stats->stallNs = writer.stallNs();
+        stats->maxStackDepth = maxStack;
+        stats->totalNs = nsSince(start);
+    }
+    return true;
+}
+
+// 一遍读入带空标记的先序编码并重建树；栈中只保存尚未填充的孩子指针位置
+// 失败时 tree 保持不变
+template<typename T>
+bool readPreorderWithNulls(const std::string& filename, BinaryTree<T>& tree,
+                           StreamStats* stats = nullptr, std::string* error = nullptr,
+                           size_t blockSize = kDefaultBlockSize) {
+    auto start = std::chrono::steady_clock::now();
+    StreamReader reader(blockSize);
+    if (!reader.open(filename, error)) return false;
+
+    TreeStreamHeader header;
+    if (!readHeader(reader, header, sizeof(T), error)) return false;
+    if (header.kind != STREAM_PRE_NULL) {
+        if (error) *error = "文件不是带空标记的先序编码，无法重建树";
+        return false;
+    }
+
+    TreeNode<T>* root = nullptr;
+    uint64_t count = 0;
+    size_t maxStack = 0;
+    const char* reason = nullptr;
+    std::vector<TreeNode<T>**> slots{&root};
+    while (!slots.empty()) {
+        maxStack = std::max(maxStack, slots.size());
+        TreeNode<T>** slot = slots.back();
+        slots.pop_back();
+
+        uint8_t tag;
+        if (!reader.get(tag)) {
+            reason = "文件被截断";
+            break;
+        }
+        if (tag == 0) continue;
+        T value;
+        if (tag != 1 || !reader.get(value)) {
+            reason = tag != 1 ? "无效的标记字节" : "文件被截断";
+            break;
+        }
+        TreeNode<T>* node = new TreeNode<T>(value);
+        *slot = node;
+        count++;
+        slots.push_back(&node->right);
+        slots.push_back(&node->left);
+    }
+    if (!reason && count != header.nodeCount) reason = "节点数与文件头不符";
+
+    if (reason) {
+        BinaryTree<T> partial;    // 由它释放已建好的部分
+        partial.setRoot(root);
+        if (error) *error = reason;
+        return false;
+    }
+
+    tree.setRoot(root);
+    if (stats) {
+        stats->nodes = count;
+        stats->bytes = reader.bytesRead();
+        stats->blocks = reader.blocksRead();
+        stats->stallNs = reader.stallNs();
+        stats->maxStackDepth = maxStack;
+        stats->totalNs = nsSince(start);
+    }
+    return true;
+}
+
+// 流式读出序列文件，逐个把节点数据交给 visit(const T&)
+template<typename T, typename Visitor>
+bool readSequence(const std::string& filename, Visitor&& visit, TreeStreamKind* kind = nullptr,
+                  StreamStats* stats = nullptr, std::string* error = nullptr,
+                  size_t blockSize = kDefaultBlockSize) {
+    auto start = std::chrono::steady_clock::now();
+    StreamReader reader(blockSize);
+    if (!reader.open(filename, error)) return false;
+
+    TreeStreamHeader header;
+    if (!readHeader(reader, header, sizeof(T), error)) return false;
+    if (header.kind == STREAM_PRE_NULL) {
+        if (error) *error = "带空标记的先序编码请用 readPreorderWithNulls 读取";
+        return false;
+    }
+    if (kind) *kind = static_cast<TreeStreamKind>(header.kind);
+
+    T value;
+    for (uint64_t i = 0; i < header.nodeCount; i++) {
+        if (!reader.get(value)) {
+            if (error) *error = "文件被截断";
+            return false;
+        }
+        visit(value);
+    }
+
+    if (stats) {
+        stats->nodes = header.nodeCount;
+        stats->bytes = reader.bytesRead();
+        stats->blocks = reader.blocksRead();
+        stats->stallNs = reader.stallNs();
+        stats->totalNs = nsSince(start);
+    }
+    return true;
+}
+
+} // namespace treestream
+
+#endif // TREESTREAM_H